@@ -20,6 +20,27 @@ concept allocator = movable<T> && equality_comparable<T> &&
         alloc.dealloc(ptr, layout);
     };
 
+// Block returned by alloc_at_least and realloc_at_least, with the size
+// actually usable, which is at least the size that was requested.
+//
+// The block can then be reallocated or deallocated with any size between
+// the requested one and the usable one.
+struct allocation
+{
+    void*   ptr;
+    isize_t size;
+};
+
+// Allocators which can tell how much they really allocated, typically
+// because they round sizes up to size classes.
+template<typename T>
+concept allocator_at_least = allocator<T> &&
+    requires(T& alloc, layout layout, void* ptr)
+    {
+        { alloc.alloc_at_least(layout) } -> same_as<allocation>;
+        { alloc.realloc_at_least(ptr, layout, layout) } -> same_as<allocation>;
+    };
+
 class GlobalHeap
 {
 public:
@@ -31,7 +52,65 @@ public:
 };
 static_assert(allocator<GlobalHeap>);
 
+// General purpose allocator with segregated size classes, suited to
+// the many identically-sized blocks containers allocate.
+//
+// Each thread keeps a cache of free blocks per size class, and exchanges
+// them in batches with a central depot, so most allocations and
+// deallocations don't synchronize at all. Memory backing the size classes
+// is never returned to the system.
+//
+// Large and over-aligned allocations are forwarded to GlobalHeap.
+class PoolAllocator
+{
+public:
+    static void* alloc(const layout&);
+    static void* realloc(void* ptr, const layout& old, const layout& new_layout);
+    static void dealloc(void* ptr, const layout&);
+
+    // Usable size is the size of the class.
+    static allocation alloc_at_least(const layout&);
+    static allocation realloc_at_least(void* ptr, const layout& old, const layout& new_layout);
+
+    constexpr bool operator==(const PoolAllocator&) const { return true; }
+};
+static_assert(allocator_at_least<PoolAllocator>);
+
+// Build with --define=asl_default_allocator=pool to use PoolAllocator
+// in all containers by default.
+#if ASL_DEFAULT_ALLOCATOR_POOL
+using DefaultAllocator = PoolAllocator;
+#else
 using DefaultAllocator = GlobalHeap;
+#endif
+
+// Allocates at least layout.size bytes. Allocators which don't report
+// their usable size return exactly what was requested.
+template<allocator Allocator>
+allocation alloc_at_least(Allocator& a, const layout& layout)
+{
+    if constexpr (allocator_at_least<Allocator>)
+    {
+        return a.alloc_at_least(layout);
+    }
+    else
+    {
+        return { .ptr = a.alloc(layout), .size = layout.size };
+    }
+}
+
+template<allocator Allocator>
+allocation realloc_at_least(Allocator& a, void* ptr, const layout& old, const layout& new_layout)
+{
+    if constexpr (allocator_at_least<Allocator>)
+    {
+        return a.realloc_at_least(ptr, old, new_layout);
+    }
+    else
+    {
+        return { .ptr = a.realloc(ptr, old, new_layout), .size = new_layout.size };
+    }
+}
 
 template<typename T>
 T* alloc_new(allocator auto& a, auto&&... args)
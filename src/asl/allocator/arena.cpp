@@ -0,0 +1,118 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/allocator/arena.hpp"
+
+#include "asl/base/assert.hpp"
+#include "asl/base/memory_ops.hpp"
+
+asl::Arena::Arena(isize_t chunk_size)
+    : m_chunk_size{chunk_size}
+{
+    ASL_ASSERT(chunk_size > kChunkHeaderSize);
+}
+
+asl::Arena::~Arena()
+{
+    destroy();
+}
+
+void asl::Arena::free_chunks(Chunk* chunk)
+{
+    DefaultAllocator allocator{};
+    while (chunk != nullptr)
+    {
+        Chunk* prev = chunk->prev;
+        allocator.dealloc(chunk, layout{ .size = chunk->size, .align = kChunkAlign });
+        chunk = prev;
+    }
+}
+
+void* asl::Arena::alloc_slow(const layout& layout)
+{
+    // Worst case padding to reach the requested alignment.
+    const isize_t padding = max<isize_t>(layout.align - kChunkAlign, 0);
+    const isize_t required = kChunkHeaderSize + padding + layout.size;
+
+    DefaultAllocator allocator{};
+
+    if (required > m_chunk_size && m_current != nullptr)
+    {
+        // Oversized allocations get their own chunk, which is put behind
+        // the current one so we keep carving from it afterwards.
+        auto* chunk = static_cast<Chunk*>(allocator.alloc({ .size = required, .align = kChunkAlign }));
+        chunk->size = required;
+        chunk->prev = m_current->prev;
+        m_current->prev = chunk;
+
+        // The block is not at the cursor, so it can't be grown in place.
+        m_last_alloc = nullptr;
+
+        // NOLINTNEXTLINE(*-pointer-arithmetic,*-reinterpret-cast)
+        return align_up(reinterpret_cast<uint8_t*>(chunk) + kChunkHeaderSize, layout.align);
+    }
+
+    const isize_t chunk_size = max(required, m_chunk_size);
+    auto* chunk = static_cast<Chunk*>(allocator.alloc({ .size = chunk_size, .align = kChunkAlign }));
+    chunk->size = chunk_size;
+    chunk->prev = m_current;
+
+    // NOLINTBEGIN(*-pointer-arithmetic,*-reinterpret-cast)
+    m_current = chunk;
+    m_cursor = reinterpret_cast<uint8_t*>(chunk) + kChunkHeaderSize;
+    m_end = reinterpret_cast<uint8_t*>(chunk) + chunk_size;
+    // NOLINTEND(*-pointer-arithmetic,*-reinterpret-cast)
+
+    uint8_t* ptr = align_up(m_cursor, layout.align);
+    ASL_ASSERT(layout.size <= m_end - ptr);
+
+    m_cursor = ptr + layout.size; // NOLINT(*-pointer-arithmetic)
+    m_last_alloc = ptr;
+    return ptr;
+}
+
+void* asl::Arena::realloc(void* ptr, const layout& old, const layout& new_layout)
+{
+    ASL_ASSERT(is_pow2(new_layout.align) && new_layout.size >= 0);
+
+    if (is_aligned(ptr, new_layout.align))
+    {
+        if (ptr == m_last_alloc)
+        {
+            auto* end = static_cast<uint8_t*>(ptr) + new_layout.size; // NOLINT(*-pointer-arithmetic)
+            if (end <= m_end)
+            {
+                m_cursor = end;
+                return ptr;
+            }
+        }
+        else if (new_layout.size <= old.size)
+        {
+            return ptr;
+        }
+    }
+
+    void* new_ptr = alloc(new_layout);
+    asl::memcpy(new_ptr, ptr, min(old.size, new_layout.size));
+    return new_ptr;
+}
+
+void asl::Arena::reset()
+{
+    if (m_current == nullptr) { return; }
+
+    free_chunks(std::exchange(m_current->prev, nullptr));
+
+    // NOLINTNEXTLINE(*-pointer-arithmetic,*-reinterpret-cast)
+    m_cursor = reinterpret_cast<uint8_t*>(m_current) + kChunkHeaderSize;
+    m_last_alloc = nullptr;
+}
+
+void asl::Arena::destroy()
+{
+    free_chunks(std::exchange(m_current, nullptr));
+    m_cursor = nullptr;
+    m_end = nullptr;
+    m_last_alloc = nullptr;
+}
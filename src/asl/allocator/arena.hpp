@@ -0,0 +1,124 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "asl/base/support.hpp"
+#include "asl/base/assert.hpp"
+#include "asl/base/layout.hpp"
+#include "asl/base/integers.hpp"
+#include "asl/base/numeric.hpp"
+#include "asl/allocator/allocator.hpp"
+
+namespace asl
+{
+
+// Linear allocator carving allocations from large chunks.
+//
+// Deallocating is a no-op, everything is released at once with reset().
+// The most recent allocation can be grown or shrunk in place.
+//
+// The arena itself is pinned; containers use it through ArenaAllocator.
+class Arena
+{
+    struct Chunk
+    {
+        Chunk*  prev;
+        isize_t size; // Including this header
+    };
+
+    static constexpr isize_t kChunkAlign = 64;
+    static constexpr isize_t kChunkHeaderSize = round_up_pow2(static_cast<isize_t>(sizeof(Chunk)), kChunkAlign);
+
+    Chunk*   m_current{};
+    uint8_t* m_cursor{};
+    uint8_t* m_end{};
+    void*    m_last_alloc{};
+    isize_t  m_chunk_size;
+
+    static uint8_t* align_up(uint8_t* ptr, isize_t align)
+    {
+        // NOLINTNEXTLINE(*-reinterpret-cast)
+        const auto addr = reinterpret_cast<uintptr_t>(ptr);
+        const auto aligned = round_up_pow2<uintptr_t>(addr, static_cast<uintptr_t>(align));
+        return ptr + (aligned - addr); // NOLINT(*-pointer-arithmetic)
+    }
+
+    static bool is_aligned(const void* ptr, isize_t align)
+    {
+        // NOLINTNEXTLINE(*-reinterpret-cast)
+        return (reinterpret_cast<uintptr_t>(ptr) & static_cast<uintptr_t>(align - 1)) == 0;
+    }
+
+    void* alloc_slow(const layout&);
+    static void free_chunks(Chunk* chunk);
+
+public:
+    static constexpr isize_t kDefaultChunkSize = 64 * 1024;
+
+    explicit Arena(isize_t chunk_size = kDefaultChunkSize);
+
+    ASL_DELETE_COPY_MOVE(Arena);
+
+    ~Arena();
+
+    [[nodiscard]]
+    void* alloc(const layout& layout)
+    {
+        ASL_ASSERT(is_pow2(layout.align) && layout.size >= 0);
+
+        uint8_t* ptr = align_up(m_cursor, layout.align);
+        if (m_cursor != nullptr && layout.size <= m_end - ptr)
+        {
+            m_cursor = ptr + layout.size; // NOLINT(*-pointer-arithmetic)
+            m_last_alloc = ptr;
+            return ptr;
+        }
+
+        return alloc_slow(layout);
+    }
+
+    void* realloc(void* ptr, const layout& old, const layout& new_layout);
+
+    static void dealloc(void*, const layout&) {}
+
+    // Releases all allocations at once. The current chunk is kept
+    // for the next allocations, all others are freed.
+    void reset();
+
+    // Releases all allocations and all chunks.
+    void destroy();
+};
+
+// Allocator allocating from an arena, which must outlive it.
+class ArenaAllocator
+{
+    Arena* m_arena;
+
+public:
+    explicit constexpr ArenaAllocator(Arena& arena) : m_arena{&arena} {}
+
+    [[nodiscard]]
+    void* alloc(const layout& layout) const
+    {
+        return m_arena->alloc(layout);
+    }
+
+    void* realloc(void* ptr, const layout& old, const layout& new_layout) const
+    {
+        return m_arena->realloc(ptr, old, new_layout);
+    }
+
+    static void dealloc(void* ptr, const layout& layout)
+    {
+        Arena::dealloc(ptr, layout);
+    }
+
+    [[nodiscard]] constexpr Arena& arena() const { return *m_arena; }
+
+    constexpr bool operator==(const ArenaAllocator&) const = default;
+};
+static_assert(allocator<ArenaAllocator>);
+
+} // namespace asl
@@ -0,0 +1,112 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/allocator/arena.hpp"
+#include "asl/containers/buffer.hpp"
+#include "asl/containers/chunked_buffer.hpp"
+#include "asl/containers/hash_set.hpp"
+#include "asl/strings/string_builder.hpp"
+#include "asl/testing/testing.hpp"
+
+static bool is_aligned(const void* ptr, isize_t align)
+{
+    // NOLINTNEXTLINE(*-reinterpret-cast)
+    return (reinterpret_cast<uintptr_t>(ptr) & static_cast<uintptr_t>(align - 1)) == 0;
+}
+
+ASL_TEST(alloc_alignment)
+{
+    asl::Arena arena;
+
+    void* a = arena.alloc({ .size = 3, .align = 1 });
+    void* b = arena.alloc({ .size = 8, .align = 8 });
+    void* c = arena.alloc({ .size = 1, .align = 256 });
+    void* d = arena.alloc({ .size = 16, .align = 16 });
+
+    ASL_TEST_EXPECT(a != nullptr);
+    ASL_TEST_EXPECT(is_aligned(b, 8));
+    ASL_TEST_EXPECT(is_aligned(c, 256));
+    ASL_TEST_EXPECT(is_aligned(d, 16));
+    ASL_TEST_EXPECT(a != b && b != c && c != d);
+}
+
+ASL_TEST(realloc_in_place)
+{
+    asl::Arena arena;
+
+    auto* a = static_cast<char*>(arena.alloc({ .size = 16, .align = 1 }));
+    asl::memcpy(a, "Hello, world!!!", 16);
+
+    // Most recent allocation grows in place.
+    auto* b = static_cast<char*>(arena.realloc(a, { .size = 16, .align = 1 }, { .size = 64, .align = 1 }));
+    ASL_TEST_EXPECT(a == b);
+
+    auto* c = static_cast<char*>(arena.alloc({ .size = 8, .align = 1 }));
+    ASL_TEST_EXPECT(c != b);
+
+    // Not the most recent one anymore, must move.
+    auto* d = static_cast<char*>(arena.realloc(b, { .size = 64, .align = 1 }, { .size = 128, .align = 1 }));
+    ASL_TEST_EXPECT(d != b);
+    ASL_TEST_EXPECT(asl::memcmp(d, "Hello, world!!!", 16) == 0);
+}
+
+ASL_TEST(oversized)
+{
+    asl::Arena arena{1024};
+
+    void* small1 = arena.alloc({ .size = 16, .align = 8 });
+    void* large = arena.alloc({ .size = 4096, .align = 8 });
+    void* small2 = arena.alloc({ .size = 16, .align = 8 });
+
+    ASL_TEST_EXPECT(large != nullptr);
+
+    // Still carving from the same chunk.
+    ASL_TEST_EXPECT(static_cast<char*>(small2) - static_cast<char*>(small1) == 16);
+}
+
+ASL_TEST(reset)
+{
+    asl::Arena arena;
+
+    void* a = arena.alloc({ .size = 32, .align = 8 });
+    static_cast<void>(arena.alloc({ .size = 128 * 1024, .align = 8 }));
+    arena.reset();
+
+    // The first chunk is kept and carved from the start again.
+    void* b = arena.alloc({ .size = 32, .align = 8 });
+    ASL_TEST_EXPECT(a == b);
+}
+
+ASL_TEST(containers)
+{
+    asl::Arena arena;
+    const asl::ArenaAllocator allocator{arena};
+
+    asl::buffer<int, asl::ArenaAllocator> b{allocator};
+    for (int i = 0; i < 1000; ++i)
+    {
+        b.push(i);
+    }
+    ASL_TEST_EXPECT(b.size() == 1000);
+    ASL_TEST_EXPECT(b[999] == 999);
+
+    asl::hash_set<int, asl::ArenaAllocator> set{allocator};
+    for (int i = 0; i < 1000; ++i)
+    {
+        set.insert(i);
+    }
+    ASL_TEST_EXPECT(set.size() == 1000);
+    ASL_TEST_EXPECT(set.contains(500));
+
+    asl::chunked_buffer<int, 16, asl::ArenaAllocator> chunked{allocator};
+    for (int i = 0; i < 100; ++i)
+    {
+        chunked.push(i);
+    }
+    ASL_TEST_EXPECT(chunked[42] == 42);
+
+    asl::StringBuilder<asl::ArenaAllocator> builder{allocator};
+    builder.push("Hello, ").push("world!");
+    ASL_TEST_EXPECT(builder.as_string_view() == "Hello, world!"_sv);
+}
@@ -0,0 +1,394 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/allocator/allocator.hpp"
+
+#include "asl/base/assert.hpp"
+#include "asl/base/bits.hpp"
+#include "asl/base/integers.hpp"
+#include "asl/base/numeric.hpp"
+#include "asl/synchronization/atomic.hpp"
+#include "asl/synchronization/spin_lock.hpp"
+
+// Size classes are 16 bytes apart up to 128 bytes, then each doubling
+// is split in 4 classes up to 32 KiB, which bounds internal
+// fragmentation to 25%.
+
+static constexpr isize_t kSmallStep = 16;
+static constexpr isize_t kSmallMaxSize = 128;
+static constexpr int kSmallClassCount = 8;
+static constexpr int kClassesPerDoubling = 4;
+static constexpr int kClassCount = kSmallClassCount + 8 * kClassesPerDoubling;
+static constexpr isize_t kMaxSize = 32 * 1024;
+
+// All class sizes are multiple of this, and slabs are aligned on it.
+static constexpr isize_t kBlockAlign = 16;
+
+static constexpr isize_t kBatchBytes = 16 * 1024;
+static constexpr isize_t kSlabBytes = 64 * 1024;
+
+static constexpr int size_class(isize_t size)
+{
+    if (size <= kSmallMaxSize)
+    {
+        return static_cast<int>(asl::max<isize_t>(size - 1, 0) / kSmallStep);
+    }
+
+    const auto s = static_cast<uint64_t>(size - 1);
+    const int doubling = 63 - asl::countl_zero(s);
+    const auto index = static_cast<int>((s - (uint64_t{1} << doubling)) >> (doubling - 2));
+    return kSmallClassCount + (doubling - 7) * kClassesPerDoubling + index;
+}
+
+static constexpr isize_t class_size(int c)
+{
+    if (c < kSmallClassCount)
+    {
+        return (c + 1) * kSmallStep;
+    }
+
+    const int doubling = 7 + (c - kSmallClassCount) / kClassesPerDoubling;
+    const int index = (c - kSmallClassCount) % kClassesPerDoubling;
+    return (isize_t{1} << doubling) + (index + 1) * (isize_t{1} << (doubling - 2));
+}
+
+static_assert(class_size(kSmallClassCount - 1) == kSmallMaxSize);
+static_assert(class_size(kClassCount - 1) == kMaxSize);
+static_assert(size_class(kSmallMaxSize + 1) == kSmallClassCount);
+static_assert(size_class(kMaxSize) == kClassCount - 1);
+static_assert(size_class(class_size(20)) == 20);
+static_assert(size_class(class_size(20) + 1) == 21);
+
+// Number of blocks moved at once between a thread cache and the depot.
+static constexpr isize_t batch_count(int c)
+{
+    return asl::clamp<isize_t>(kBatchBytes / class_size(c), 2, 64);
+}
+
+static constexpr bool is_pooled(const asl::layout& layout)
+{
+    return layout.size <= kMaxSize && layout.align <= kBlockAlign;
+}
+
+namespace
+{
+
+struct FreeBlock
+{
+    FreeBlock* next;
+
+    // Only meaningful on the first block of a batch in the depot.
+    FreeBlock* next_batch;
+};
+
+static_assert(sizeof(FreeBlock) <= kSmallStep);
+
+struct FreeList
+{
+    FreeBlock* head;
+    isize_t    count;
+
+    void push(FreeBlock* block)
+    {
+        block->next = head;
+        head = block;
+        count += 1;
+    }
+
+    FreeBlock* pop()
+    {
+        FreeBlock* block = head;
+        head = block->next;
+        count -= 1;
+        return block;
+    }
+
+    // Detaches the first n blocks, returns the last one of them.
+    FreeBlock* detach_front(isize_t n)
+    {
+        ASL_ASSERT(n > 0 && n <= count);
+
+        FreeBlock* tail = head;
+        for (isize_t i = 1; i < n; ++i)
+        {
+            tail = tail->next;
+        }
+
+        head = tail->next;
+        count -= n;
+        tail->next = nullptr;
+        return tail;
+    }
+};
+
+// Central storage for a size class. Full batches are exchanged in O(1),
+// loose blocks are the leftovers from threads that exited.
+struct alignas(64) Depot
+{
+    asl::SpinLock lock;
+    FreeBlock*    full_batches;
+    FreeBlock*    loose;
+    isize_t       loose_count;
+};
+
+enum class CacheState : uint8_t
+{
+    kUninitialized,
+    kActive,
+    kReleased,
+};
+
+struct ThreadCache
+{
+    FreeList   lists[kClassCount];
+    CacheState state;
+};
+
+// Gives the thread cache back to the depots when the thread exits.
+struct ThreadCacheReleaser
+{
+    ThreadCacheReleaser() = default;
+    ASL_DELETE_COPY_MOVE(ThreadCacheReleaser);
+    ~ThreadCacheReleaser();
+};
+
+}  // namespace
+
+// NOLINTNEXTLINE(*-avoid-non-const-global-variables)
+static Depot g_depots[kClassCount]{};
+
+// NOLINTNEXTLINE(*-avoid-non-const-global-variables)
+static thread_local ThreadCache t_cache{};
+
+// NOLINTNEXTLINE(*-avoid-non-const-global-variables)
+static thread_local ThreadCacheReleaser t_releaser{};
+
+// Allocates a new slab for the class, and cuts it in batches. The first one
+// goes to the list, the others to the depot.
+static void refill_from_slab(int c, FreeList* list)
+{
+    const isize_t size = class_size(c);
+    const isize_t count = batch_count(c);
+    const isize_t batches = asl::max<isize_t>(kSlabBytes / (size * count), 1);
+
+    auto* slab = static_cast<uint8_t*>(asl::GlobalHeap::alloc({
+        .size = size * count * batches,
+        .align = kBlockAlign,
+    }));
+
+    // NOLINTBEGIN(*-pointer-arithmetic,*-reinterpret-cast)
+    auto block_at = [&](isize_t index) {
+        return reinterpret_cast<FreeBlock*>(slab + index * size);
+    };
+
+    for (isize_t b = 0; b < batches; ++b)
+    {
+        const isize_t first = b * count;
+        for (isize_t i = 0; i < count - 1; ++i)
+        {
+            block_at(first + i)->next = block_at(first + i + 1);
+        }
+        block_at(first + count - 1)->next = nullptr;
+        block_at(first)->next_batch = b + 1 < batches ? block_at(first + count) : nullptr;
+    }
+
+    if (batches > 1)
+    {
+        Depot& depot = g_depots[c];
+        depot.lock.lock();
+        block_at((batches - 1) * count)->next_batch = depot.full_batches;
+        depot.full_batches = block_at(count);
+        depot.lock.unlock();
+    }
+    // NOLINTEND(*-pointer-arithmetic,*-reinterpret-cast)
+
+    list->head = block_at(0);
+    list->count = count;
+}
+
+static void refill(int c, FreeList* list)
+{
+    ASL_ASSERT(list->head == nullptr);
+
+    Depot& depot = g_depots[c];
+    depot.lock.lock();
+
+    if (depot.full_batches != nullptr)
+    {
+        FreeBlock* batch = depot.full_batches;
+        depot.full_batches = batch->next_batch;
+        depot.lock.unlock();
+
+        list->head = batch;
+        list->count = batch_count(c);
+        return;
+    }
+
+    if (depot.loose != nullptr)
+    {
+        list->head = std::exchange(depot.loose, nullptr);
+        list->count = std::exchange(depot.loose_count, 0);
+        depot.lock.unlock();
+        return;
+    }
+
+    depot.lock.unlock();
+    refill_from_slab(c, list);
+}
+
+static void flush_batch(int c, FreeList* list)
+{
+    FreeBlock* batch = list->head;
+    list->detach_front(batch_count(c));
+
+    Depot& depot = g_depots[c];
+    depot.lock.lock();
+    batch->next_batch = depot.full_batches;
+    depot.full_batches = batch;
+    depot.lock.unlock();
+}
+
+static void flush_all(int c, FreeList* list)
+{
+    while (list->count >= batch_count(c))
+    {
+        flush_batch(c, list);
+    }
+
+    if (list->count > 0)
+    {
+        const isize_t count = list->count;
+        FreeBlock* head = list->head;
+        FreeBlock* tail = list->detach_front(count);
+
+        Depot& depot = g_depots[c];
+        depot.lock.lock();
+        tail->next = depot.loose;
+        depot.loose = head;
+        depot.loose_count += count;
+        depot.lock.unlock();
+    }
+}
+
+ThreadCacheReleaser::~ThreadCacheReleaser()
+{
+    for (int c = 0; c < kClassCount; ++c)
+    {
+        flush_all(c, &t_cache.lists[c]); // NOLINT(*-constant-array-index)
+    }
+    t_cache.state = CacheState::kReleased;
+}
+
+// Returns false if the thread cache was already released, which happens
+// when allocating from the destructor of a thread_local or a global.
+static bool ensure_thread_cache()
+{
+    if (t_cache.state == CacheState::kActive) [[likely]]
+    {
+        return true;
+    }
+
+    if (t_cache.state == CacheState::kReleased)
+    {
+        return false;
+    }
+
+    // Odr-using the releaser registers its destructor for this thread.
+    static_cast<void>(&t_releaser);
+    t_cache.state = CacheState::kActive;
+    return true;
+}
+
+void* asl::PoolAllocator::alloc(const layout& layout)
+{
+    if (!is_pooled(layout))
+    {
+        return GlobalHeap::alloc(layout);
+    }
+
+    const int c = size_class(layout.size);
+
+    if (!ensure_thread_cache()) [[unlikely]]
+    {
+        FreeList list{};
+        refill(c, &list);
+        FreeBlock* block = list.pop();
+        flush_all(c, &list);
+        return block;
+    }
+
+    FreeList& list = t_cache.lists[c]; // NOLINT(*-constant-array-index)
+    if (list.head == nullptr) [[unlikely]]
+    {
+        refill(c, &list);
+    }
+
+    return list.pop();
+}
+
+void* asl::PoolAllocator::realloc(void* ptr, const layout& old, const layout& new_layout)
+{
+    const bool old_pooled = is_pooled(old);
+    const bool new_pooled = is_pooled(new_layout);
+
+    if (!old_pooled && !new_pooled)
+    {
+        return GlobalHeap::realloc(ptr, old, new_layout);
+    }
+
+    if (old_pooled && new_pooled && size_class(old.size) == size_class(new_layout.size))
+    {
+        return ptr;
+    }
+
+    void* new_ptr = alloc(new_layout);
+    asl::memcpy(new_ptr, ptr, asl::min(old.size, new_layout.size));
+    dealloc(ptr, old);
+    return new_ptr;
+}
+
+static isize_t usable_size(const asl::layout& layout)
+{
+    return is_pooled(layout) ? class_size(size_class(layout.size)) : layout.size;
+}
+
+asl::allocation asl::PoolAllocator::alloc_at_least(const layout& layout)
+{
+    return { .ptr = alloc(layout), .size = usable_size(layout) };
+}
+
+asl::allocation asl::PoolAllocator::realloc_at_least(void* ptr, const layout& old, const layout& new_layout)
+{
+    return { .ptr = realloc(ptr, old, new_layout), .size = usable_size(new_layout) };
+}
+
+void asl::PoolAllocator::dealloc(void* ptr, const layout& layout)
+{
+    if (!is_pooled(layout))
+    {
+        GlobalHeap::dealloc(ptr, layout);
+        return;
+    }
+
+    const int c = size_class(layout.size);
+    auto* block = static_cast<FreeBlock*>(ptr);
+
+    if (!ensure_thread_cache()) [[unlikely]]
+    {
+        FreeList list{};
+        list.push(block);
+        flush_all(c, &list);
+        return;
+    }
+
+    FreeList& list = t_cache.lists[c]; // NOLINT(*-constant-array-index)
+    list.push(block);
+
+    // Keep up to a batch of free blocks after flushing, so alternating
+    // allocations and deallocations don't bounce batches to the depot.
+    if (list.count >= 2 * batch_count(c)) [[unlikely]]
+    {
+        flush_batch(c, &list);
+    }
+}
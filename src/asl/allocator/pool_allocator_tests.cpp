@@ -0,0 +1,234 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/allocator/allocator.hpp"
+#include "asl/base/defer.hpp"
+#include "asl/containers/buffer.hpp"
+#include "asl/containers/hash_set.hpp"
+#include "asl/testing/testing.hpp"
+#include "asl/tests/threads.hpp"
+
+static bool is_aligned(const void* ptr, isize_t align)
+{
+    // NOLINTNEXTLINE(*-reinterpret-cast)
+    return (reinterpret_cast<uintptr_t>(ptr) & static_cast<uintptr_t>(align - 1)) == 0;
+}
+
+ASL_TEST(all_sizes)
+{
+    asl::PoolAllocator allocator;
+
+    for (isize_t size = 1; size <= 40000; size += 37)
+    {
+        const asl::layout layout{ .size = size, .align = 8 };
+        auto* ptr = static_cast<uint8_t*>(allocator.alloc(layout));
+        ASL_TEST_EXPECT(is_aligned(ptr, 8));
+
+        asl::memzero(ptr, size);
+        ASL_TEST_EXPECT(ptr[size - 1] == 0); // NOLINT(*-pointer-arithmetic)
+
+        allocator.dealloc(ptr, layout);
+    }
+}
+
+ASL_TEST(reuse)
+{
+    asl::PoolAllocator allocator;
+
+    // Same size class, the block is reused from the thread cache.
+    void* a = allocator.alloc({ .size = 24, .align = 8 });
+    allocator.dealloc(a, { .size = 24, .align = 8 });
+    void* b = allocator.alloc({ .size = 32, .align = 16 });
+    ASL_TEST_EXPECT(a == b);
+    allocator.dealloc(b, { .size = 32, .align = 16 });
+}
+
+ASL_TEST(realloc)
+{
+    asl::PoolAllocator allocator;
+
+    auto* a = static_cast<char*>(allocator.alloc({ .size = 20, .align = 1 }));
+    asl::memcpy(a, "Hello, world!", 14);
+
+    auto* b = static_cast<char*>(allocator.realloc(a, { .size = 20, .align = 1 }, { .size = 30, .align = 1 }));
+    ASL_TEST_EXPECT(a == b);
+
+    auto* c = static_cast<char*>(allocator.realloc(b, { .size = 30, .align = 1 }, { .size = 200, .align = 1 }));
+    ASL_TEST_EXPECT(asl::memcmp(c, "Hello, world!", 14) == 0);
+
+    auto* d = static_cast<char*>(allocator.realloc(c, { .size = 200, .align = 1 }, { .size = 100000, .align = 1 }));
+    ASL_TEST_EXPECT(asl::memcmp(d, "Hello, world!", 14) == 0);
+
+    allocator.dealloc(d, { .size = 100000, .align = 1 });
+}
+
+ASL_TEST(alloc_at_least)
+{
+    asl::PoolAllocator allocator;
+
+    // 20 bytes are rounded up to the 32 bytes class.
+    const asl::allocation a = allocator.alloc_at_least({ .size = 20, .align = 8 });
+    ASL_TEST_EXPECT(a.size == 32);
+    asl::memzero(a.ptr, a.size);
+
+    // 150 bytes are rounded up to the 160 bytes class.
+    const asl::allocation b = allocator.realloc_at_least(a.ptr, { .size = a.size, .align = 8 }, { .size = 150, .align = 8 });
+    ASL_TEST_EXPECT(b.size == 160);
+
+    allocator.dealloc(b.ptr, { .size = b.size, .align = 8 });
+
+    // The buffer uses all of the class.
+    asl::buffer<int64_t, asl::PoolAllocator> buffer;
+    buffer.reserve_exact(3);
+    ASL_TEST_EXPECT(buffer.capacity() == 4);
+}
+
+ASL_TEST(over_aligned)
+{
+    asl::PoolAllocator allocator;
+
+    void* a = allocator.alloc({ .size = 64, .align = 64 });
+    ASL_TEST_EXPECT(is_aligned(a, 64));
+    allocator.dealloc(a, { .size = 64, .align = 64 });
+}
+
+ASL_TEST(many_blocks)
+{
+    asl::PoolAllocator allocator;
+    static constexpr asl::layout kLayout{ .size = 48, .align = 8 };
+
+    // Enough blocks to go through several slabs and depot batches.
+    asl::buffer<int64_t*> blocks;
+    for (int64_t i = 0; i < 10000; ++i)
+    {
+        auto* ptr = static_cast<int64_t*>(allocator.alloc(kLayout));
+        *ptr = i;
+        blocks.push(ptr);
+    }
+
+    bool ok = true;
+    for (int64_t i = 0; i < 10000; ++i)
+    {
+        ok = ok && *blocks[i] == i;
+    }
+    ASL_TEST_EXPECT(ok);
+
+    for (int64_t* ptr: blocks)
+    {
+        allocator.dealloc(ptr, kLayout);
+    }
+}
+
+ASL_TEST(containers)
+{
+    asl::buffer<int, asl::PoolAllocator> b;
+    for (int i = 0; i < 1000; ++i)
+    {
+        b.push(i);
+    }
+    ASL_TEST_EXPECT(b.size() == 1000);
+    ASL_TEST_EXPECT(b[999] == 999);
+
+    asl::hash_set<int, asl::PoolAllocator> set;
+    for (int i = 0; i < 1000; ++i)
+    {
+        set.insert(i);
+    }
+    ASL_TEST_EXPECT(set.size() == 1000);
+    ASL_TEST_EXPECT(set.contains(500));
+}
+
+static constexpr isize_t kBlocksPerThread = 1000;
+static constexpr asl::layout kThreadLayout{ .size = 48, .align = 8 };
+
+struct Block
+{
+    int64_t thread;
+    int64_t index;
+};
+
+struct PoolState
+{
+    Block*       blocks[kThreadCount][kBlocksPerThread];
+    ThreadErrors errors;
+};
+
+// A block handed out twice would have been overwritten by its other owner.
+static bool blocks_are_intact(PoolState* state)
+{
+    bool ok = true;
+    for (int t = 0; t < kThreadCount; ++t)
+    {
+        for (isize_t i = 0; i < kBlocksPerThread; ++i)
+        {
+            const Block* block = state->blocks[t][i]; // NOLINT(*-constant-array-index)
+            ok = ok && block->thread == t && block->index == i;
+        }
+    }
+    return ok;
+}
+
+// Goes through several batches, so the thread cache exchanges some with
+// the depot.
+static void alloc_blocks(int index, void* user)
+{
+    auto* state = static_cast<PoolState*>(user);
+    asl::PoolAllocator allocator;
+    Block** blocks = state->blocks[index]; // NOLINT(*-constant-array-index)
+
+    // NOLINTBEGIN(*-pointer-arithmetic)
+    for (isize_t i = 0; i < kBlocksPerThread; ++i)
+    {
+        blocks[i] = static_cast<Block*>(allocator.alloc(kThreadLayout));
+        *blocks[i] = Block{ .thread = index, .index = i };
+    }
+
+    for (isize_t i = 0; i < kBlocksPerThread; ++i)
+    {
+        state->errors.expect(blocks[i]->thread == index && blocks[i]->index == i);
+    }
+    // NOLINTEND(*-pointer-arithmetic)
+}
+
+// Frees blocks allocated by another thread. Most go back to the depot in
+// batches, and the rest stay in the cache until the thread exits.
+static void free_other_blocks(int index, void* user)
+{
+    auto* state = static_cast<PoolState*>(user);
+    asl::PoolAllocator allocator;
+    Block** blocks = state->blocks[(index + 1) % kThreadCount]; // NOLINT(*-constant-array-index)
+
+    for (isize_t i = 0; i < kBlocksPerThread; ++i)
+    {
+        allocator.dealloc(blocks[i], kThreadLayout); // NOLINT(*-pointer-arithmetic)
+    }
+}
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(many_threads)
+{
+    auto* state = asl::alloc_new_default<PoolState>();
+    ASL_DEFER [state]() { asl::alloc_delete_default(state); };
+
+    run_threads(alloc_blocks, state);
+    ASL_TEST_EXPECT(state->errors.count() == 0);
+    ASL_TEST_EXPECT(blocks_are_intact(state));
+
+    run_threads(free_other_blocks, state);
+
+    // New threads start with empty caches, and get the blocks back from
+    // the depot, including those released by the threads that exited.
+    run_threads(alloc_blocks, state);
+    ASL_TEST_EXPECT(state->errors.count() == 0);
+    ASL_TEST_EXPECT(blocks_are_intact(state));
+
+    asl::PoolAllocator allocator;
+    for (auto& blocks: state->blocks)
+    {
+        for (Block* block: blocks)
+        {
+            allocator.dealloc(block, kThreadLayout);
+        }
+    }
+}
@@ -14,6 +14,14 @@
     #error Unknown OS
 #endif
 
+#if defined(__x86_64__) || defined(_M_X64)
+    #define ASL_ARCH_X64 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define ASL_ARCH_ARM64 1
+#else
+    #error Unknown architecture
+#endif
+
 #if defined(__clang__) && defined(_MSC_VER)
     #define ASL_COMPILER_CLANG_CL 1
 #elif defined(__clang__)
@@ -110,6 +110,22 @@ constexpr void move_uninit_n(T* to, T* from, isize_t n)
     }
 }
 
+// Moves n objects to uninitialized memory and destroys the originals,
+// with a single memcpy when the type is trivially relocatable.
+template<is_move_constructible T>
+constexpr void relocate_uninit_n(T* to, T* from, isize_t n)
+{
+    if constexpr (is_trivially_relocatable<T>)
+    {
+        memcpy(to, from, static_cast<isize_t>(sizeof(T)) * n);
+    }
+    else
+    {
+        move_uninit_n(to, from, n);
+        destroy_n(from, n);
+    }
+}
+
 template<is_move_assignable T>
 constexpr void move_assign_n(T* to, T* from, isize_t n)
 {
@@ -25,6 +25,8 @@ using false_type = bool_constant<false>;
 
 template<typename T> struct type_identity { using type = T; };
 
+template<typename T> using type_identity_t = typename type_identity<T>::type;
+
 template<typename...>
 using void_t = void;
 
@@ -308,6 +310,15 @@ concept is_trivially_destructible = __is_trivially_destructible(T);
 template<typename T>
 concept is_trivially_copyable = __is_trivially_copyable(T);
 
+// Types whose objects can be moved to another address by copying their
+// bytes, which ends the lifetime of the original without calling its
+// destructor. Types owning a heap allocation usually are, types pointing
+// into themselves aren't. Types opt in by specializing this.
+template<typename T> struct trivially_relocatable : bool_constant<is_trivially_move_constructible<T> && is_trivially_destructible<T>> {};
+
+template<typename T>
+concept is_trivially_relocatable = trivially_relocatable<T>::value;
+
 template<typename T>         struct has_unique_object_representations       : false_type {};
 template<is_integral T>      struct has_unique_object_representations<T>    : true_type {};
 template<is_enum T>          struct has_unique_object_representations<T>    : true_type {};
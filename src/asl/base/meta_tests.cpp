@@ -769,6 +769,23 @@ static_assert(!asl::is_trivially_copyable<HasNonTrivialCopyAssign>);
 static_assert(asl::is_trivially_copyable<HasTrivialCopyAssign>);
 static_assert(!asl::is_trivially_copyable<HasNonTrivialMoveAssign>);
 static_assert(asl::is_trivially_copyable<HasTrivialMoveAssign>);
+
+struct OptInRelocatable
+{
+    OptInRelocatable(OptInRelocatable&&) {}
+    ~OptInRelocatable() {}
+};
+
+template<> struct asl::trivially_relocatable<OptInRelocatable> : true_type {};
+
+static_assert(asl::is_trivially_relocatable<int>);
+static_assert(asl::is_trivially_relocatable<void*>);
+static_assert(asl::is_trivially_relocatable<Trivial>);
+static_assert(asl::is_trivially_relocatable<HasTrivialMoveConstruct>);
+static_assert(!asl::is_trivially_relocatable<NonTrivial>);
+static_assert(!asl::is_trivially_relocatable<HasNonTrivialMoveConstruct>);
+static_assert(!asl::is_trivially_relocatable<HasNonTrivialDestructor>);
+static_assert(asl::is_trivially_relocatable<OptInRelocatable>);
 static_assert(!asl::is_trivially_copyable<Problematic>);
 
 static_assert(!asl::is_scoped_enum<E>);
@@ -0,0 +1,402 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/benchmarking/benchmarking.hpp"
+
+#include "asl/base/assert.hpp"
+#include "asl/base/numeric.hpp"
+#include "asl/containers/buffer.hpp"
+#include "asl/io/print.hpp"
+#include "asl/strings/parse_number.hpp"
+#include "asl/strings/string_view.hpp"
+
+#if defined(ASL_OS_WINDOWS)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#elif defined(ASL_OS_LINUX)
+    #include <time.h>
+#endif
+
+namespace
+{
+
+enum class OutputFormat : uint8_t
+{
+    kText,
+    kCsv,
+    kJson,
+};
+
+struct Options
+{
+    asl::string_view filter;
+    OutputFormat     format = OutputFormat::kText;
+    int64_t          repetitions = 5;
+    int64_t          min_run_ns = 50'000'000;
+    int64_t          warmup_ns = 100'000'000;
+};
+
+struct Result
+{
+    const char* name;
+    int64_t     arg;
+    bool        has_arg;
+    int64_t     iterations;
+    float64_t   min_ns;
+    float64_t   median_ns;
+    float64_t   mean_ns;
+    float64_t   allocs;
+    float64_t   alloc_bytes;
+};
+
+struct Measurement
+{
+    int64_t                             elapsed_ns;
+    asl::benchmarking::allocation_stats allocs;
+};
+
+struct BenchmarkingState
+{
+    asl::benchmarking::Benchmark* head = nullptr;
+    asl::benchmarking::Benchmark* tail = nullptr;
+};
+
+}  // namespace
+
+// NOLINTNEXTLINE(*-avoid-non-const-global-variables)
+static BenchmarkingState g_state{};
+
+// NOLINTNEXTLINE(*-avoid-non-const-global-variables)
+static thread_local asl::benchmarking::allocation_stats t_allocation_stats{};
+
+static int64_t now_ns()
+{
+#if defined(ASL_OS_WINDOWS)
+    static const int64_t s_frequency = [] {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        return static_cast<int64_t>(frequency.QuadPart);
+    }();
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    const auto ticks = static_cast<int64_t>(counter.QuadPart);
+    return ticks / s_frequency * 1'000'000'000 + ticks % s_frequency * 1'000'000'000 / s_frequency;
+#elif defined(ASL_OS_LINUX)
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<int64_t>(ts.tv_nsec);
+#endif
+}
+
+void asl::benchmarking::register_benchmark(Benchmark* benchmark)
+{
+    if (g_state.head == nullptr)
+    {
+        g_state.head = benchmark;
+    }
+    else
+    {
+        g_state.tail->m_next = benchmark;
+    }
+    g_state.tail = benchmark;
+}
+
+asl::benchmarking::allocation_stats& asl::benchmarking::thread_allocation_stats()
+{
+    return t_allocation_stats;
+}
+
+bool asl::benchmarking::State::keep_running_slow()
+{
+    if (!m_started)
+    {
+        m_started = true;
+        m_remaining = m_iterations - 1;
+        resume_timing();
+        return true;
+    }
+
+    ASL_ASSERT(!m_finished);
+    m_finished = true;
+    pause_timing();
+    return false;
+}
+
+void asl::benchmarking::State::pause_timing()
+{
+    ASL_ASSERT(!m_paused);
+    m_paused = true;
+
+    const int64_t end_ns = now_ns();
+    m_elapsed_ns += end_ns - m_start_ns;
+    m_allocs.alloc_count += t_allocation_stats.alloc_count - m_start_allocs.alloc_count;
+    m_allocs.alloc_bytes += t_allocation_stats.alloc_bytes - m_start_allocs.alloc_bytes;
+}
+
+void asl::benchmarking::State::resume_timing()
+{
+    m_paused = false;
+    m_start_allocs = t_allocation_stats;
+    m_start_ns = now_ns();
+}
+
+static Measurement run_once(const asl::benchmarking::Benchmark& benchmark, int64_t arg, int64_t iterations)
+{
+    asl::benchmarking::State state{iterations, arg};
+    benchmark.m_fn(state);
+
+    // A benchmark that never entered its loop would report garbage.
+    ASL_ASSERT(state.iterations() == 0 || state.is_finished());
+
+    return { .elapsed_ns = state.elapsed_ns(), .allocs = state.allocations() };
+}
+
+// Grows the iteration count until a run lasts at least min_run_ns, and
+// keeps running until the warmup time is spent.
+static int64_t calibrate(const asl::benchmarking::Benchmark& benchmark, int64_t arg, const Options& options)
+{
+    static constexpr int64_t kMaxIterations = 1'000'000'000;
+
+    int64_t iterations = 1;
+    int64_t warmup_ns = 0;
+
+    while (true)
+    {
+        const int64_t elapsed_ns = asl::max<int64_t>(run_once(benchmark, arg, iterations).elapsed_ns, 1);
+        warmup_ns += elapsed_ns;
+
+        if (elapsed_ns >= options.min_run_ns || iterations >= kMaxIterations)
+        {
+            if (warmup_ns >= options.warmup_ns) { break; }
+            continue;
+        }
+
+        // Aim a bit over the target so we don't land just below it.
+        const int64_t predicted = iterations * options.min_run_ns / elapsed_ns * 14 / 10;
+        iterations = asl::clamp<int64_t>(predicted, iterations + 1, asl::min(iterations * 100, kMaxIterations));
+    }
+
+    return iterations;
+}
+
+static Result run_benchmark(const asl::benchmarking::Benchmark& benchmark, int64_t arg, bool has_arg, const Options& options)
+{
+    const int64_t iterations = calibrate(benchmark, arg, options);
+
+    asl::buffer<float64_t> samples;
+    Measurement last{};
+    for (int64_t i = 0; i < options.repetitions; ++i)
+    {
+        last = run_once(benchmark, arg, iterations);
+        samples.push(static_cast<float64_t>(last.elapsed_ns) / static_cast<float64_t>(iterations));
+    }
+
+    // Insertion sort, there are only a handful of samples.
+    for (isize_t i = 1; i < samples.size(); ++i)
+    {
+        for (isize_t j = i; j > 0 && samples[j] < samples[j - 1]; --j)
+        {
+            const float64_t tmp = samples[j];
+            samples[j] = samples[j - 1];
+            samples[j - 1] = tmp;
+        }
+    }
+
+    float64_t sum = 0;
+    for (const float64_t s: samples) { sum += s; }
+
+    const isize_t n = samples.size();
+    const float64_t median = n % 2 == 1
+        ? samples[n / 2]
+        : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+
+    return Result{
+        .name = benchmark.m_name,
+        .arg = arg,
+        .has_arg = has_arg,
+        .iterations = iterations,
+        .min_ns = samples[0],
+        .median_ns = median,
+        .mean_ns = sum / static_cast<float64_t>(n),
+        .allocs = static_cast<float64_t>(last.allocs.alloc_count) / static_cast<float64_t>(iterations),
+        .alloc_bytes = static_cast<float64_t>(last.allocs.alloc_bytes) / static_cast<float64_t>(iterations),
+    };
+}
+
+// Keeps two decimals, which is plenty for timings and keeps output readable.
+static float64_t round2(float64_t x)
+{
+    return __builtin_round(x * 100.0) / 100.0;
+}
+
+static bool contains(asl::string_view haystack, asl::string_view needle)
+{
+    for (isize_t i = 0; i + needle.size() <= haystack.size(); ++i)
+    {
+        if (haystack.substr(i, needle.size()) == needle) { return true; }
+    }
+    return false;
+}
+
+static void print_header(const Options& options)
+{
+    switch (options.format)
+    {
+        case OutputFormat::kText:
+            break;
+        case OutputFormat::kCsv:
+            asl::print("name,arg,iterations,repetitions,min_ns,median_ns,mean_ns,allocs_per_iter,bytes_per_iter\n");
+            break;
+        case OutputFormat::kJson:
+            asl::print("{{\n  \"benchmarks\": [");
+            break;
+    }
+}
+
+static void print_result(const Result& r, const Options& options, bool first)
+{
+    switch (options.format)
+    {
+        case OutputFormat::kText:
+            if (r.has_arg)
+            {
+                asl::print("{}/{}: ", r.name, r.arg);
+            }
+            else
+            {
+                asl::print("{}: ", r.name);
+            }
+            asl::print("{} ns/iter (min {}, mean {}), {} iterations, {} allocs/iter, {} bytes/iter\n",
+                round2(r.median_ns), round2(r.min_ns), round2(r.mean_ns),
+                r.iterations, round2(r.allocs), round2(r.alloc_bytes));
+            break;
+
+        case OutputFormat::kCsv:
+            asl::print("{},{},{},{},{},{},{},{},{}\n",
+                r.name, r.arg, r.iterations, options.repetitions,
+                round2(r.min_ns), round2(r.median_ns), round2(r.mean_ns),
+                round2(r.allocs), round2(r.alloc_bytes));
+            break;
+
+        case OutputFormat::kJson:
+            asl::print("{}\n    {{\"name\": \"{}\", \"arg\": {}, \"iterations\": {}, \"repetitions\": {}, ",
+                first ? "" : ",", r.name, r.arg, r.iterations, options.repetitions);
+            asl::print("\"min_ns\": {}, \"median_ns\": {}, \"mean_ns\": {}, \"allocs_per_iter\": {}, \"bytes_per_iter\": {}}}",
+                round2(r.min_ns), round2(r.median_ns), round2(r.mean_ns),
+                round2(r.allocs), round2(r.alloc_bytes));
+            break;
+    }
+}
+
+static void print_footer(const Options& options)
+{
+    if (options.format == OutputFormat::kJson)
+    {
+        asl::print("\n  ]\n}}\n");
+    }
+}
+
+static bool parse_int_option(asl::string_view value, int64_t* out)
+{
+    auto res = asl::parse_int64(value);
+    if (!res.ok() || !res.value().remaining.is_empty() || res.value().value < 0)
+    {
+        return false;
+    }
+    *out = res.value().value;
+    return true;
+}
+
+static bool parse_options(int argc, char* argv[], Options* options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const auto arg = asl::string_view::from_zstr(argv[i]); // NOLINT(*-pointer-arithmetic)
+
+        auto value_of = [&](asl::string_view prefix) -> asl::string_view {
+            return arg.size() >= prefix.size() && arg.first(prefix.size()) == prefix
+                ? arg.substr(prefix.size())
+                : asl::string_view{};
+        };
+
+        if (auto v = value_of("--filter="); !v.is_empty())
+        {
+            options->filter = v;
+        }
+        else if (auto f = value_of("--format="); !f.is_empty())
+        {
+            if (f == "text") { options->format = OutputFormat::kText; }
+            else if (f == "csv") { options->format = OutputFormat::kCsv; }
+            else if (f == "json") { options->format = OutputFormat::kJson; }
+            else { return false; }
+        }
+        else if (auto r = value_of("--repetitions="); !r.is_empty())
+        {
+            if (!parse_int_option(r, &options->repetitions) || options->repetitions == 0) { return false; }
+        }
+        else if (auto t = value_of("--min-time-ms="); !t.is_empty())
+        {
+            if (!parse_int_option(t, &options->min_run_ns)) { return false; }
+            options->min_run_ns *= 1'000'000;
+        }
+        else if (auto w = value_of("--warmup-ms="); !w.is_empty())
+        {
+            if (!parse_int_option(w, &options->warmup_ns)) { return false; }
+            options->warmup_ns *= 1'000'000;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    Options options{};
+    if (!parse_options(argc, argv, &options))
+    {
+        asl::eprint("Usage: {} [--filter=<substring>] [--format=text|csv|json] "
+            "[--repetitions=<n>] [--min-time-ms=<n>] [--warmup-ms=<n>]\n", argv[0]);
+        return 1;
+    }
+
+    print_header(options);
+
+    bool first = true;
+    for (auto* it = g_state.head; it != nullptr; it = it->m_next)
+    {
+        if (!contains(asl::string_view::from_zstr(it->m_name), options.filter))
+        {
+            continue;
+        }
+
+        auto run = [&](int64_t arg, bool has_arg) {
+            asl::eprint("Running {}...\n", it->m_name);
+            const Result result = run_benchmark(*it, arg, has_arg, options);
+            print_result(result, options, first);
+            first = false;
+        };
+
+        if (it->m_args.is_empty())
+        {
+            run(0, false);
+        }
+        else
+        {
+            for (const int64_t arg: it->m_args)
+            {
+                run(arg, true);
+            }
+        }
+    }
+
+    print_footer(options);
+
+    return 0;
+}
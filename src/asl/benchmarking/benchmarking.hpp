@@ -0,0 +1,175 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "asl/base/support.hpp"
+#include "asl/base/integers.hpp"
+#include "asl/base/meta.hpp"
+#include "asl/allocator/allocator.hpp"
+#include "asl/types/span.hpp"
+
+namespace asl::benchmarking
+{
+
+class State;
+struct Benchmark;
+
+void register_benchmark(Benchmark*);
+
+using BenchmarkFunction = void(State&);
+
+struct Benchmark
+{
+    const char*         m_name;
+    BenchmarkFunction*  m_fn;
+    span<const int64_t> m_args;
+    Benchmark*          m_next{};
+
+    constexpr explicit Benchmark(const char* name, BenchmarkFunction* fn, span<const int64_t> args = {})
+        : m_name{name}
+        , m_fn{fn}
+        , m_args{args}
+    {
+        register_benchmark(this);
+    }
+};
+
+struct allocation_stats
+{
+    int64_t alloc_count{};
+    int64_t alloc_bytes{};
+};
+
+// Allocation counters for the current thread, incremented by
+// CountingAllocator. The runner samples them around timed iterations.
+allocation_stats& thread_allocation_stats();
+
+// Allocator forwarding to DefaultAllocator, and counting allocations so
+// they can be reported per iteration. Reallocations count as allocations.
+struct CountingAllocator
+{
+    [[nodiscard]]
+    static void* alloc(const layout& layout)
+    {
+        auto& stats = thread_allocation_stats();
+        stats.alloc_count += 1;
+        stats.alloc_bytes += layout.size;
+        return DefaultAllocator::alloc(layout);
+    }
+
+    static void* realloc(void* ptr, const layout& old, const layout& new_layout)
+    {
+        auto& stats = thread_allocation_stats();
+        stats.alloc_count += 1;
+        stats.alloc_bytes += new_layout.size;
+        return DefaultAllocator::realloc(ptr, old, new_layout);
+    }
+
+    static void dealloc(void* ptr, const layout& layout)
+    {
+        DefaultAllocator::dealloc(ptr, layout);
+    }
+
+    constexpr bool operator==(const CountingAllocator&) const { return true; }
+};
+static_assert(allocator<CountingAllocator>);
+
+// Passed to benchmark functions. Only the iterations of the keep_running
+// loop are measured, setup before it and teardown after it are not:
+//
+//     ASL_BENCHMARK(my_benchmark)
+//     {
+//         setup();
+//         while (state.keep_running())
+//         {
+//             measured();
+//         }
+//     }
+class State
+{
+    int64_t          m_iterations;
+    int64_t          m_arg;
+    int64_t          m_remaining{};
+    bool             m_started{};
+    bool             m_paused{};
+    bool             m_finished{};
+    int64_t          m_start_ns{};
+    int64_t          m_elapsed_ns{};
+    allocation_stats m_start_allocs{};
+    allocation_stats m_allocs{};
+
+    bool keep_running_slow();
+
+public:
+    constexpr State(int64_t iterations, int64_t arg)
+        : m_iterations{iterations}
+        , m_arg{arg}
+    {}
+
+    ASL_DELETE_COPY_MOVE(State);
+    ~State() = default;
+
+    [[nodiscard]]
+    bool keep_running()
+    {
+        if (m_remaining > 0) [[likely]]
+        {
+            m_remaining -= 1;
+            return true;
+        }
+        return keep_running_slow();
+    }
+
+    // Excludes some work inside the loop from the measurement. Pausing
+    // has a cost of its own, so keep it for work much larger than that.
+    void pause_timing();
+    void resume_timing();
+
+    // Argument of the current run, for benchmarks declared with
+    // ASL_BENCHMARK_ARGS. Zero otherwise.
+    [[nodiscard]] constexpr int64_t arg() const { return m_arg; }
+
+    [[nodiscard]] constexpr int64_t iterations() const { return m_iterations; }
+
+    // Whether the keep_running loop ran to completion.
+    [[nodiscard]] constexpr bool is_finished() const { return m_finished; }
+
+    [[nodiscard]] constexpr int64_t elapsed_ns() const { return m_elapsed_ns; }
+    [[nodiscard]] constexpr const allocation_stats& allocations() const { return m_allocs; }
+};
+
+// Prevents the compiler from optimizing away the computation of value.
+template<typename T>
+inline void do_not_optimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Forces pending writes to memory to be considered observable.
+inline void clobber_memory()
+{
+    asm volatile("" : : : "memory");
+}
+
+} // namespace asl::benchmarking
+
+#define ASL_BENCHMARK(NAME)                                         \
+    static void asl_benchmark_fn_##NAME(::asl::benchmarking::State&); /* NOLINT */ \
+    /* NOLINTNEXTLINE */                                            \
+    static ::asl::benchmarking::Benchmark asl_benchmark_##NAME(     \
+        #NAME,                                                      \
+        asl_benchmark_fn_##NAME);                                   \
+    void asl_benchmark_fn_##NAME([[maybe_unused]] ::asl::benchmarking::State& state)
+
+// Runs the benchmark once per argument, which is available from state.arg().
+#define ASL_BENCHMARK_ARGS(NAME, ...)                               \
+    static void asl_benchmark_fn_##NAME(::asl::benchmarking::State&); /* NOLINT */ \
+    static constexpr int64_t asl_benchmark_args_##NAME[] = { __VA_ARGS__ }; /* NOLINT */ \
+    /* NOLINTNEXTLINE */                                            \
+    static ::asl::benchmarking::Benchmark asl_benchmark_##NAME(     \
+        #NAME,                                                      \
+        asl_benchmark_fn_##NAME,                                    \
+        asl_benchmark_args_##NAME);                                 \
+    void asl_benchmark_fn_##NAME([[maybe_unused]] ::asl::benchmarking::State& state)
@@ -10,6 +10,7 @@
 #include "asl/base/memory_ops.hpp"
 #include "asl/base/meta.hpp"
 #include "asl/base/assert.hpp"
+#include "asl/base/numeric.hpp"
 #include "asl/types/span.hpp"
 #include "asl/hashing/hash.hpp"
 #include "asl/allocator/allocator.hpp"
@@ -17,7 +18,61 @@
 namespace asl
 {
 
-template<typename T, allocator Allocator = DefaultAllocator>
+// Growth policies decide the capacity of a buffer which has to grow to
+// hold at least `required` elements of `element_size` bytes.
+template<typename T>
+concept growth_policy = requires(isize_t n)
+{
+    { T::grow(n, n, n) } -> same_as<isize_t>;
+};
+
+// Rounds up to the next power of two.
+struct doubling_growth
+{
+    static constexpr isize_t grow(isize_t, isize_t required, isize_t)
+    {
+        return static_cast<isize_t>(bit_ceil(static_cast<uint64_t>(required)));
+    }
+};
+
+// Grows by half of the current capacity, which wastes less memory than
+// doubling, at the cost of more reallocations.
+struct one_and_half_growth
+{
+    static constexpr isize_t kMinCapacity = 4;
+
+    static constexpr isize_t grow(isize_t capacity, isize_t required, isize_t)
+    {
+        return max(max(required, capacity + capacity / 2), kMinCapacity);
+    }
+};
+
+// Doubles up to kThreshold bytes, then grows by a quarter rounded up to
+// whole pages, so large buffers waste at most 25% of their memory. The
+// reallocations are cheap at those sizes, since the system can usually
+// remap the pages instead of copying them.
+struct paged_growth
+{
+    static constexpr isize_t kPageSize = 4096;
+    static constexpr isize_t kThreshold = isize_t{1} << 20;
+
+    static constexpr isize_t grow(isize_t capacity, isize_t required, isize_t element_size)
+    {
+        if (required * element_size <= kThreshold)
+        {
+            return doubling_growth::grow(capacity, required, element_size);
+        }
+
+        const isize_t bytes = max(required, capacity + capacity / 4) * element_size;
+        return round_up_pow2(bytes, kPageSize) / element_size;
+    }
+};
+
+static_assert(growth_policy<doubling_growth>);
+static_assert(growth_policy<one_and_half_growth>);
+static_assert(growth_policy<paged_growth>);
+
+template<typename T, allocator Allocator = DefaultAllocator, growth_policy Growth = doubling_growth>
 requires is_object<T> && movable<T>
 class buffer
 {
@@ -180,12 +235,11 @@ private:
             // not compatible, well we free and move into our inline
             // storage region.
             // There is an optimization here when the data is trivially
-            // move constructible (which implies trivially destructible),
-            // we copy the whole inline region, which includes the size.
-            // Very magic.
+            // relocatable, we copy the whole inline region, which
+            // includes the size. Very magic.
 
             destroy();
-            if constexpr (is_trivially_move_constructible<T>)
+            if constexpr (is_trivially_relocatable<T>)
             {
                 ASL_ASSERT(!is_on_heap());
                 asl::memcpy(this, &other, kInlineRegionSize);
@@ -248,6 +302,73 @@ private:
         }
     }
 
+    // Moves the elements to a heap allocation of at least new_capacity
+    // elements, which must be able to hold all of them.
+    void reallocate_heap(isize_t new_capacity)
+    {
+        ASL_ASSERT(new_capacity > kInlineCapacity);
+        ASL_ASSERT(new_capacity >= size());
+
+        T* old_data = data();
+        const isize_t old_capacity = capacity();
+        const isize_t current_size = size();
+        const bool currently_on_heap = is_on_heap();
+
+        auto old_layout = layout::array<T>(old_capacity);
+        auto new_layout = layout::array<T>(new_capacity);
+
+        if (currently_on_heap && is_trivially_relocatable<T>)
+        {
+            const allocation a = realloc_at_least(m_allocator, m_data, old_layout, new_layout);
+            m_data = static_cast<T*>(a.ptr);
+            m_capacity = a.size / static_cast<isize_t>(sizeof(T));
+            return;
+        }
+
+        const allocation a = alloc_at_least(m_allocator, new_layout);
+        T* new_data = static_cast<T*>(a.ptr);
+
+        relocate_uninit_n(new_data, old_data, current_size);
+
+        if (currently_on_heap)
+        {
+            m_allocator.dealloc(old_data, old_layout);
+        }
+
+        m_data = new_data;
+        m_capacity = a.size / static_cast<isize_t>(sizeof(T));
+        store_size_encoded(encode_size_heap(current_size));
+    }
+
+    // Moves the elements from the heap back to the inline storage, and
+    // frees the heap allocation.
+    void move_to_inline()
+    {
+        ASL_ASSERT(is_on_heap());
+
+        T* old_data = m_data;
+        const isize_t old_capacity = m_capacity;
+        const isize_t current_size = size();
+        ASL_ASSERT(current_size <= kInlineCapacity);
+
+        if constexpr (kInlineCapacity == 0)
+        {
+            m_data = nullptr;
+            m_capacity = 0;
+            set_size_inline(0);
+        }
+        else
+        {
+            // The inline storage overlaps the heap pointer and capacity,
+            // which were saved above.
+            set_size_inline(0);
+            relocate_uninit_n(data(), old_data, current_size);
+            set_size_inline(current_size);
+        }
+
+        m_allocator.dealloc(old_data, layout::array<T>(old_capacity));
+    }
+
 public:
     constexpr buffer() requires is_default_constructible<Allocator> = default;
 
@@ -351,43 +472,46 @@ public:
         }
     }
 
+    // Grows the capacity to at least new_capacity, following the growth
+    // policy, so that pushing elements one by one is amortized.
     void reserve_capacity(isize_t new_capacity)
     {
         ASL_ASSERT(new_capacity >= 0);
 
-        if (new_capacity <= capacity()) { return; }
-        ASL_ASSERT(new_capacity > kInlineCapacity);
+        const isize_t current_capacity = capacity();
+        if (new_capacity <= current_capacity) { return; }
 
-        new_capacity = static_cast<isize_t>(bit_ceil(static_cast<uint64_t>(new_capacity)));
-
-        T* old_data = data();
-        const isize_t old_capacity = capacity();
-        const isize_t current_size = size();
-        const bool currently_on_heap = is_on_heap();
+        const isize_t grown = Growth::grow(current_capacity, new_capacity, static_cast<isize_t>(sizeof(T)));
+        ASL_ASSERT(grown >= new_capacity);
 
-        auto old_layout = layout::array<T>(old_capacity);
-        auto new_layout = layout::array<T>(new_capacity);
+        reallocate_heap(grown);
+    }
 
-        if (currently_on_heap && is_trivially_move_constructible<T>)
-        {
-            m_data = static_cast<T*>(m_allocator.realloc(m_data, old_layout, new_layout));
-            m_capacity = new_capacity;
-            return;
-        }
+    // Grows the capacity to exactly new_capacity, or a bit more if the
+    // allocator returned a larger block.
+    void reserve_exact(isize_t new_capacity)
+    {
+        ASL_ASSERT(new_capacity >= 0);
 
-        T* new_data = static_cast<T*>(m_allocator.alloc(new_layout));
+        if (new_capacity <= capacity()) { return; }
+        reallocate_heap(new_capacity);
+    }
 
-        move_uninit_n(new_data, old_data, current_size);
-        destroy_n(old_data, current_size);
+    // Reduces the capacity to the size, moving the elements back inline
+    // when they fit.
+    void shrink_to_fit()
+    {
+        if (!is_on_heap()) { return; }
 
-        if (currently_on_heap)
+        const isize_t current_size = size();
+        if (current_size <= kInlineCapacity)
         {
-            m_allocator.dealloc(old_data, old_layout);
+            move_to_inline();
+        }
+        else if (current_size < m_capacity)
+        {
+            reallocate_heap(current_size);
         }
-
-        m_data = new_data;
-        m_capacity = new_capacity;
-        store_size_encoded(encode_size_heap(current_size));
     }
 
     constexpr void resize_uninit(isize_t new_size)
@@ -494,5 +618,10 @@ public:
     }
 };
 
+// Inline elements are copied along with the buffer, heap ones don't move.
+template<typename T, allocator Allocator, growth_policy Growth>
+struct trivially_relocatable<buffer<T, Allocator, Growth>>
+    : bool_constant<is_trivially_relocatable<T> && is_trivially_relocatable<Allocator>> {};
+
 } // namespace asl
 
@@ -0,0 +1,62 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/containers/buffer.hpp"
+#include "asl/benchmarking/benchmarking.hpp"
+
+using asl::benchmarking::CountingAllocator;
+
+// Pushes state.arg() integers into a new buffer, including growth.
+ASL_BENCHMARK_ARGS(buffer_push, 16, 1024, 65536)
+{
+    while (state.keep_running())
+    {
+        asl::buffer<int64_t, CountingAllocator> b;
+        for (int64_t i = 0; i < state.arg(); ++i)
+        {
+            b.push(i);
+        }
+        asl::benchmarking::do_not_optimize(b.data());
+    }
+}
+
+// Same, but with the capacity reserved upfront.
+ASL_BENCHMARK_ARGS(buffer_push_reserved, 16, 1024, 65536)
+{
+    while (state.keep_running())
+    {
+        asl::buffer<int64_t, CountingAllocator> b;
+        b.reserve_capacity(state.arg());
+        for (int64_t i = 0; i < state.arg(); ++i)
+        {
+            b.push(i);
+        }
+        asl::benchmarking::do_not_optimize(b.data());
+    }
+}
+
+struct NonTrivial
+{
+    int64_t value;
+
+    explicit NonTrivial(int64_t v) : value{v} {}
+    ASL_DEFAULT_COPY(NonTrivial);
+    NonTrivial(NonTrivial&& other) : value{other.value} {}
+    NonTrivial& operator=(NonTrivial&& other) { value = other.value; return *this; }
+    ~NonTrivial() = default;
+};
+
+// Growing can't use realloc when elements are not trivially movable.
+ASL_BENCHMARK_ARGS(buffer_push_non_trivial, 16, 1024, 65536)
+{
+    while (state.keep_running())
+    {
+        asl::buffer<NonTrivial, CountingAllocator> b;
+        for (int64_t i = 0; i < state.arg(); ++i)
+        {
+            b.push(i);
+        }
+        asl::benchmarking::do_not_optimize(b.data());
+    }
+}
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include "asl/containers/buffer.hpp"
+#include "asl/strings/string.hpp"
 
 #include "asl/testing/testing.hpp"
 #include "asl/tests/types.hpp"
@@ -83,6 +84,201 @@ ASL_TEST(reserve_capacity)
     ASL_TEST_EXPECT(stats.any_alloc_count() == 2);
 }
 
+ASL_TEST(reserve_exact)
+{
+    CountingAllocator::Stats stats;
+    asl::buffer<int32_t, CountingAllocator> b(CountingAllocator{&stats});
+
+    b.reserve_exact(13);
+    ASL_TEST_EXPECT(b.capacity() == 13);
+    ASL_TEST_EXPECT(stats.any_alloc_count() == 1);
+
+    b.reserve_exact(10);
+    ASL_TEST_EXPECT(b.capacity() == 13);
+    ASL_TEST_EXPECT(stats.any_alloc_count() == 1);
+
+    b.reserve_exact(100);
+    ASL_TEST_EXPECT(b.capacity() == 100);
+    ASL_TEST_EXPECT(stats.any_alloc_count() == 2);
+}
+
+static_assert(asl::doubling_growth::grow(8, 9, 4) == 16);
+static_assert(asl::one_and_half_growth::grow(0, 1, 4) == 4);
+static_assert(asl::one_and_half_growth::grow(16, 17, 4) == 24);
+static_assert(asl::one_and_half_growth::grow(16, 40, 4) == 40);
+static_assert(asl::paged_growth::grow(1000, 1001, 1) == 1024);
+static_assert(asl::paged_growth::grow(4 << 20, (4 << 20) + 1, 1) == 5 << 20);
+static_assert(asl::paged_growth::grow(1'000'000, 1'000'001, 3) == 1'250'645);
+
+ASL_TEST(growth_policy)
+{
+    CountingAllocator::Stats stats;
+    asl::buffer<int64_t, CountingAllocator, asl::one_and_half_growth> b(CountingAllocator{&stats});
+
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        b.push(i);
+    }
+
+    // 4, 6, 9, 13, 19, 28, 42, 63, 94, 141
+    ASL_TEST_EXPECT(b.capacity() == 141);
+    ASL_TEST_EXPECT(stats.any_alloc_count() == 10);
+
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        ASL_TEST_EXPECT(b[i] == i);
+    }
+}
+
+// Rounds all allocations up to 64 bytes, and says so.
+struct RoundingAllocator
+{
+    static constexpr isize_t kGranularity = 64;
+
+    static asl::layout rounded(const asl::layout& layout)
+    {
+        return { .size = asl::round_up_pow2(layout.size, kGranularity), .align = layout.align };
+    }
+
+    static void* alloc(const asl::layout& layout)
+    {
+        return asl::GlobalHeap::alloc(rounded(layout));
+    }
+
+    static void* realloc(void* ptr, const asl::layout& old, const asl::layout& new_layout)
+    {
+        return asl::GlobalHeap::realloc(ptr, rounded(old), rounded(new_layout));
+    }
+
+    static void dealloc(void* ptr, const asl::layout& layout)
+    {
+        asl::GlobalHeap::dealloc(ptr, rounded(layout));
+    }
+
+    static asl::allocation alloc_at_least(const asl::layout& layout)
+    {
+        return { .ptr = alloc(layout), .size = rounded(layout).size };
+    }
+
+    static asl::allocation realloc_at_least(void* ptr, const asl::layout& old, const asl::layout& new_layout)
+    {
+        return { .ptr = realloc(ptr, old, new_layout), .size = rounded(new_layout).size };
+    }
+
+    constexpr bool operator==(const RoundingAllocator&) const { return true; }
+};
+static_assert(asl::allocator_at_least<RoundingAllocator>);
+
+ASL_TEST(allocator_usable_size)
+{
+    asl::buffer<int32_t, RoundingAllocator> b;
+
+    b.reserve_exact(6);
+    ASL_TEST_EXPECT(b.capacity() == 16);
+
+    b.resize(20, 7);
+    ASL_TEST_EXPECT(b.capacity() == 32);
+
+    b.reserve_exact(33);
+    ASL_TEST_EXPECT(b.capacity() == 48);
+    ASL_TEST_EXPECT(b[19] == 7);
+}
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(shrink_to_fit)
+{
+    CountingAllocator::Stats stats;
+    asl::buffer<int32_t, CountingAllocator> b(CountingAllocator{&stats});
+
+    // Stays inline.
+    b.push(1);
+    b.shrink_to_fit();
+    ASL_TEST_EXPECT(b.capacity() == 5);
+    ASL_TEST_EXPECT(stats.any_alloc_count() == 0);
+
+    for (int32_t i = 2; i <= 20; ++i)
+    {
+        b.push(i);
+    }
+    ASL_TEST_EXPECT(b.capacity() == 32);
+
+    b.shrink_to_fit();
+    ASL_TEST_EXPECT(b.capacity() == 20);
+    ASL_TEST_EXPECT(b.size() == 20);
+    ASL_TEST_EXPECT(b[0] == 1);
+    ASL_TEST_EXPECT(b[19] == 20);
+
+    // Back to inline storage.
+    b.resize(3);
+    b.shrink_to_fit();
+    ASL_TEST_EXPECT(b.capacity() == 5);
+    ASL_TEST_EXPECT(static_cast<const void*>(b.data()) == &b);
+    ASL_TEST_EXPECT(stats.alive_bytes == 0);
+    ASL_TEST_EXPECT(b.size() == 3);
+    ASL_TEST_EXPECT(b[0] == 1);
+    ASL_TEST_EXPECT(b[1] == 2);
+    ASL_TEST_EXPECT(b[2] == 3);
+}
+
+ASL_TEST(shrink_to_fit_non_trivial)
+{
+    bool d[3]{};
+
+    {
+        CountingAllocator::Stats stats;
+        asl::buffer<DestructorObserver, CountingAllocator> b(CountingAllocator{&stats});
+        b.push(&d[0]);
+        b.push(&d[1]);
+        b.push(&d[2]);
+        ASL_TEST_EXPECT(b.capacity() == 4);
+
+        b.shrink_to_fit();
+        ASL_TEST_EXPECT(b.capacity() == 3);
+        ASL_TEST_EXPECT(!d[0] && !d[1] && !d[2]);
+        ASL_TEST_EXPECT(b[2].destroyed == &d[2]);
+    }
+
+    ASL_TEST_EXPECT(d[0] && d[1] && d[2]);
+}
+
+ASL_TEST(shrink_to_fit_no_inline)
+{
+    asl::buffer<Big> b;
+    b.push(Big{});
+    b.push(Big{});
+
+    b.clear();
+    b.shrink_to_fit();
+    ASL_TEST_EXPECT(b.capacity() == 0);
+    ASL_TEST_EXPECT(b.data() == nullptr);
+
+    b.push(Big{});
+    ASL_TEST_EXPECT(b.size() == 1);
+}
+
+static_assert(asl::is_trivially_relocatable<asl::buffer<int>>);
+static_assert(asl::is_trivially_relocatable<asl::buffer<asl::string<>>>);
+static_assert(!asl::is_trivially_relocatable<asl::buffer<DestructorObserver>>);
+
+ASL_TEST(relocate)
+{
+    int moves = 0;
+    asl::buffer<RelocatableType> b;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        b.push(i, &moves);
+    }
+    b.shrink_to_fit();
+
+    // Growing and shrinking didn't move any element.
+    ASL_TEST_EXPECT(moves == 0);
+    for (int i = 0; i < 100; ++i)
+    {
+        ASL_TEST_EXPECT(b[i].value == i);
+    }
+}
+
 // NOLINTNEXTLINE(*-complexity)
 ASL_TEST(push)
 {
@@ -15,6 +15,97 @@
 namespace asl
 {
 
+// Free chunks shared by chunked_buffers of the same type and chunk size,
+// which take their chunks from it instead of the allocator, and give them
+// back when they don't need them anymore. At most max_free_chunks are
+// kept, the others are freed.
+//
+// The pool must outlive the buffers using it, and isn't thread-safe.
+template<
+    is_object T,
+    isize_t kChunkSize,
+    allocator Allocator = DefaultAllocator>
+class chunk_pool
+{
+public:
+    using Chunk = array<maybe_uninit<T>, kChunkSize>;
+
+private:
+    buffer<Chunk*, Allocator> m_free_chunks;
+    isize_t                   m_max_free_chunks;
+
+public:
+    explicit constexpr chunk_pool(isize_t max_free_chunks)
+        requires is_default_constructible<Allocator>
+        : m_max_free_chunks{max_free_chunks}
+    {
+        ASL_ASSERT(max_free_chunks >= 0);
+    }
+
+    constexpr chunk_pool(isize_t max_free_chunks, Allocator allocator)
+        : m_free_chunks{std::move(allocator)}
+        , m_max_free_chunks{max_free_chunks}
+    {
+        ASL_ASSERT(max_free_chunks >= 0);
+    }
+
+    ASL_DELETE_COPY_MOVE(chunk_pool);
+
+    ~chunk_pool()
+    {
+        set_max_free_chunks(0);
+        m_free_chunks.destroy();
+    }
+
+    [[nodiscard]] constexpr isize_t free_chunk_count() const { return m_free_chunks.size(); }
+
+    [[nodiscard]] constexpr isize_t max_free_chunks() const { return m_max_free_chunks; }
+
+    // Frees the free chunks past the new maximum.
+    void set_max_free_chunks(isize_t max_free_chunks)
+    {
+        ASL_ASSERT(max_free_chunks >= 0);
+        m_max_free_chunks = max_free_chunks;
+
+        const isize_t count = m_free_chunks.size();
+        for (isize_t i = max_free_chunks; i < count; ++i)
+        {
+            alloc_delete(m_free_chunks.allocator(), m_free_chunks[i]);
+        }
+
+        if (count > max_free_chunks)
+        {
+            m_free_chunks.resize_uninit(max_free_chunks);
+        }
+    }
+
+    Chunk* acquire()
+    {
+        const isize_t count = m_free_chunks.size();
+        if (count == 0)
+        {
+            // @Todo(C++26) _unsafe shouldn't be needed with trivial unions
+            return alloc_uninit_unsafe<Chunk>(m_free_chunks.allocator());
+        }
+
+        Chunk* chunk = m_free_chunks[count - 1];
+        m_free_chunks.resize_uninit(count - 1);
+        return chunk;
+    }
+
+    void release(Chunk* chunk)
+    {
+        if (m_free_chunks.size() < m_max_free_chunks)
+        {
+            m_free_chunks.push(chunk);
+        }
+        else
+        {
+            alloc_delete(m_free_chunks.allocator(), chunk);
+        }
+    }
+};
+
 template<
     is_object T,
     isize_t kChunkSize,
@@ -74,9 +165,39 @@ class chunked_buffer
         };
     }
 
+public:
+    using Pool = chunk_pool<T, kChunkSize, Allocator>;
+
+private:
     buffer<Chunk*, Allocator>    m_chunks;
     isize_t                      m_size{};
 
+    // Where chunks come from and go back to, when not the allocator.
+    Pool*                        m_pool{};
+
+    Chunk* alloc_chunk()
+    {
+        if (m_pool != nullptr)
+        {
+            return m_pool->acquire();
+        }
+
+        // @Todo(C++26) _unsafe shouldn't be needed with trivial unions
+        return alloc_uninit_unsafe<Chunk>(m_chunks.allocator());
+    }
+
+    void free_chunk(Chunk* chunk)
+    {
+        if (m_pool != nullptr)
+        {
+            m_pool->release(chunk);
+        }
+        else
+        {
+            alloc_delete(m_chunks.allocator(), chunk);
+        }
+    }
+
     void resize_uninit_inner(isize_t new_size)
     {
         ASL_ASSERT(new_size >= 0);
@@ -174,9 +295,22 @@ public:
         : m_chunks{std::move(allocator)}
     {}
 
+    // Takes chunks from the pool, which must outlive the buffer.
+    explicit constexpr chunked_buffer(Pool* pool)
+        requires is_default_constructible<Allocator>
+        : m_pool{pool}
+    {}
+
+    constexpr chunked_buffer(Pool* pool, Allocator allocator)
+        : m_chunks{std::move(allocator)}
+        , m_pool{pool}
+    {}
+
+    // The copy uses the same pool, if any.
     constexpr chunked_buffer(const chunked_buffer& other)
         requires copyable<T> && copy_constructible<Allocator>
         : m_chunks{other.m_chunks.allocator_copy()}
+        , m_pool{other.m_pool}
     {
         copy_from(other);
     }
@@ -184,6 +318,7 @@ public:
     constexpr chunked_buffer(chunked_buffer&& other)
         : m_chunks{std::move(other.m_chunks)}
         , m_size{std::exchange(other.m_size, 0)}
+        , m_pool{other.m_pool}
     {
         ASL_ASSERT(other.m_chunks.size() == 0);
     }
@@ -202,6 +337,7 @@ public:
         destroy();
         m_chunks = std::move(other.m_chunks);
         m_size = std::exchange(other.m_size, 0);
+        m_pool = other.m_pool;
         ASL_ASSERT(other.m_chunks.size() == 0);
         return *this;
     }
@@ -211,6 +347,7 @@ public:
         destroy();
     }
 
+    // Destroys the elements, but keeps the chunks for later use.
     void clear()
     {
         if constexpr (is_trivially_destructible<T>)
@@ -231,12 +368,28 @@ public:
 
         for (Chunk* chunk:  m_chunks)
         {
-            alloc_delete(m_chunks.allocator(), chunk);
+            free_chunk(chunk);
         }
 
         m_chunks.destroy();
     }
 
+    // Frees the chunks which no element uses.
+    void shrink_to_fit()
+    {
+        const isize_t used_chunks = chunk_index(m_size + kChunkSize - 1);
+        const isize_t chunk_count = m_chunks.size();
+        if (used_chunks == chunk_count) { return; }
+
+        for (isize_t i = used_chunks; i < chunk_count; ++i)
+        {
+            free_chunk(m_chunks[i]);
+        }
+
+        m_chunks.resize_uninit(used_chunks);
+        m_chunks.shrink_to_fit();
+    }
+
     [[nodiscard]] constexpr isize_t size() const { return m_size; }
 
     [[nodiscard]] constexpr bool is_empty() const { return size() == 0; }
@@ -286,9 +439,7 @@ public:
         m_chunks.reserve_capacity(required_chunks);
         for (isize_t i = 0; i < additional_chunks; ++i)
         {
-            // @Todo(C++26) _unsafe shouldn't be needed with trivial unions
-            auto* chunk = alloc_uninit_unsafe<Chunk>(m_chunks.allocator());
-            m_chunks.push(chunk);
+            m_chunks.push(alloc_chunk());
         }
     }
 
@@ -341,6 +492,24 @@ public:
         resize_uninit_inner(size() - 1);
     }
 
+    // Removes the element at index i by moving the last element in its
+    // place, so the order isn't kept.
+    void swap_remove(isize_t i)
+    {
+        ASL_ASSERT(i >= 0 && i < m_size);
+
+        T* removed = &(*this)[i];
+        destroy_at(removed);
+
+        const isize_t last = m_size - 1;
+        if (i < last)
+        {
+            relocate_uninit_n(removed, &(*this)[last], 1);
+        }
+
+        m_size = last;
+    }
+
     template<typename Chunk>
     class generic_iterator
     {
@@ -401,5 +570,10 @@ public:
     }
 };
 
+// Elements live in chunks, which don't move with the buffer.
+template<is_object T, isize_t kChunkSize, allocator Allocator>
+struct trivially_relocatable<chunked_buffer<T, kChunkSize, Allocator>>
+    : bool_constant<is_trivially_relocatable<Allocator>> {};
+
 } // namespace asl
 
@@ -177,6 +177,50 @@ ASL_TEST(pop_destruct)
     ASL_TEST_EXPECT(d[2]);
 }
 
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(swap_remove)
+{
+    bool d[4]{};
+    asl::chunked_buffer<DestructorObserver, 2> b;
+
+    for (bool& destroyed: d)
+    {
+        b.push(&destroyed); // NOLINT
+    }
+
+    b.swap_remove(1);
+    ASL_TEST_EXPECT(b.size() == 3);
+    ASL_TEST_EXPECT(!d[0] && d[1] && !d[2] && !d[3]);
+    ASL_TEST_EXPECT(b[0].destroyed == &d[0]);
+    ASL_TEST_EXPECT(b[1].destroyed == &d[3]);
+    ASL_TEST_EXPECT(b[2].destroyed == &d[2]);
+
+    b.swap_remove(2);
+    ASL_TEST_EXPECT(b.size() == 2);
+    ASL_TEST_EXPECT(d[2] && !d[3]);
+
+    b.swap_remove(0);
+    b.swap_remove(0);
+    ASL_TEST_EXPECT(b.is_empty());
+    ASL_TEST_EXPECT(d[0] && d[3]);
+}
+
+ASL_TEST(swap_remove_relocatable)
+{
+    int moves = 0;
+    asl::chunked_buffer<RelocatableType, 4> b;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        b.push(i, &moves);
+    }
+
+    b.swap_remove(2);
+    ASL_TEST_EXPECT(b.size() == 9);
+    ASL_TEST_EXPECT(b[2].value == 9);
+    ASL_TEST_EXPECT(moves == 0);
+}
+
 ASL_TEST(clear_destroy)
 {
     bool destroyed[5]{};
@@ -254,6 +298,113 @@ ASL_TEST(alloc_count) // NOLINT
     ASL_TEST_EXPECT(stats.any_alloc_count() == 9);
 }
 
+ASL_TEST(clear_keeps_chunks)
+{
+    CountingAllocator::Stats stats;
+    asl::chunked_buffer<int, 4, CountingAllocator> buf{CountingAllocator{&stats}};
+
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        for (int i = 0; i < 30; ++i)
+        {
+            buf.push(i);
+        }
+        buf.clear();
+    }
+
+    // 8 chunks and the chunk list, allocated during the first frame only.
+    ASL_TEST_EXPECT(buf.capacity() == 32);
+    ASL_TEST_EXPECT(stats.alloc_count == 9);
+    ASL_TEST_EXPECT(stats.dealloc_count == 0);
+}
+
+ASL_TEST(shrink_to_fit) // NOLINT
+{
+    CountingAllocator::Stats stats;
+    asl::chunked_buffer<int, 4, CountingAllocator> buf{CountingAllocator{&stats}};
+
+    buf.resize(30, 7);
+    ASL_TEST_EXPECT(buf.capacity() == 32);
+
+    buf.resize(9);
+    buf.shrink_to_fit();
+    ASL_TEST_EXPECT(buf.capacity() == 12);
+    ASL_TEST_EXPECT(buf.size() == 9);
+    ASL_TEST_EXPECT(buf[8] == 7);
+
+    buf.clear();
+    buf.shrink_to_fit();
+    ASL_TEST_EXPECT(buf.capacity() == 0);
+    ASL_TEST_EXPECT(stats.alive_bytes == 0);
+
+    buf.push(1);
+    ASL_TEST_EXPECT(buf.capacity() == 4);
+    ASL_TEST_EXPECT(buf[0] == 1);
+}
+
+ASL_TEST(chunk_pool) // NOLINT
+{
+    CountingAllocator::Stats stats;
+
+    {
+        asl::chunk_pool<int, 4, CountingAllocator> pool{8, CountingAllocator{&stats}};
+
+        {
+            asl::chunked_buffer<int, 4, CountingAllocator> a{&pool, CountingAllocator{&stats}};
+            a.resize(24, 1);
+            ASL_TEST_EXPECT(pool.free_chunk_count() == 0);
+
+            a.resize(6);
+            a.shrink_to_fit();
+            ASL_TEST_EXPECT(pool.free_chunk_count() == 4);
+        }
+        ASL_TEST_EXPECT(pool.free_chunk_count() == 6);
+
+        // Another buffer gets its chunks from the pool.
+        const isize_t chunk_allocs = stats.alloc_count;
+        asl::chunked_buffer<int, 4, CountingAllocator> b{&pool, CountingAllocator{&stats}};
+        b.resize(20, 2);
+        ASL_TEST_EXPECT(pool.free_chunk_count() == 1);
+
+        // The chunk list is the only new allocation.
+        ASL_TEST_EXPECT(stats.alloc_count == chunk_allocs + 1);
+
+        // Moving keeps the pool.
+        asl::chunked_buffer<int, 4, CountingAllocator> c{std::move(b)};
+        c.resize(60, 3);
+        ASL_TEST_EXPECT(pool.free_chunk_count() == 0);
+
+        // Only 8 of the 15 chunks are kept.
+        c.destroy();
+        ASL_TEST_EXPECT(pool.free_chunk_count() == 8);
+
+        pool.set_max_free_chunks(2);
+        ASL_TEST_EXPECT(pool.free_chunk_count() == 2);
+    }
+
+    ASL_TEST_EXPECT(stats.alive_bytes == 0);
+}
+
+ASL_TEST(chunk_pool_destructor)
+{
+    bool destroyed[3]{};
+    asl::chunk_pool<DestructorObserver, 2> pool{4};
+
+    {
+        asl::chunked_buffer<DestructorObserver, 2> buf{&pool};
+        for (bool& d: destroyed)
+        {
+            buf.push(&d); // NOLINT
+        }
+    }
+
+    for (const bool d: destroyed)
+    {
+        ASL_TEST_EXPECT(d);
+    }
+    ASL_TEST_EXPECT(pool.free_chunk_count() == 2);
+}
+
 ASL_TEST(move)
 {
     bool destroyed[5]{};
@@ -0,0 +1,355 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "asl/base/support.hpp"
+#include "asl/base/assert.hpp"
+#include "asl/base/bits.hpp"
+#include "asl/base/memory_ops.hpp"
+#include "asl/base/numeric.hpp"
+#include "asl/allocator/allocator.hpp"
+#include "asl/synchronization/atomic.hpp"
+#include "asl/types/array.hpp"
+#include "asl/types/maybe_uninit.hpp"
+
+namespace asl
+{
+
+// Append-only chunked_buffer which several threads can push to at once,
+// while others read what was pushed so far.
+//
+// A push reserves its index with a single atomic increment, and constructs
+// its element in place, in parallel with other pushes. Chunks are
+// allocated by whichever thread needs them first, without a lock. Each
+// slot has a ready flag, which its push sets once the element is
+// constructed. Pushes never wait for each other: after setting its flag,
+// a push advances the published size over all the ready elements which
+// follow it, and stops at the first one which isn't ready. The push of
+// that one then takes over.
+//
+// size() is the number of published elements, which can be read from any
+// thread while others push. An element is only published once all those
+// before it are, so a preempted push holds back the size, but never the
+// other pushes. Elements never move.
+//
+// The allocator must be usable from several threads at once. clear and
+// destroy can't be called concurrently with anything else.
+template<
+    is_object T,
+    isize_t kChunkSize,
+    allocator Allocator = DefaultAllocator>
+class concurrent_chunked_buffer
+{
+    static_assert(kChunkSize > 0 && is_pow2(kChunkSize));
+
+    struct Chunk
+    {
+        array<maybe_uninit<T>, kChunkSize> values;
+
+        // Set by each push once its element is constructed.
+        atomic<bool> ready[kChunkSize];
+    };
+
+    static constexpr isize_t chunk_index(isize_t i)
+    {
+        static constexpr int kChunkSizeLog2 = countr_zero(uint64_t{kChunkSize});
+        return i >> kChunkSizeLog2;
+    }
+
+    static constexpr isize_t index_in_chunk(isize_t i)
+    {
+        static constexpr isize_t kMask = kChunkSize - 1;
+        return i & kMask;
+    }
+
+    // Chunk pointers live in segments which are allocated on demand and
+    // never move, segment s holding 2^s of them. That's enough segments
+    // for any index.
+    static constexpr int kSegmentCount = 48;
+
+    using Segment = atomic<Chunk*>;
+
+    struct ChunkLocation
+    {
+        int     segment;
+        isize_t index_in_segment;
+    };
+
+    static constexpr ChunkLocation chunk_location(isize_t chunk)
+    {
+        const int segment = bit_width(static_cast<uint64_t>(chunk + 1)) - 1;
+        return { segment, chunk + 1 - (isize_t{1} << segment) };
+    }
+
+    static constexpr layout segment_layout(int segment)
+    {
+        return layout::array<Segment>(isize_t{1} << segment);
+    }
+
+    mutable atomic<Segment*> m_segments[kSegmentCount]{};
+
+    // Every push writes both, so they get their own cache lines.
+    // m_reserved is the number of indices handed out to pushes, and
+    // m_size the number of elements which are published.
+    alignas(64) atomic<isize_t> m_reserved{};
+    alignas(64) mutable atomic<isize_t> m_size{};
+
+    ASL_NO_UNIQUE_ADDRESS Allocator m_allocator;
+
+    // Returns the slot of a chunk pointer, allocating its segment if it
+    // doesn't exist yet.
+    Segment* chunk_slot(isize_t chunk)
+    {
+        const ChunkLocation location = chunk_location(chunk);
+        atomic<Segment*>* segment_slot = &m_segments[location.segment]; // NOLINT(*-constant-array-index)
+
+        Segment* segment = atomic_load(segment_slot, memory_order::acquire);
+        if (segment == nullptr)
+        {
+            const layout l = segment_layout(location.segment);
+            auto* new_segment = static_cast<Segment*>(m_allocator.alloc(l));
+            memzero(new_segment, l.size);
+
+            // Someone else might have been faster, in which case we use
+            // their segment instead.
+            if (atomic_compare_exchange(
+                segment_slot, &segment, new_segment,
+                memory_order::acq_rel, memory_order::acquire))
+            {
+                segment = new_segment;
+            }
+            else
+            {
+                m_allocator.dealloc(new_segment, l);
+            }
+        }
+
+        return segment + location.index_in_segment; // NOLINT(*-pointer-arithmetic)
+    }
+
+    Chunk* get_or_alloc_chunk(isize_t chunk)
+    {
+        Segment* slot = chunk_slot(chunk);
+
+        Chunk* c = atomic_load(slot, memory_order::acquire);
+        if (c == nullptr)
+        {
+            // @Todo(C++26) _unsafe shouldn't be needed with trivial unions
+            auto* new_chunk = alloc_uninit_unsafe<Chunk>(m_allocator);
+            memzero(&new_chunk->ready, static_cast<isize_t>(sizeof(new_chunk->ready)));
+
+            if (atomic_compare_exchange(
+                slot, &c, new_chunk,
+                memory_order::acq_rel, memory_order::acquire))
+            {
+                c = new_chunk;
+            }
+            else
+            {
+                alloc_delete(m_allocator, new_chunk);
+            }
+        }
+
+        return c;
+    }
+
+    // Only for chunks of published elements. Publishing happens after
+    // the chunk was allocated, and size() loads with acquire, so relaxed
+    // loads see it.
+    Chunk& published_chunk(isize_t chunk) const
+    {
+        const ChunkLocation location = chunk_location(chunk);
+        Segment* segment = atomic_load(&m_segments[location.segment], memory_order::relaxed); // NOLINT(*-constant-array-index)
+        return *atomic_load(segment + location.index_in_segment, memory_order::relaxed); // NOLINT(*-pointer-arithmetic)
+    }
+
+    // Whether the element at i was pushed and constructed. Its chunk
+    // might not even be allocated yet.
+    bool is_ready(isize_t i) const
+    {
+        const ChunkLocation location = chunk_location(chunk_index(i));
+
+        Segment* segment = atomic_load(&m_segments[location.segment], memory_order::acquire); // NOLINT(*-constant-array-index)
+        if (segment == nullptr) { return false; }
+
+        Chunk* chunk = atomic_load(segment + location.index_in_segment, memory_order::acquire); // NOLINT(*-pointer-arithmetic)
+        if (chunk == nullptr) { return false; }
+
+        return atomic_load(&chunk->ready[index_in_chunk(i)], memory_order::seq_cst); // NOLINT(*-constant-array-index)
+    }
+
+    // Publishes the ready elements which follow the published ones.
+    //
+    // Setting a ready flag and loading the size are sequentially
+    // consistent, as are loading a ready flag and advancing the size. So
+    // when a push stops on an element which isn't ready, the push of that
+    // element either sees the size once it's ready, or the thread which
+    // advances the size up to it then sees it ready.
+    void publish_ready()
+    {
+        isize_t size = atomic_load(&m_size, memory_order::seq_cst);
+        while (is_ready(size))
+        {
+            // On failure, someone else published it, and size is updated.
+            if (atomic_compare_exchange(
+                &m_size, &size, size + 1,
+                memory_order::seq_cst, memory_order::seq_cst))
+            {
+                size += 1;
+            }
+        }
+    }
+
+public:
+    constexpr concurrent_chunked_buffer()
+        requires is_default_constructible<Allocator>
+        = default;
+
+    explicit constexpr concurrent_chunked_buffer(Allocator allocator)
+        : m_allocator{std::move(allocator)}
+    {}
+
+    ASL_DELETE_COPY_MOVE(concurrent_chunked_buffer);
+
+    ~concurrent_chunked_buffer()
+    {
+        destroy();
+    }
+
+    // Destroys the elements, but keeps the chunks for later pushes.
+    void clear()
+    {
+        const isize_t size = atomic_load(&m_size);
+        ASL_ASSERT(atomic_load(&m_reserved) == size);
+
+        for (isize_t i = 0; i < size; ++i)
+        {
+            Chunk& chunk = published_chunk(chunk_index(i));
+            if constexpr (!is_trivially_destructible<T>)
+            {
+                chunk.values[index_in_chunk(i)].destroy_unsafe();
+            }
+            atomic_store(&chunk.ready[index_in_chunk(i)], false); // NOLINT(*-constant-array-index)
+        }
+
+        atomic_store(&m_reserved, isize_t{0});
+        atomic_store(&m_size, isize_t{0});
+    }
+
+    void destroy()
+    {
+        clear();
+
+        for (int s = 0; s < kSegmentCount; ++s)
+        {
+            Segment* segment = atomic_exchange(&m_segments[s], static_cast<Segment*>(nullptr)); // NOLINT(*-constant-array-index)
+            if (segment == nullptr) { continue; }
+
+            for (isize_t i = 0; i < (isize_t{1} << s); ++i)
+            {
+                // NOLINTNEXTLINE(*-pointer-arithmetic)
+                if (Chunk* chunk = atomic_load(segment + i); chunk != nullptr)
+                {
+                    alloc_delete(m_allocator, chunk);
+                }
+            }
+
+            m_allocator.dealloc(segment, segment_layout(s));
+        }
+    }
+
+    // Number of published elements. Elements before that index can be
+    // read from any thread.
+    [[nodiscard]] isize_t size() const
+    {
+        return atomic_load(&m_size, memory_order::acquire);
+    }
+
+    [[nodiscard]] bool is_empty() const { return size() == 0; }
+
+    const T& operator[](isize_t i) const
+    {
+        ASL_ASSERT(i >= 0 && i < size());
+        return published_chunk(chunk_index(i)).values[index_in_chunk(i)].as_init_unsafe();
+    }
+
+    // Returns the new element. It's published as soon as the elements
+    // before it are, maybe already, and other threads may then be reading
+    // it, so it can't be modified anymore.
+    const T& push(auto&&... args)
+        requires constructible_from<T, decltype(args)&&...>
+    {
+        const isize_t index = atomic_fetch_increment(&m_reserved);
+
+        Chunk* chunk = get_or_alloc_chunk(chunk_index(index));
+        void* uninit = &chunk->values[index_in_chunk(index)];
+        T* value = construct_at<T>(uninit, std::forward<decltype(args)>(args)...);
+
+        atomic_store(&chunk->ready[index_in_chunk(index)], true, memory_order::seq_cst); // NOLINT(*-constant-array-index)
+        publish_ready();
+
+        return *value;
+    }
+
+    // Allocates chunks for new_capacity elements upfront, so that pushes
+    // don't have to. Can be called concurrently with pushes.
+    void reserve_capacity(isize_t new_capacity)
+    {
+        ASL_ASSERT(new_capacity >= 0);
+
+        for (isize_t chunk = 0; chunk < chunk_index(new_capacity + kChunkSize - 1); ++chunk)
+        {
+            get_or_alloc_chunk(chunk);
+        }
+    }
+
+    // Iterates over the elements published when end() is called.
+    class const_iterator
+    {
+        const concurrent_chunked_buffer* m_buffer;
+        isize_t                          m_index;
+
+    public:
+        constexpr const_iterator(const concurrent_chunked_buffer* buffer, isize_t index)
+            : m_buffer{buffer}
+            , m_index{index}
+        {}
+
+        constexpr const_iterator& operator++()
+        {
+            m_index += 1;
+            return *this;
+        }
+
+        constexpr const_iterator operator++(int)
+        {
+            auto tmp = *this;
+            m_index += 1;
+            return tmp;
+        }
+
+        constexpr bool operator==(const const_iterator& other) const
+        {
+            ASL_ASSERT(m_buffer == other.m_buffer);
+            return m_index == other.m_index;
+        }
+
+        const T& operator*() const
+        {
+            ASL_ASSERT(m_index >= 0);
+            return m_buffer->published_chunk(chunk_index(m_index)).values[index_in_chunk(m_index)].as_init_unsafe();
+        }
+
+        const T* operator->() const
+        {
+            return &**this;
+        }
+    };
+
+    const_iterator begin() const { return const_iterator{this, 0}; }
+    const_iterator end() const { return const_iterator{this, size()}; }
+};
+
+} // namespace asl
@@ -0,0 +1,224 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/containers/concurrent_chunked_buffer.hpp"
+#include "asl/synchronization/wait.hpp"
+#include "asl/testing/testing.hpp"
+#include "asl/tests/types.hpp"
+#include "asl/tests/counting_allocator.hpp"
+#include "asl/tests/threads.hpp"
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(single_thread)
+{
+    CountingAllocator::Stats stats;
+    asl::concurrent_chunked_buffer<int, 4, CountingAllocator> b(CountingAllocator{&stats});
+    ASL_TEST_EXPECT(b.is_empty());
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ASL_TEST_EXPECT(b.push(i * 2) == i * 2);
+    }
+    ASL_TEST_EXPECT(b.size() == 100);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ASL_TEST_EXPECT(b[i] == i * 2);
+    }
+
+    int expected = 0;
+    for (const int x: b)
+    {
+        ASL_TEST_EXPECT(x == expected);
+        expected += 2;
+    }
+    ASL_TEST_EXPECT(expected == 200);
+
+    // Clearing keeps the chunks.
+    const isize_t alloc_count = stats.alloc_count;
+    b.clear();
+    ASL_TEST_EXPECT(b.size() == 0);
+    for (int i = 0; i < 100; ++i)
+    {
+        b.push(i);
+    }
+    ASL_TEST_EXPECT(stats.alloc_count == alloc_count);
+
+    b.destroy();
+    ASL_TEST_EXPECT(stats.alive_bytes == 0);
+}
+
+ASL_TEST(reserve_capacity)
+{
+    CountingAllocator::Stats stats;
+    asl::concurrent_chunked_buffer<int, 8, CountingAllocator> b(CountingAllocator{&stats});
+
+    b.reserve_capacity(20);
+    const isize_t alloc_count = stats.alloc_count;
+    ASL_TEST_EXPECT(alloc_count > 0);
+
+    for (int i = 0; i < 24; ++i)
+    {
+        b.push(i);
+    }
+    ASL_TEST_EXPECT(stats.alloc_count == alloc_count);
+
+    b.push(24);
+    ASL_TEST_EXPECT(stats.alloc_count > alloc_count);
+}
+
+ASL_TEST(destructor)
+{
+    bool d[5]{};
+
+    {
+        asl::concurrent_chunked_buffer<DestructorObserver, 2> b;
+        for (bool& x: d)
+        {
+            b.push(&x);
+        }
+
+        for (const bool x: d) { ASL_TEST_EXPECT(!x); }
+    }
+
+    for (const bool x: d) { ASL_TEST_EXPECT(x); }
+}
+
+static constexpr int kPushesPerThread = 16384;
+
+struct Event
+{
+    int thread;
+    int sequence;
+    int check;
+};
+
+struct SharedState
+{
+    asl::concurrent_chunked_buffer<Event, 256> events;
+    ThreadErrors errors;
+};
+
+static void push_and_read(int index, void* user)
+{
+    auto* state = static_cast<SharedState*>(user);
+    auto* events = &state->events;
+
+    for (int i = 0; i < kPushesPerThread; ++i)
+    {
+        events->push(Event{ .thread = index, .sequence = i, .check = index * 31 + i });
+
+        // Everything published so far must be fully constructed.
+        if (i % 1024 == 0)
+        {
+            for (const Event& e: *events)
+            {
+                state->errors.expect(e.check == e.thread * 31 + e.sequence);
+            }
+        }
+    }
+}
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(many_threads)
+{
+    SharedState state{};
+
+    run_threads(push_and_read, &state);
+
+    ASL_TEST_EXPECT(state.errors.count() == 0);
+    ASL_TEST_ASSERT(state.events.size() == kThreadCount * kPushesPerThread);
+
+    // Every push is there once, and each thread's are in order.
+    int next_sequence[kThreadCount]{};
+    for (const Event& e: state.events)
+    {
+        ASL_TEST_ASSERT(e.thread >= 0 && e.thread < kThreadCount);
+        ASL_TEST_EXPECT(e.sequence == next_sequence[e.thread]); // NOLINT(*-constant-array-index)
+        ASL_TEST_EXPECT(e.check == e.thread * 31 + e.sequence);
+        next_sequence[e.thread] = e.sequence + 1; // NOLINT(*-constant-array-index)
+    }
+
+    for (const int n: next_sequence)
+    {
+        ASL_TEST_EXPECT(n == kPushesPerThread);
+    }
+}
+
+static constexpr int kPushesBehindStalled = 100;
+
+// Long enough for everyone to get there, unless they can't.
+static constexpr int kMaxWaitIterations = 1'000'000;
+
+struct StalledState;
+
+// The first element takes until every other thread is done pushing to be
+// constructed.
+struct Stalling
+{
+    int value;
+
+    Stalling(int v, StalledState* state);
+};
+
+struct StalledState
+{
+    asl::concurrent_chunked_buffer<Stalling, 16> items;
+    asl::atomic<bool> is_stalled;
+    asl::atomic<int>  done_threads;
+    ThreadErrors      errors;
+};
+
+Stalling::Stalling(int v, StalledState* state)
+    : value{v}
+{
+    if (v >= 0) { return; }
+
+    asl::atomic_store(&state->is_stalled, true, asl::memory_order::release);
+
+    int i = 0;
+    while (asl::atomic_load(&state->done_threads, asl::memory_order::acquire) < kThreadCount - 1
+        && i < kMaxWaitIterations)
+    {
+        asl::yield_thread();
+        i += 1;
+    }
+    state->errors.expect(asl::atomic_load(&state->done_threads, asl::memory_order::acquire) == kThreadCount - 1);
+}
+
+static void push_behind_stalled(int index, void* user)
+{
+    auto* state = static_cast<StalledState*>(user);
+
+    if (index == 0)
+    {
+        state->items.push(-1, state);
+        return;
+    }
+
+    while (!asl::atomic_load(&state->is_stalled, asl::memory_order::acquire))
+    {
+        asl::yield_thread();
+    }
+
+    for (int i = 0; i < kPushesBehindStalled; ++i)
+    {
+        state->items.push(i, state);
+    }
+
+    // Nothing is published before the first element.
+    state->errors.expect(state->items.size() == 0);
+    asl::atomic_fetch_increment(&state->done_threads, asl::memory_order::release);
+}
+
+ASL_TEST(stalled_push)
+{
+    StalledState state{};
+
+    run_threads(push_behind_stalled, &state);
+
+    ASL_TEST_EXPECT(state.errors.count() == 0);
+    ASL_TEST_ASSERT(state.items.size() == 1 + (kThreadCount - 1) * kPushesBehindStalled);
+    ASL_TEST_EXPECT(state.items[0].value == -1);
+}
@@ -0,0 +1,248 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "asl/base/support.hpp"
+#include "asl/base/meta.hpp"
+#include "asl/base/bits.hpp"
+#include "asl/base/defer.hpp"
+#include "asl/base/numeric.hpp"
+#include "asl/allocator/allocator.hpp"
+#include "asl/containers/hash_map.hpp"
+#include "asl/synchronization/rw_lock.hpp"
+#include "asl/types/option.hpp"
+
+namespace asl
+{
+
+// Hash map which can be used from several threads at once. It's split
+// into shards, each one a hash_map behind its own reader/writer lock,
+// and picked with the high bits of the hash, which the hash_map inside
+// doesn't use. Keys are hashed once, and the shard's map is given that
+// hash along with the key. Threads only contend when they use the same
+// shard, and readers of a shard don't block each other.
+//
+// References to values can't outlive the lock of their shard, so lookups
+// either copy the value out, or call a function with it under the lock.
+template<
+    is_object K,
+    is_object V,
+    allocator Allocator = DefaultAllocator,
+    key_hasher<K> KeyHasher = default_key_hasher<K>,
+    key_comparator<K> KeyComparator = default_key_comparator<K>,
+    isize_t kShardCount = 64
+>
+requires movable<K> && movable<V> && (kShardCount >= 2) && (is_pow2(kShardCount))
+class concurrent_hash_map
+{
+    // Key along with its hash, so that the shard's map doesn't hash it
+    // again. KeyRef is a reference to the key.
+    template<typename KeyRef>
+    struct HashedKey
+    {
+        KeyRef   key;
+        uint64_t hash;
+
+        // Only used when the shard's map inserts a new key.
+        operator K() const // NOLINT(*-explicit-conversions)
+        {
+            return K{static_cast<KeyRef>(key)};
+        }
+    };
+
+    struct ShardHasher : public KeyHasher
+    {
+        using KeyHasher::hash;
+
+        template<typename KeyRef>
+        constexpr static uint64_t hash(const HashedKey<KeyRef>& key)
+        {
+            return key.hash;
+        }
+    };
+
+    struct ShardComparator : public KeyComparator
+    {
+        using KeyComparator::eq;
+
+        template<typename KeyRef>
+        constexpr static bool eq(const K& a, const HashedKey<KeyRef>& b)
+        {
+            return KeyComparator::eq(a, b.key);
+        }
+    };
+
+    using Map = hash_map<K, V, Allocator, ShardHasher, ShardComparator>;
+
+    static constexpr int kShardBits = countr_zero(static_cast<uint64_t>(kShardCount));
+
+    // On its own cache line, so that locking a shard doesn't
+    // invalidate the lock of its neighbours in other cores' caches.
+    struct alignas(64) Shard
+    {
+        mutable RwLock lock;
+        Map            map;
+    };
+
+    Shard m_shards[kShardCount];
+
+    template<typename U>
+    static HashedKey<const U&> hashed(const U& key)
+    {
+        return { key, KeyHasher::hash(key) };
+    }
+
+    static isize_t shard_index(uint64_t hash)
+    {
+        return static_cast<isize_t>(hash >> (64 - kShardBits));
+    }
+
+    Shard& shard_for(uint64_t hash)
+    {
+        return m_shards[shard_index(hash)]; // NOLINT(*-constant-array-index)
+    }
+
+    const Shard& shard_for(uint64_t hash) const
+    {
+        return m_shards[shard_index(hash)]; // NOLINT(*-constant-array-index)
+    }
+
+public:
+    concurrent_hash_map() requires is_default_constructible<Allocator> = default;
+
+    explicit concurrent_hash_map(const Allocator& allocator)
+        requires copy_constructible<Allocator>
+    {
+        for (Shard& shard: m_shards)
+        {
+            shard.map = Map{allocator};
+        }
+    }
+
+    ASL_DELETE_COPY_MOVE(concurrent_hash_map);
+
+    ~concurrent_hash_map() = default;
+
+    template<typename U, typename Arg0, typename... Args1>
+    requires
+        key_hasher<KeyHasher, U> &&
+        key_comparator<KeyComparator, K, U> &&
+        constructible_from<K, U&&> &&
+        constructible_from<V, Arg0&&, Args1&&...>
+    void insert(U&& key, Arg0&& arg0, Args1&&... args1)
+    {
+        const uint64_t hash = KeyHasher::hash(key);
+        Shard& shard = shard_for(hash);
+        shard.lock.lock();
+        ASL_DEFER [&shard]() { shard.lock.unlock(); };
+
+        shard.map.insert(HashedKey<U&&>{std::forward<U>(key), hash}, std::forward<Arg0>(arg0), std::forward<Args1>(args1)...);
+    }
+
+    template<typename U>
+    requires key_hasher<KeyHasher, U> && key_comparator<KeyComparator, K, U>
+    bool remove(const U& key)
+    {
+        const auto hashed_key = hashed(key);
+        Shard& shard = shard_for(hashed_key.hash);
+        shard.lock.lock();
+        ASL_DEFER [&shard]() { shard.lock.unlock(); };
+
+        return shard.map.remove(hashed_key);
+    }
+
+    template<typename U>
+    requires key_hasher<KeyHasher, U> && key_comparator<KeyComparator, K, U>
+    bool contains(const U& key) const
+    {
+        const auto hashed_key = hashed(key);
+        const Shard& shard = shard_for(hashed_key.hash);
+        shard.lock.lock_shared();
+        ASL_DEFER [&shard]() { shard.lock.unlock_shared(); };
+
+        return shard.map.contains(hashed_key);
+    }
+
+    // Copy of the value, taken under the lock.
+    template<typename U>
+    requires key_hasher<KeyHasher, U> && key_comparator<KeyComparator, K, U> && copy_constructible<V>
+    option<V> get(const U& key) const
+    {
+        const auto hashed_key = hashed(key);
+        const Shard& shard = shard_for(hashed_key.hash);
+        shard.lock.lock_shared();
+        ASL_DEFER [&shard]() { shard.lock.unlock_shared(); };
+
+        if (const V* value = shard.map.get(hashed_key); value != nullptr)
+        {
+            return *value;
+        }
+        return nullopt;
+    }
+
+    // Calls callback(const V&) when the key is present, while holding the
+    // shard's lock in shared mode. Returns whether the key was found.
+    template<typename U, typename Callback>
+    requires key_hasher<KeyHasher, U> && key_comparator<KeyComparator, K, U> && invocable<Callback, const V&>
+    bool visit(const U& key, Callback&& callback) const
+    {
+        const auto hashed_key = hashed(key);
+        const Shard& shard = shard_for(hashed_key.hash);
+        shard.lock.lock_shared();
+        ASL_DEFER [&shard]() { shard.lock.unlock_shared(); };
+
+        if (const V* value = shard.map.get(hashed_key); value != nullptr)
+        {
+            std::forward<Callback>(callback)(*value);
+            return true;
+        }
+        return false;
+    }
+
+    // Calls callback(V&) when the key is present, while holding the
+    // shard's lock in exclusive mode. Returns whether the key was found.
+    template<typename U, typename Callback>
+    requires key_hasher<KeyHasher, U> && key_comparator<KeyComparator, K, U> && invocable<Callback, V&>
+    bool update(const U& key, Callback&& callback)
+    {
+        const auto hashed_key = hashed(key);
+        Shard& shard = shard_for(hashed_key.hash);
+        shard.lock.lock();
+        ASL_DEFER [&shard]() { shard.lock.unlock(); };
+
+        if (V* value = shard.map.get(hashed_key); value != nullptr)
+        {
+            std::forward<Callback>(callback)(*value);
+            return true;
+        }
+        return false;
+    }
+
+    // Sum of the sizes of all shards, each one read under its lock. When
+    // other threads are inserting or removing, this is only an estimate.
+    [[nodiscard]] isize_t size() const
+    {
+        isize_t size = 0;
+        for (const Shard& shard: m_shards)
+        {
+            shard.lock.lock_shared();
+            size += shard.map.size();
+            shard.lock.unlock_shared();
+        }
+        return size;
+    }
+
+    void clear()
+    {
+        for (Shard& shard: m_shards)
+        {
+            shard.lock.lock();
+            shard.map.clear();
+            shard.lock.unlock();
+        }
+    }
+};
+
+} // namespace asl
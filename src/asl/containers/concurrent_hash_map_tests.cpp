@@ -0,0 +1,112 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/containers/concurrent_hash_map.hpp"
+#include "asl/testing/testing.hpp"
+#include "asl/strings/string.hpp"
+#include "asl/strings/string_view.hpp"
+#include "asl/tests/threads.hpp"
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(single_thread)
+{
+    asl::concurrent_hash_map<asl::string<>, int> map;
+
+    map.insert("Hello"_sv, 1);
+    map.insert("World"_sv, 2);
+    map.insert("Hello"_sv, 3);
+
+    ASL_TEST_EXPECT(map.size() == 2);
+    ASL_TEST_EXPECT(map.contains("Hello"_sv));
+    ASL_TEST_EXPECT(!map.contains("Nope"_sv));
+
+    auto value = map.get("Hello"_sv);
+    ASL_TEST_ASSERT(value.has_value());
+    ASL_TEST_EXPECT(value.value() == 3);
+    ASL_TEST_EXPECT(!map.get("Nope"_sv).has_value());
+
+    ASL_TEST_EXPECT(map.update("World"_sv, [](int& v) { v *= 10; }));
+    ASL_TEST_EXPECT(!map.update("Nope"_sv, [](int& v) { v *= 10; }));
+
+    int seen = 0;
+    ASL_TEST_EXPECT(map.visit("World"_sv, [&seen](const int& v) { seen = v; }));
+    ASL_TEST_EXPECT(seen == 20);
+
+    ASL_TEST_EXPECT(map.remove("Hello"_sv));
+    ASL_TEST_EXPECT(!map.remove("Hello"_sv));
+    ASL_TEST_EXPECT(map.size() == 1);
+
+    map.clear();
+    ASL_TEST_EXPECT(map.size() == 0);
+    ASL_TEST_EXPECT(!map.contains("World"_sv));
+}
+
+static constexpr int kKeysPerThread = 16384;
+static constexpr int kSharedKeys = 64;
+
+struct SharedState
+{
+    asl::concurrent_hash_map<int, int> map;
+    ThreadErrors errors;
+};
+
+static void insert_and_read(int index, void* user)
+{
+    auto* state = static_cast<SharedState*>(user);
+    auto* map = &state->map;
+
+    for (int i = 0; i < kKeysPerThread; ++i)
+    {
+        const int key = index * kKeysPerThread + i;
+        map->insert(key, key * 2);
+
+        // Keys of other threads, which may or may not be there yet.
+        const int other = ((index + 1) % kThreadCount) * kKeysPerThread + i;
+        map->visit(other, [state, other](const int& value) {
+            state->errors.expect(value == other * 2);
+        });
+
+        // Everyone fights over a few keys.
+        map->update(-1 - (i % kSharedKeys), [](int& value) { value += 1; });
+
+        if (i % 2 == 1)
+        {
+            state->errors.expect(map->remove(key));
+        }
+    }
+}
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(many_threads)
+{
+    SharedState state{};
+    auto& map = state.map;
+
+    // Inserted before the threads start, so that they all update them.
+    for (int i = 0; i < kSharedKeys; ++i)
+    {
+        map.insert(-1 - i, 0);
+    }
+
+    run_threads(insert_and_read, &state);
+
+    ASL_TEST_EXPECT(state.errors.count() == 0);
+
+    ASL_TEST_EXPECT(map.size() == kSharedKeys + kThreadCount * kKeysPerThread / 2);
+
+    for (int i = 0; i < kSharedKeys; ++i)
+    {
+        ASL_TEST_EXPECT(map.get(-1 - i).value() == kThreadCount * kKeysPerThread / kSharedKeys);
+    }
+
+    for (int key = 0; key < kThreadCount * kKeysPerThread; ++key)
+    {
+        const auto value = map.get(key);
+        ASL_TEST_EXPECT(value.has_value() == (key % 2 == 0));
+        if (value.has_value())
+        {
+            ASL_TEST_EXPECT(value.value() == key * 2);
+        }
+    }
+}
@@ -9,6 +9,7 @@
 #include "asl/base/memory.hpp"
 #include "asl/hashing/hash.hpp"
 #include "asl/allocator/allocator.hpp"
+#include "asl/types/span.hpp"
 #include "asl/containers/hash_set.hpp"
 
 namespace asl::hash_map_internal
@@ -42,7 +43,9 @@ struct SlotComparator : public KeyComparator
         return KeyComparator::eq(a.key, b.key);
     }
 
-    constexpr static bool eq(const Slot<K, V>& a, const K& b)
+    template<typename U>
+    requires key_comparator<KeyComparator, K, U>
+    constexpr static bool eq(const Slot<K, V>& a, const U& b)
     {
         return KeyComparator::eq(a.key, b);
     }
@@ -53,26 +56,33 @@ struct SlotComparator : public KeyComparator
 namespace asl
 {
 
+template<typename K, typename V>
+struct trivially_relocatable<hash_map_internal::Slot<K, V>>
+    : bool_constant<is_trivially_relocatable<K> && is_trivially_relocatable<V>> {};
+
 template<
     is_object K,
     is_object V,
     allocator Allocator = DefaultAllocator,
     key_hasher<K> KeyHasher = default_key_hasher<K>,
-    key_comparator<K> KeyComparator = default_key_comparator<K>
+    key_comparator<K> KeyComparator = default_key_comparator<K>,
+    hash_set_layout Layout = default_hash_set_layout<hash_map_internal::Slot<K, V>>
 >
 requires movable<K> && movable<V>
 class hash_map : protected hash_set<
     hash_map_internal::Slot<K, V>,
     Allocator,
     hash_map_internal::SlotHasher<K, V, KeyHasher>,
-    hash_map_internal::SlotComparator<K, V, KeyComparator>>
+    hash_map_internal::SlotComparator<K, V, KeyComparator>,
+    Layout>
 {
     using Base =
         hash_set<
             hash_map_internal::Slot<K, V>,
             Allocator,
             hash_map_internal::SlotHasher<K, V, KeyHasher>,
-            hash_map_internal::SlotComparator<K, V, KeyComparator>>;
+            hash_map_internal::SlotComparator<K, V, KeyComparator>,
+            Layout>;
 
 public:
     constexpr hash_map() requires is_default_constructible<Allocator> = default;
@@ -89,10 +99,18 @@ public:
 
     using Base::is_empty;
 
+    using Base::capacity;
+
+    using Base::rehash;
+
+    using Base::shrink_to_fit;
+
     using Base::remove;
 
     using Base::contains;
 
+    using Base::write_image;
+
     template<typename U, typename Arg0, typename... Args1>
     requires
         key_hasher<KeyHasher, U> &&
@@ -105,43 +123,39 @@ public:
 
         auto result = Base::find_slot_insert(key);
 
-        // NOLINTBEGIN(*-pointer-arithmetic)
-
         ASL_ASSERT(result.first_available_index >= 0);
 
         if (result.already_present_index >= 0)
         {
             if (result.already_present_index != result.first_available_index)
             {
-                ASL_ASSERT((Base::m_tags[result.first_available_index] & Base::kHasValue) == 0);
+                ASL_ASSERT((Base::m_storage.tag(result.first_available_index) & Base::kHasValue) == 0);
 
-                Base::m_values[result.first_available_index].construct_unsafe(std::move(Base::m_values[result.already_present_index].as_init_unsafe()));
-                Base::m_values[result.already_present_index].destroy_unsafe();
+                Base::m_storage.value(result.first_available_index).construct_unsafe(std::move(Base::m_storage.value(result.already_present_index).as_init_unsafe()));
+                Base::m_storage.value(result.already_present_index).destroy_unsafe();
 
-                Base::m_tags[result.first_available_index] = result.tag;
-                Base::m_tags[result.already_present_index] = Base::kTombstone;
+                Base::fill_slot(result.first_available_index, result.tag);
+                Base::erase_slot(result.already_present_index);
             }
 
-            ASL_ASSERT(Base::m_tags[result.first_available_index] == result.tag);
+            ASL_ASSERT(Base::m_storage.tag(result.first_available_index) == result.tag);
 
             if constexpr (sizeof...(Args1) == 0 && assignable_from<V&, Arg0&&>)
             {
-                Base::m_values[result.first_available_index].as_init_unsafe().value = std::forward<Arg0>(arg0);
+                Base::m_storage.value(result.first_available_index).as_init_unsafe().value = std::forward<Arg0>(arg0);
             }
             else
             {
-                Base::m_values[result.first_available_index].as_init_unsafe().value = std::move(V{std::forward<Arg0>(arg0), std::forward<Args1>(args1)...});
+                Base::m_storage.value(result.first_available_index).as_init_unsafe().value = std::move(V{std::forward<Arg0>(arg0), std::forward<Args1>(args1)...});
             }
         }
         else
         {
-            ASL_ASSERT((Base::m_tags[result.first_available_index] & Base::kHasValue) == 0);
-            Base::m_values[result.first_available_index].construct_unsafe(std::forward<U>(key), V{std::forward<Arg0>(arg0), std::forward<Args1>(args1)...});
-            Base::m_tags[result.first_available_index] = result.tag;
+            ASL_ASSERT((Base::m_storage.tag(result.first_available_index) & Base::kHasValue) == 0);
+            Base::m_storage.value(result.first_available_index).construct_unsafe(std::forward<U>(key), V{std::forward<Arg0>(arg0), std::forward<Args1>(args1)...});
+            Base::fill_slot(result.first_available_index, result.tag);
             Base::m_size += 1;
         }
-
-        // NOLINTEND(*-pointer-arithmetic)
     }
 
     template<typename U>
@@ -152,11 +166,29 @@ public:
         isize_t index = self.find_slot_lookup(value);
         if (index >= 0)
         {
-            // NOLINTNEXTLINE(*-pointer-arithmetic)
-            return return_type{ &self.m_values[index].as_init_unsafe().value };
+            return return_type{ &self.m_storage.value(index).as_init_unsafe().value };
         }
         return return_type{ nullptr };
     }
+
+    // Looks up many keys at once, much faster than one by one when the
+    // map doesn't fit in the cache. out[i] is set to the value of keys[i],
+    // or nullptr when it's missing.
+    void get_many(span<const K> keys, span<V*> out)
+    {
+        ASL_ASSERT(keys.size() == out.size());
+        Base::find_slots_lookup(keys, [&](isize_t i, isize_t slot) {
+            out[i] = slot >= 0 ? &Base::m_storage.value(slot).as_init_unsafe().value : nullptr;
+        });
+    }
+
+    void get_many(span<const K> keys, span<const V*> out) const
+    {
+        ASL_ASSERT(keys.size() == out.size());
+        Base::find_slots_lookup(keys, [&](isize_t i, isize_t slot) {
+            out[i] = slot >= 0 ? &Base::m_storage.value(slot).as_init_unsafe().value : nullptr;
+        });
+    }
 };
 
 } // namespace asl
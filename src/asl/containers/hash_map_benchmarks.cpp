@@ -0,0 +1,182 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/containers/hash_map.hpp"
+#include "asl/containers/buffer.hpp"
+#include "asl/benchmarking/benchmarking.hpp"
+
+using asl::benchmarking::CountingAllocator;
+
+using Map = asl::hash_map<uint64_t, uint64_t, CountingAllocator>;
+
+// Tables grow at 75% load, so any count between 24Ki and 48Ki lands in a
+// 64Ki slots table. Benchmark arguments are a load factor in percent.
+static constexpr isize_t kCapacity = 64 * 1024;
+
+static isize_t count_for_load(int64_t load_percent)
+{
+    return kCapacity * load_percent / 100;
+}
+
+static uint64_t splitmix64(uint64_t* state)
+{
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27U)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31U);
+}
+
+static asl::buffer<uint64_t> random_keys(isize_t count, uint64_t seed)
+{
+    asl::buffer<uint64_t> keys;
+    keys.reserve_capacity(count);
+    for (isize_t i = 0; i < count; ++i)
+    {
+        keys.push(splitmix64(&seed));
+    }
+    return keys;
+}
+
+static Map make_map(const asl::buffer<uint64_t>& keys)
+{
+    Map map;
+    for (const uint64_t key: keys)
+    {
+        map.insert(key, key);
+    }
+    return map;
+}
+
+// Builds a whole table up to the load factor, including growth.
+ASL_BENCHMARK_ARGS(hash_map_insert, 40, 55, 70)
+{
+    const auto keys = random_keys(count_for_load(state.arg()), 1);
+
+    while (state.keep_running())
+    {
+        Map map = make_map(keys);
+        asl::benchmarking::do_not_optimize(map.size());
+    }
+}
+
+ASL_BENCHMARK_ARGS(hash_map_lookup_hit, 40, 55, 70)
+{
+    const auto keys = random_keys(count_for_load(state.arg()), 1);
+    const Map map = make_map(keys);
+    const isize_t count = keys.size();
+
+    isize_t i = 0;
+    while (state.keep_running())
+    {
+        asl::benchmarking::do_not_optimize(map.get(keys[i]));
+        i = i + 1 == count ? 0 : i + 1;
+    }
+}
+
+ASL_BENCHMARK_ARGS(hash_map_lookup_miss, 40, 55, 70)
+{
+    const auto keys = random_keys(count_for_load(state.arg()), 1);
+    const auto missing = random_keys(4096, 2);
+    const Map map = make_map(keys);
+
+    isize_t i = 0;
+    while (state.keep_running())
+    {
+        asl::benchmarking::do_not_optimize(map.get(missing[i]));
+        i = (i + 1) & 4095;
+    }
+}
+
+// Removes a key and inserts it back, so the load factor stays the same.
+ASL_BENCHMARK_ARGS(hash_map_erase_insert, 40, 55, 70)
+{
+    const auto keys = random_keys(count_for_load(state.arg()), 1);
+    Map map = make_map(keys);
+    const isize_t count = keys.size();
+
+    isize_t i = 0;
+    while (state.keep_running())
+    {
+        map.remove(keys[i]);
+        map.insert(keys[i], keys[i]);
+        i = i + 1 == count ? 0 : i + 1;
+    }
+    asl::benchmarking::do_not_optimize(map.size());
+}
+
+// Random hits in a table much bigger than the caches, where each lookup
+// misses on its tag, and on its value when it isn't stored next to it.
+template<asl::hash_set_layout kLayout>
+using LargeMap = asl::hash_map<
+    uint64_t,
+    uint32_t,
+    CountingAllocator,
+    asl::default_key_hasher<uint64_t>,
+    asl::default_key_comparator<uint64_t>,
+    kLayout>;
+
+static constexpr isize_t kLargeCount = 4 * 1024 * 1024;
+
+template<asl::hash_set_layout kLayout>
+static LargeMap<kLayout> make_large_map(const asl::buffer<uint64_t>& keys)
+{
+    LargeMap<kLayout> map;
+    for (const uint64_t key: keys)
+    {
+        map.insert(key, static_cast<uint32_t>(key));
+    }
+    return map;
+}
+
+template<asl::hash_set_layout kLayout>
+static void lookup_hit_large(asl::benchmarking::State& state)
+{
+    const auto keys = random_keys(kLargeCount, 1);
+    const auto map = make_large_map<kLayout>(keys);
+    const auto lookups = random_keys(64 * 1024, 3);
+
+    isize_t i = 0;
+    while (state.keep_running())
+    {
+        const uint64_t key = keys[static_cast<isize_t>(lookups[i] % static_cast<uint64_t>(keys.size()))];
+        asl::benchmarking::do_not_optimize(map.get(key));
+        i = (i + 1) & (64 * 1024 - 1);
+    }
+}
+
+ASL_BENCHMARK(hash_map_lookup_hit_large_split)
+{
+    lookup_hit_large<asl::hash_set_layout::kSplit>(state);
+}
+
+ASL_BENCHMARK(hash_map_lookup_hit_large_grouped)
+{
+    lookup_hit_large<asl::hash_set_layout::kGrouped>(state);
+}
+
+// Same lookups as hash_map_lookup_hit_large_grouped, in batches of
+// 1024 keys, so each iteration is 1024 lookups.
+ASL_BENCHMARK(hash_map_get_many_large_grouped)
+{
+    static constexpr isize_t kBatch = 1024;
+
+    const auto keys = random_keys(kLargeCount, 1);
+    const auto map = make_large_map<asl::hash_set_layout::kGrouped>(keys);
+
+    asl::buffer<uint64_t> lookups;
+    for (const uint64_t r: random_keys(64 * 1024, 3))
+    {
+        lookups.push(keys[static_cast<isize_t>(r % static_cast<uint64_t>(keys.size()))]);
+    }
+
+    const uint32_t* values[kBatch];
+
+    isize_t i = 0;
+    while (state.keep_running())
+    {
+        map.get_many(lookups.as_span().subspan(i, kBatch), values);
+        asl::benchmarking::do_not_optimize(values[0]);
+        i = (i + kBatch) & (64 * 1024 - 1);
+    }
+}
@@ -4,6 +4,8 @@
 
 #include "asl/testing/testing.hpp"
 #include "asl/containers/hash_map.hpp"
+#include "asl/strings/string.hpp"
+#include "asl/strings/string_view.hpp"
 
 // NOLINTNEXTLINE(*-complexity)
 ASL_TEST(default)
@@ -51,3 +53,178 @@ ASL_TEST(default)
     ASL_TEST_EXPECT(*map.get(46) == 460);
     ASL_TEST_EXPECT(map.get(47) == nullptr);
 }
+
+static isize_t g_string_allocations = 0; // NOLINT(*-non-const-global-variables)
+
+struct StringAllocator
+{
+    [[nodiscard]]
+    static void* alloc(const asl::layout& layout)
+    {
+        g_string_allocations += 1;
+        return asl::GlobalHeap::alloc(layout);
+    }
+
+    static void* realloc(void* ptr, const asl::layout& old, const asl::layout& new_layout)
+    {
+        g_string_allocations += 1;
+        return asl::GlobalHeap::realloc(ptr, old, new_layout);
+    }
+
+    static void dealloc(void* ptr, const asl::layout& layout)
+    {
+        asl::GlobalHeap::dealloc(ptr, layout);
+    }
+
+    constexpr bool operator==(const StringAllocator&) const { return true; }
+};
+static_assert(asl::allocator<StringAllocator>);
+
+ASL_TEST(string_view_lookup)
+{
+    ASL_TEST_EXPECT(asl::hash_value("Hello, world!"_sv) == asl::hash_value(asl::string<>{"Hello, world!"_sv}));
+
+    // Long enough not to fit in the string's inline storage.
+    const asl::string_view kKeyA = "The first key, which is quite long";
+    const asl::string_view kKeyB = "The second key, which is quite long";
+
+    asl::hash_map<asl::string<StringAllocator>, int> map;
+    map.insert(asl::string<StringAllocator>{kKeyA}, 1);
+    map.insert(asl::string<StringAllocator>{kKeyB}, 2);
+
+    const isize_t allocations = g_string_allocations;
+
+    ASL_TEST_EXPECT(map.contains(kKeyA));
+    ASL_TEST_EXPECT(!map.contains("Some other key which is also long"_sv));
+    ASL_TEST_EXPECT(*map.get(kKeyB) == 2);
+    ASL_TEST_EXPECT(map.get("Nope"_sv) == nullptr);
+
+    // Already present, so the key isn't converted to a string.
+    map.insert(kKeyA, 10);
+    ASL_TEST_EXPECT(*map.get(kKeyA) == 10);
+    ASL_TEST_EXPECT(map.size() == 2);
+
+    ASL_TEST_EXPECT(map.remove(kKeyA));
+    ASL_TEST_EXPECT(!map.contains(kKeyA));
+    ASL_TEST_EXPECT(map.size() == 1);
+
+    ASL_TEST_EXPECT(g_string_allocations == allocations);
+}
+
+template<template<typename> typename Hasher>
+static void check_hasher()
+{
+    asl::hash_map<uint64_t, int, asl::DefaultAllocator, Hasher<uint64_t>> map;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        map.insert(static_cast<uint64_t>(i) << 20U, i);
+    }
+
+    ASL_TEST_EXPECT(map.size() == 1000);
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASL_TEST_EXPECT(*map.get(static_cast<uint64_t>(i) << 20U) == i);
+    }
+    ASL_TEST_EXPECT(map.get(uint64_t{1}) == nullptr);
+
+    asl::hash_map<asl::string<>, int, asl::DefaultAllocator, Hasher<asl::string<>>> strings;
+    strings.insert(asl::string<>{"hello"_sv}, 1);
+    strings.insert(asl::string<>{"world"_sv}, 2);
+
+    ASL_TEST_EXPECT(*strings.get("hello"_sv) == 1);
+    ASL_TEST_EXPECT(*strings.get("world"_sv) == 2);
+    ASL_TEST_EXPECT(strings.get("nope"_sv) == nullptr);
+}
+
+ASL_TEST(seeded_and_keyed_hashers)
+{
+    check_hasher<asl::seeded_key_hasher>();
+    check_hasher<asl::keyed_key_hasher>();
+}
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(churn)
+{
+    static constexpr int kLive = 50;
+
+    asl::hash_map<int, int> map;
+
+    for (int i = 0; i < kLive; ++i)
+    {
+        map.insert(i, i * 2);
+    }
+
+    const isize_t capacity = map.capacity();
+
+    for (int i = kLive; i < kLive * 100; ++i)
+    {
+        ASL_TEST_EXPECT(map.remove(i - kLive));
+        map.insert(i, i * 2);
+        map.insert(i, i * 3);
+    }
+
+    ASL_TEST_EXPECT(map.size() == kLive);
+    ASL_TEST_EXPECT(map.capacity() == capacity);
+
+    for (int i = 0; i < kLive * 100; ++i)
+    {
+        const int* value = map.get(i);
+        if (i >= kLive * 99)
+        {
+            ASL_TEST_ASSERT(value != nullptr);
+            ASL_TEST_EXPECT(*value == i * 3);
+        }
+        else
+        {
+            ASL_TEST_EXPECT(value == nullptr);
+        }
+    }
+
+    map.shrink_to_fit();
+    ASL_TEST_EXPECT(map.size() == kLive);
+    ASL_TEST_EXPECT(*map.get(kLive * 99) == kLive * 99 * 3);
+}
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(get_many)
+{
+    asl::hash_map<int, int> map;
+
+    int keys[100]{};
+    int* values[100];
+
+    map.get_many(keys, values);
+    for (const int* value: values)
+    {
+        ASL_TEST_EXPECT(value == nullptr);
+    }
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        map.insert(i * 2, i);
+    }
+
+    for (int i = 0; i < 100; ++i)
+    {
+        keys[i] = i * 15; // NOLINT(*-constant-array-index)
+    }
+
+    map.get_many(keys, values);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        // NOLINTBEGIN(*-constant-array-index)
+        if (keys[i] % 2 == 0 && keys[i] < 2000)
+        {
+            ASL_TEST_ASSERT(values[i] != nullptr);
+            ASL_TEST_EXPECT(*values[i] == keys[i] / 2);
+            ASL_TEST_EXPECT(values[i] == map.get(keys[i]));
+        }
+        else
+        {
+            ASL_TEST_EXPECT(values[i] == nullptr);
+        }
+        // NOLINTEND(*-constant-array-index)
+    }
+}
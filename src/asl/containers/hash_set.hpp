@@ -7,11 +7,528 @@
 #include "asl/base/support.hpp"
 #include "asl/base/meta.hpp"
 #include "asl/base/bits.hpp"
+#include "asl/base/byte.hpp"
 #include "asl/base/numeric.hpp"
 #include "asl/base/memory_ops.hpp"
 #include "asl/allocator/allocator.hpp"
 #include "asl/types/maybe_uninit.hpp"
+#include "asl/types/span.hpp"
 #include "asl/hashing/hash.hpp"
+#include "asl/hashing/siphash.hpp"
+#include "asl/io/writer.hpp"
+
+#if defined(ASL_ARCH_X64)
+    #include <emmintrin.h>
+#endif
+
+namespace asl
+{
+
+enum class hash_set_layout : uint8_t
+{
+    // Tags and values in two separate arrays.
+    kSplit,
+
+    // Each group of tags is directly followed by its values.
+    kGrouped,
+};
+
+} // namespace asl
+
+namespace asl::hash_set_internal
+{
+
+static constexpr uint8_t kHasValue  = 0x80;
+static constexpr uint8_t kHashMask  = 0x7f;
+static constexpr uint8_t kEmpty     = 0x00;
+static constexpr uint8_t kTombstone = 0x01;
+
+// Set of slots within a group, as returned by the group matching
+// functions. Slot i is represented by bit (i << kShift).
+template<typename Mask, int kShift>
+class BitMask
+{
+    Mask m_mask;
+
+public:
+    explicit constexpr BitMask(Mask mask) : m_mask{mask} {}
+
+    [[nodiscard]] constexpr bool has_any() const { return m_mask != 0; }
+
+    [[nodiscard]] constexpr isize_t lowest() const
+    {
+        ASL_ASSERT(m_mask != 0);
+        return static_cast<isize_t>(__builtin_ctzll(m_mask)) >> kShift;
+    }
+
+    constexpr BitMask& operator++()
+    {
+        m_mask &= m_mask - 1;
+        return *this;
+    }
+
+    constexpr isize_t operator*() const { return lowest(); }
+
+    constexpr bool operator==(const BitMask&) const = default;
+
+    [[nodiscard]] constexpr BitMask begin() const { return *this; }
+    [[nodiscard]] constexpr BitMask end() const { return BitMask{0}; }
+};
+
+#if defined(ASL_ARCH_X64)
+
+// 16 tags at once with SSE2, which is always available on x64.
+class Group
+{
+    __m128i m_tags;
+
+public:
+    static constexpr isize_t kWidth = 16;
+
+    using Mask = BitMask<uint32_t, 0>;
+
+    explicit Group(const uint8_t* tags)
+        // NOLINTNEXTLINE(*-reinterpret-cast)
+        : m_tags{_mm_load_si128(reinterpret_cast<const __m128i*>(tags))}
+    {}
+
+    [[nodiscard]] Mask match(uint8_t tag) const
+    {
+        const __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(tag)), m_tags);
+        return Mask{static_cast<uint32_t>(_mm_movemask_epi8(cmp))};
+    }
+
+    [[nodiscard]] Mask match_empty() const
+    {
+        return match(kEmpty);
+    }
+
+    // Empty or tombstone, i.e. the high bit is not set.
+    [[nodiscard]] Mask match_available() const
+    {
+        return Mask{static_cast<uint32_t>(_mm_movemask_epi8(m_tags)) ^ 0xffffU};
+    }
+};
+
+#else
+
+// Portable fallback: 8 tags at once in a 64 bits integer, with the
+// result of each match in the high bit of the corresponding byte.
+class Group
+{
+    static constexpr uint64_t kLsbs = 0x0101'0101'0101'0101ULL;
+    static constexpr uint64_t kMsbs = 0x8080'8080'8080'8080ULL;
+
+    uint64_t m_tags{};
+
+public:
+    static constexpr isize_t kWidth = 8;
+
+    using Mask = BitMask<uint64_t, 3>;
+
+    explicit Group(const uint8_t* tags)
+    {
+        asl::memcpy(&m_tags, tags, sizeof(m_tags));
+    }
+
+    [[nodiscard]] Mask match(uint8_t tag) const
+    {
+        // Bytes equal to the tag become zero. Then a byte is zero if and only
+        // if neither its low 7 bits (detected with a carry into the high bit)
+        // nor its high bit are set. No carry can cross byte boundaries.
+        const uint64_t x = m_tags ^ (kLsbs * tag);
+        return Mask{~(((x & ~kMsbs) + ~kMsbs) | x) & kMsbs};
+    }
+
+    [[nodiscard]] Mask match_empty() const
+    {
+        // Empty and tombstone are the only values without the high bit,
+        // and they differ by their lowest bit, which we move to the high bit.
+        return Mask{~m_tags & ~(m_tags << 7U) & kMsbs};
+    }
+
+    // Empty or tombstone, i.e. the high bit is not set.
+    [[nodiscard]] Mask match_available() const
+    {
+        return Mask{~m_tags & kMsbs};
+    }
+};
+
+#endif
+
+constexpr isize_t group_count_mask(isize_t capacity)
+{
+    return (capacity / Group::kWidth) - 1;
+}
+
+constexpr isize_t starting_group(uint64_t hash, isize_t capacity)
+{
+    return static_cast<isize_t>(hash >> 7) & group_count_mask(capacity);
+}
+
+inline void write_zeros(Writer* writer, isize_t count)
+{
+    static constexpr std::byte kZeros[64]{};
+    while (count > 0)
+    {
+        const isize_t size = min<isize_t>(count, 64);
+        writer->write({kZeros, size});
+        count -= size;
+    }
+}
+
+// Values of a group as stored in an image. Slots without a value
+// are uninitialized memory, so zeros are written in their place.
+template<typename T>
+void write_group_values(Writer* writer, const uint8_t* tags, const maybe_uninit<T>* values)
+{
+    // NOLINTBEGIN(*-pointer-arithmetic)
+    for (isize_t i = 0; i < Group::kWidth; ++i)
+    {
+        if ((tags[i] & kHasValue) != 0)
+        {
+            writer->write(as_bytes(span<const T>{&values[i].as_init_unsafe(), 1}));
+        }
+        else
+        {
+            write_zeros(writer, sizeof(T));
+        }
+    }
+    // NOLINTEND(*-pointer-arithmetic)
+}
+
+// Tags and values in two separate arrays.
+template<typename T>
+class SplitStorage
+{
+    uint8_t*         m_tags{};
+    maybe_uninit<T>* m_values{};
+
+    static constexpr layout tags_layout(isize_t capacity)
+    {
+        // Aligned on the group width so that groups can be loaded with aligned loads.
+        return layout{ .size = capacity, .align = Group::kWidth };
+    }
+
+public:
+    template<allocator Allocator>
+    static SplitStorage allocate(Allocator& allocator, isize_t capacity)
+    {
+        SplitStorage storage;
+        storage.m_tags = static_cast<uint8_t*>(allocator.alloc(tags_layout(capacity)));
+        storage.m_values = static_cast<maybe_uninit<T>*>(allocator.alloc(layout::array<maybe_uninit<T>>(capacity)));
+        storage.clear_tags(capacity);
+        return storage;
+    }
+
+    template<allocator Allocator>
+    void deallocate(Allocator& allocator, isize_t capacity)
+    {
+        allocator.dealloc(m_tags, tags_layout(capacity));
+        allocator.dealloc(m_values, layout::array<maybe_uninit<T>>(capacity));
+        m_tags = nullptr;
+        m_values = nullptr;
+    }
+
+    void clear_tags(isize_t capacity) const
+    {
+        asl::memzero(m_tags, capacity);
+    }
+
+    // In an image, the tags are followed by the values.
+    static constexpr isize_t kImageAlign = max<isize_t>(Group::kWidth, alignof(T));
+
+    static constexpr isize_t image_values_offset(isize_t capacity)
+    {
+        return round_up_pow2<isize_t>(capacity, alignof(T));
+    }
+
+    static constexpr isize_t image_size(isize_t capacity)
+    {
+        return image_values_offset(capacity) + capacity * static_cast<isize_t>(sizeof(T));
+    }
+
+    void write_image(Writer* writer, isize_t capacity) const
+    {
+        // NOLINTNEXTLINE(*-reinterpret-cast)
+        writer->write({reinterpret_cast<const std::byte*>(m_tags), capacity});
+        write_zeros(writer, image_values_offset(capacity) - capacity);
+
+        for (isize_t group = 0; group < capacity / Group::kWidth; ++group)
+        {
+            write_group_values<T>(writer, group_tags(group), &value(group * Group::kWidth));
+        }
+    }
+
+    // The storage is only ever read through, which is why casting
+    // away the constness is fine.
+    static SplitStorage from_image(const std::byte* data, isize_t capacity)
+    {
+        SplitStorage storage;
+        // NOLINTBEGIN(*-reinterpret-cast,*-const-cast,*-pointer-arithmetic)
+        storage.m_tags = reinterpret_cast<uint8_t*>(const_cast<std::byte*>(data));
+        storage.m_values = reinterpret_cast<maybe_uninit<T>*>(const_cast<std::byte*>(data + image_values_offset(capacity)));
+        // NOLINTEND(*-reinterpret-cast,*-const-cast,*-pointer-arithmetic)
+        return storage;
+    }
+
+    // NOLINTBEGIN(*-pointer-arithmetic)
+
+    [[nodiscard]] uint8_t* group_tags(isize_t group) const
+    {
+        return m_tags + group * Group::kWidth;
+    }
+
+    [[nodiscard]] uint8_t& tag(isize_t index) const
+    {
+        return m_tags[index];
+    }
+
+    [[nodiscard]] maybe_uninit<T>& value(isize_t index) const
+    {
+        return m_values[index];
+    }
+
+    // Tags of the group and its first value, where a lookup
+    // that hits in the first group is likely to end.
+    void prefetch(isize_t group) const
+    {
+        __builtin_prefetch(m_tags + group * Group::kWidth);
+        __builtin_prefetch(m_values + group * Group::kWidth);
+    }
+
+    // NOLINTEND(*-pointer-arithmetic)
+};
+
+// A single array of groups, each made of its tags followed by its values,
+// so that looking up a value touches memory close to its tag, often the
+// same cache line, and a table is a single allocation.
+template<typename T>
+class GroupedStorage
+{
+    // Values offset is also the alignment of groups, so that groups can
+    // be loaded with aligned loads, and values are properly aligned.
+    static constexpr isize_t kValuesOffset = max<isize_t>(Group::kWidth, alignof(T));
+    static constexpr isize_t kGroupSize = round_up_pow2<isize_t>(
+        kValuesOffset + Group::kWidth * static_cast<isize_t>(sizeof(T)),
+        kValuesOffset);
+
+    std::byte* m_groups{};
+
+    static constexpr layout groups_layout(isize_t capacity)
+    {
+        return layout{ .size = capacity / Group::kWidth * kGroupSize, .align = kValuesOffset };
+    }
+
+public:
+    template<allocator Allocator>
+    static GroupedStorage allocate(Allocator& allocator, isize_t capacity)
+    {
+        GroupedStorage storage;
+        storage.m_groups = static_cast<std::byte*>(allocator.alloc(groups_layout(capacity)));
+        storage.clear_tags(capacity);
+        return storage;
+    }
+
+    template<allocator Allocator>
+    void deallocate(Allocator& allocator, isize_t capacity)
+    {
+        allocator.dealloc(m_groups, groups_layout(capacity));
+        m_groups = nullptr;
+    }
+
+    void clear_tags(isize_t capacity) const
+    {
+        for (isize_t group = 0; group < capacity / Group::kWidth; ++group)
+        {
+            asl::memzero(group_tags(group), Group::kWidth);
+        }
+    }
+
+    // An image is the array of groups as it is in memory.
+    static constexpr isize_t kImageAlign = kValuesOffset;
+
+    static constexpr isize_t image_size(isize_t capacity)
+    {
+        return groups_layout(capacity).size;
+    }
+
+    void write_image(Writer* writer, isize_t capacity) const
+    {
+        static constexpr isize_t kValuesSize = Group::kWidth * static_cast<isize_t>(sizeof(T));
+
+        for (isize_t group = 0; group < capacity / Group::kWidth; ++group)
+        {
+            // NOLINTNEXTLINE(*-reinterpret-cast)
+            writer->write({reinterpret_cast<const std::byte*>(group_tags(group)), Group::kWidth});
+            write_zeros(writer, kValuesOffset - Group::kWidth);
+            write_group_values<T>(writer, group_tags(group), &value(group * Group::kWidth));
+            write_zeros(writer, kGroupSize - kValuesOffset - kValuesSize);
+        }
+    }
+
+    // The storage is only ever read through, which is why casting
+    // away the constness is fine.
+    static GroupedStorage from_image(const std::byte* data, isize_t /* capacity */)
+    {
+        GroupedStorage storage;
+        storage.m_groups = const_cast<std::byte*>(data); // NOLINT(*-const-cast)
+        return storage;
+    }
+
+    // NOLINTBEGIN(*-pointer-arithmetic,*-reinterpret-cast)
+
+    [[nodiscard]] uint8_t* group_tags(isize_t group) const
+    {
+        return reinterpret_cast<uint8_t*>(m_groups + group * kGroupSize);
+    }
+
+    [[nodiscard]] uint8_t& tag(isize_t index) const
+    {
+        return group_tags(index / Group::kWidth)[index % Group::kWidth];
+    }
+
+    [[nodiscard]] maybe_uninit<T>& value(isize_t index) const
+    {
+        std::byte* values = m_groups + (index / Group::kWidth) * kGroupSize + kValuesOffset;
+        return reinterpret_cast<maybe_uninit<T>*>(values)[index % Group::kWidth];
+    }
+
+    // Tags of the group, which share their cache line with the first values.
+    void prefetch(isize_t group) const
+    {
+        __builtin_prefetch(m_groups + group * kGroupSize);
+    }
+
+    // NOLINTEND(*-pointer-arithmetic,*-reinterpret-cast)
+};
+
+template<typename T, hash_set_layout Layout>
+using StorageFor = conditional_t<
+    Layout == hash_set_layout::kGrouped,
+    GroupedStorage<T>,
+    SplitStorage<T>>;
+
+// Start of an image written by hash_set::write_image. The storage follows
+// at storage_offset, and only offsets are stored, so an image can be
+// loaded at any address.
+//
+// Everything that lookups depend on is recorded, so that an image from a
+// different kind of set, or from a build with a different group width,
+// is rejected instead of misread. Since the hash function isn't stored,
+// hash_check is the hash of one of the values, if there are any, which
+// catches a change of hash function. seed identifies the seed of seeded
+// and keyed hashers, so that an image is rejected by other processes
+// even when it's empty.
+struct ImageHeader
+{
+    static constexpr uint32_t kMagic = 0x484c'5341; // "ASLH" in little endian
+    static constexpr uint32_t kVersion = 2;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t layout;
+    uint32_t group_width;
+    uint32_t value_size;
+    uint32_t value_align;
+    int64_t  capacity;
+    int64_t  size;
+    uint64_t hash_check;
+    uint64_t seed;
+    int64_t  storage_offset;
+    int64_t  storage_size;
+};
+
+// KeyHasher::seed_fingerprint() when the hasher has a seed, 0 otherwise.
+template<typename KeyHasher>
+constexpr uint64_t key_hasher_seed()
+{
+    if constexpr (requires { { KeyHasher::seed_fingerprint() } -> same_as<uint64_t>; })
+    {
+        return KeyHasher::seed_fingerprint();
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+template<typename KeyComparator, typename Storage, typename U>
+isize_t find_slot_lookup(const Storage& storage, isize_t capacity, const U& value, uint64_t hash)
+{
+    ASL_ASSERT(is_pow2(capacity) && capacity >= Group::kWidth);
+
+    const uint8_t tag = static_cast<uint8_t>(hash & kHashMask) | kHasValue;
+    const isize_t group_mask = group_count_mask(capacity);
+    isize_t group = starting_group(hash, capacity);
+
+    for (isize_t probed = 0; probed <= group_mask; ++probed)
+    {
+        const isize_t base = group * Group::kWidth;
+        const Group g{storage.group_tags(group)};
+
+        for (const isize_t i: g.match(tag))
+        {
+            if (KeyComparator::eq(storage.value(base + i).as_init_unsafe(), value))
+            {
+                return base + i;
+            }
+        }
+
+        if (g.match_empty().has_any()) { break; }
+
+        group = (group + 1) & group_mask;
+    }
+
+    return -1;
+}
+
+// Looks up a batch of values, and calls callback(index in values, slot)
+// for each of them, with a negative slot when it's missing. All hashes
+// of a batch are computed and their first group prefetched before
+// probing, so that the cache misses of independent lookups overlap
+// instead of being paid one after the other.
+template<typename KeyHasher, typename KeyComparator, typename Storage, typename U, typename Callback>
+void find_slots_lookup(
+    const Storage& storage,
+    isize_t capacity,
+    isize_t size,
+    span<const U> values,
+    const Callback& callback)
+{
+    static constexpr isize_t kBatchSize = 16;
+
+    if (size <= 0)
+    {
+        for (isize_t i = 0; i < values.size(); ++i)
+        {
+            callback(i, isize_t{-1});
+        }
+        return;
+    }
+
+    uint64_t hashes[kBatchSize];
+
+    // NOLINTBEGIN(*-constant-array-index)
+    for (isize_t begin = 0; begin < values.size(); begin += kBatchSize)
+    {
+        const isize_t count = min(kBatchSize, values.size() - begin);
+
+        for (isize_t i = 0; i < count; ++i)
+        {
+            hashes[i] = KeyHasher::hash(values[begin + i]);
+            storage.prefetch(starting_group(hashes[i], capacity));
+        }
+
+        for (isize_t i = 0; i < count; ++i)
+        {
+            callback(begin + i, find_slot_lookup<KeyComparator>(storage, capacity, values[begin + i], hashes[i]));
+        }
+    }
+    // NOLINTEND(*-constant-array-index)
+}
+
+} // namespace asl::hash_set_internal
 
 namespace asl
 {
@@ -29,6 +546,64 @@ struct default_key_hasher
     {
         return hash_value(value);
     }
+
+    template<typename U>
+    requires transparent_key_for<U, T> && hashable<U>
+    constexpr static uint64_t hash(const U& value)
+    {
+        return hash_value(value);
+    }
+};
+
+// Same as default_key_hasher, but seeded with a random value drawn once per
+// process, so the hashes of keys, and the probe sequences they go through,
+// differ from one run to the next. As fast as default_key_hasher.
+template<hashable T>
+struct seeded_key_hasher
+{
+    static uint64_t hash(const T& value)
+    {
+        return seeded_hash_value(value, process_hash_seed());
+    }
+
+    // Recorded in images instead of the seed itself.
+    static uint64_t seed_fingerprint()
+    {
+        return seeded_hash_value(uint64_t{0}, process_hash_seed());
+    }
+
+    template<typename U>
+    requires transparent_key_for<U, T> && hashable<U>
+    static uint64_t hash(const U& value)
+    {
+        return seeded_hash_value(value, process_hash_seed());
+    }
+};
+
+// SipHash keyed with a random key drawn once per process. Slower than the
+// other hashers, but even an attacker who can see the hashes or time the
+// lookups can't choose keys which collide, and push the table into long
+// probe sequences. Meant for tables whose keys come from untrusted input.
+template<siphashable T>
+struct keyed_key_hasher
+{
+    static uint64_t hash(const T& value)
+    {
+        return siphash_value(value, process_siphash_key());
+    }
+
+    // Recorded in images instead of the key, which must stay secret.
+    static uint64_t seed_fingerprint()
+    {
+        return siphash_value(uint64_t{0}, process_siphash_key());
+    }
+
+    template<typename U>
+    requires transparent_key_for<U, T> && siphashable<U>
+    static uint64_t hash(const U& value)
+    {
+        return siphash_value(value, process_siphash_key());
+    }
 };
 
 template<typename C, typename U, typename V = U>
@@ -44,32 +619,54 @@ struct default_key_comparator
     {
         return a == b;
     }
+
+    template<typename U>
+    requires transparent_key_for<U, T> && weakly_equality_comparable_with<T, U>
+    constexpr static bool eq(const T& a, const U& b)
+    {
+        return a == b;
+    }
 };
 
+// Values up to 16 bytes are at most a few cache lines away from their
+// tag with the grouped layout. Bigger ones don't gain much from it, and
+// waste more memory in empty slots next to the tags.
+template<typename T>
+static constexpr hash_set_layout default_hash_set_layout =
+    sizeof(T) <= 16 ? hash_set_layout::kGrouped : hash_set_layout::kSplit;
+
 template<
     is_object T,
     allocator Allocator = DefaultAllocator,
     key_hasher<T> KeyHasher = default_key_hasher<T>,
-    key_comparator<T> KeyComparator = default_key_comparator<T>
+    key_comparator<T> KeyComparator = default_key_comparator<T>,
+    hash_set_layout Layout = default_hash_set_layout<T>
 >
 requires movable<T>
 class hash_set
 {
 protected:
-    static constexpr uint8_t kHasValue  = 0x80;
-    static constexpr uint8_t kHashMask  = 0x7f;
-    static constexpr uint8_t kEmpty     = 0x00;
-    static constexpr uint8_t kTombstone = 0x01;
+    using Group = hash_set_internal::Group;
+
+    using Storage = hash_set_internal::StorageFor<T, Layout>;
 
-    static constexpr isize_t kMinCapacity = 8;
+    static constexpr uint8_t kHasValue  = hash_set_internal::kHasValue;
+    static constexpr uint8_t kHashMask  = hash_set_internal::kHashMask;
+    static constexpr uint8_t kEmpty     = hash_set_internal::kEmpty;
+    static constexpr uint8_t kTombstone = hash_set_internal::kTombstone;
+
+    // Tags are probed one group at a time, so the capacity
+    // has to be a multiple of the group width.
+    static constexpr isize_t kMinCapacity = max<isize_t>(8, Group::kWidth);
 
     // Important so we can memzero the tags
     static_assert(kEmpty == 0);
+    static_assert(kMinCapacity % Group::kWidth == 0);
 
-    uint8_t*         m_tags{};
-    maybe_uninit<T>* m_values{};
-    isize_t          m_capacity{};
-    isize_t          m_size{};
+    Storage m_storage{};
+    isize_t m_capacity{};
+    isize_t m_size{};
+    isize_t m_tombstones{};
 
     ASL_NO_UNIQUE_ADDRESS Allocator m_allocator;
 
@@ -87,82 +684,174 @@ protected:
             static_cast<isize_t>(bit_ceil((static_cast<uint64_t>(size) * 4 + 2) / 3)));
     }
 
-    static void insert_inner(
-        T&& value,
-        uint8_t* tags,
-        maybe_uninit<T>* values,
-        isize_t capacity,
-        isize_t* size)
+    // Number of groups between the start of the probe sequence of a hash
+    // and the group of a slot.
+    static constexpr isize_t probe_distance(isize_t index, uint64_t hash, isize_t capacity)
+    {
+        const isize_t start = hash_set_internal::starting_group(hash, capacity);
+        return ((index / Group::kWidth) - start) & hash_set_internal::group_count_mask(capacity);
+    }
+
+    // First empty or tombstone slot in the probe sequence of a hash,
+    // which is where a value that isn't in the set yet goes.
+    static isize_t find_first_available(const Storage& storage, uint64_t hash, isize_t capacity)
+    {
+        const isize_t group_mask = hash_set_internal::group_count_mask(capacity);
+        isize_t group = hash_set_internal::starting_group(hash, capacity);
+
+        for (isize_t probed = 0; probed <= group_mask; ++probed)
+        {
+            const isize_t base = group * Group::kWidth;
+            const auto available = Group{storage.group_tags(group)}.match_available();
+            if (available.has_any())
+            {
+                return base + available.lowest();
+            }
+
+            group = (group + 1) & group_mask;
+        }
+
+        // The load factor guarantees that there is always an available slot.
+        ASL_ASSERT(false);
+        return -1;
+    }
+
+    // Stores a tag in an available slot, reusing a tombstone if there was one.
+    void fill_slot(isize_t index, uint8_t tag)
+    {
+        ASL_ASSERT((m_storage.tag(index) & kHasValue) == 0);
+        if (m_storage.tag(index) == kTombstone)
+        {
+            m_tombstones -= 1;
+        }
+        m_storage.tag(index) = tag;
+    }
+
+    // Marks a slot whose value was just destroyed or moved out as available.
+    void erase_slot(isize_t index)
     {
-        ASL_ASSERT(*size < capacity);
+        ASL_ASSERT((m_storage.tag(index) & kHasValue) != 0);
+
+        // Values only fill available slots, and only a rehash turns a
+        // tombstone back into an empty slot, so a group that still has an
+        // empty slot has never been full. No probe sequence ever went past
+        // it, and the slot can become empty again instead of a tombstone.
+        if (Group{m_storage.group_tags(index / Group::kWidth)}.match_empty().has_any())
+        {
+            m_storage.tag(index) = kEmpty;
+        }
+        else
+        {
+            m_storage.tag(index) = kTombstone;
+            m_tombstones += 1;
+        }
+    }
 
-        const auto result = find_slot_insert(value, tags, values, capacity);
+    void insert_inner(T&& value)
+    {
+        ASL_ASSERT(m_size + m_tombstones < m_capacity);
 
-        // NOLINTBEGIN(*-pointer-arithmetic)
+        const auto result = find_slot_insert(value);
 
         ASL_ASSERT(result.first_available_index >= 0);
 
         if (result.already_present_index != result.first_available_index)
         {
-            ASL_ASSERT((tags[result.first_available_index] & kHasValue) == 0);
+            m_storage.value(result.first_available_index).construct_unsafe(std::move(value));
+            fill_slot(result.first_available_index, result.tag);
+
             if (result.already_present_index >= 0)
             {
-                ASL_ASSERT((tags[result.already_present_index] & kHasValue) != 0);
-                values[result.already_present_index].destroy_unsafe();
-                tags[result.already_present_index] = kTombstone;
+                m_storage.value(result.already_present_index).destroy_unsafe();
+                erase_slot(result.already_present_index);
             }
             else
             {
-                *size += 1;
+                m_size += 1;
             }
-
-            values[result.first_available_index].construct_unsafe(std::move(value));
-            tags[result.first_available_index] = result.tag;
         }
-
-        // NOLINTEND(*-pointer-arithmetic)
     }
 
-    void grow_and_rehash()
+    // Moves all values to new arrays of the given capacity, which
+    // leaves no tombstones behind.
+    void resize(isize_t new_capacity)
     {
-        grow_and_rehash(max(kMinCapacity, m_capacity * 2));
-    }
-
-    void grow_and_rehash(isize_t new_capacity)
-    {
-        ASL_ASSERT(new_capacity >= kMinCapacity && is_pow2(new_capacity) && new_capacity > m_capacity);
+        ASL_ASSERT(new_capacity >= kMinCapacity && is_pow2(new_capacity));
+        ASL_ASSERT((new_capacity >> 1) + (new_capacity >> 2) >= m_size); // NOLINT(*-signed-bitwise)
 
-        auto* new_tags = static_cast<uint8_t*>(m_allocator.alloc(layout::array<uint8_t>(new_capacity)));
-        auto* new_values = static_cast<maybe_uninit<T>*>(m_allocator.alloc(layout::array<maybe_uninit<T>>(new_capacity)));
-        asl::memzero(new_tags, new_capacity);
-
-        isize_t new_size = 0;
+        const Storage new_storage = Storage::allocate(m_allocator, new_capacity);
+        const isize_t size = m_size;
 
         if (m_size > 0)
         {
-            // NOLINTBEGIN(*-pointer-arithmetic)
             for (isize_t i = 0; i < m_capacity; ++i)
             {
-                if ((m_tags[i] & kHasValue) == 0) { continue; }
+                if ((m_storage.tag(i) & kHasValue) == 0) { continue; }
+
+                // Values are unique and the new table has no tombstones,
+                // so there is no need to compare anything.
+                const uint64_t hash = KeyHasher::hash(m_storage.value(i).as_init_unsafe());
+                const isize_t index = find_first_available(new_storage, hash, new_capacity);
 
-                insert_inner(std::move(m_values[i].as_init_unsafe()), new_tags, new_values, new_capacity, &new_size);
+                new_storage.value(index).relocate_unsafe(m_storage.value(i));
+                new_storage.tag(index) = m_storage.tag(i);
 
-                // Destroy now so that destroy() has less things to do
-                m_values[i].destroy_unsafe();
-                m_tags[i] = kTombstone;
+                // Mark as empty now so that destroy() has less things to do
+                m_storage.tag(i) = kEmpty;
             }
-            // NOLINTEND(*-pointer-arithmetic)
         }
 
-        ASL_ASSERT(new_size == m_size);
-
         m_size = 0;
         destroy();
 
-        m_tags = new_tags;
-        m_values = new_values;
+        m_storage = new_storage;
         m_capacity = new_capacity;
-        m_size = new_size;
+        m_size = size;
+    }
+
+    // Rehashes without reallocating, turning all tombstones back into
+    // empty slots. Values are first all marked with kTombstone, meaning
+    // "not placed yet", then each one is moved to the first available slot
+    // of its probe sequence, swapping it with any value not placed yet
+    // which is in the way.
+    void rehash_in_place()
+    {
+        if (m_capacity == 0) { return; }
+
+        for (isize_t i = 0; i < m_capacity; ++i)
+        {
+            m_storage.tag(i) = (m_storage.tag(i) & kHasValue) != 0 ? kTombstone : kEmpty;
+        }
+        m_tombstones = 0;
+
+        for (isize_t i = 0; i < m_capacity; ++i)
+        {
+            if (m_storage.tag(i) != kTombstone) { continue; }
+
+            const uint64_t hash = KeyHasher::hash(m_storage.value(i).as_init_unsafe());
+            const uint8_t tag = static_cast<uint8_t>(hash & kHashMask) | kHasValue;
+            const isize_t target = find_first_available(m_storage, hash, m_capacity);
+
+            if (probe_distance(i, hash, m_capacity) == probe_distance(target, hash, m_capacity))
+            {
+                // Already in the right group.
+                m_storage.tag(i) = tag;
+            }
+            else if (m_storage.tag(target) == kEmpty)
+            {
+                m_storage.value(target).relocate_unsafe(m_storage.value(i));
+                m_storage.tag(target) = tag;
+                m_storage.tag(i) = kEmpty;
+            }
+            else
+            {
+                // The target holds a value not placed yet, which we swap
+                // with this one, and then place in the next iteration.
+                std::swap(m_storage.value(target).as_init_unsafe(), m_storage.value(i).as_init_unsafe());
+                m_storage.tag(target) = tag;
+                i -= 1;
+            }
+        }
     }
 
     void clear_values()
@@ -173,9 +862,9 @@ protected:
             {
                 for (isize_t i = 0; i < m_capacity; ++i)
                 {
-                    if ((m_tags[i] & kHasValue) != 0) // NOLINT(*-pointer-arithmetic)
+                    if ((m_storage.tag(i) & kHasValue) != 0)
                     {
-                        m_values[i].destroy_unsafe(); // NOLINT(*-pointer-arithmetic)
+                        m_storage.value(i).destroy_unsafe();
                     }
                 }
             }
@@ -189,15 +878,15 @@ protected:
             isize_t min_capacity = size_to_capacity(other.size());
             if (m_capacity < min_capacity)
             {
-                grow_and_rehash(min_capacity);
+                resize(min_capacity);
             }
             ASL_ASSERT(m_capacity >= min_capacity);
 
             for (isize_t i = 0; i < other.m_capacity; ++i)
             {
-                if ((other.m_tags[i] & kHasValue) != 0) // NOLINT(*-pointer-arithmetic)
+                if ((other.m_storage.tag(i) & kHasValue) != 0)
                 {
-                    insert(other.m_values[i].as_init_unsafe()); // NOLINT(*-pointer-arithmetic)
+                    insert(other.m_storage.value(i).as_init_unsafe());
                 }
             }
         }
@@ -212,50 +901,53 @@ protected:
 
     template<typename U>
     requires key_hasher<KeyHasher, U> && key_comparator<KeyComparator, T, U>
-    static FindSlotResult find_slot_insert(
-        const U& value,
-        const uint8_t* tags,
-        const maybe_uninit<T>* values,
-        isize_t capacity)
+    FindSlotResult find_slot_insert(const U& value) const
     {
-        ASL_ASSERT(is_pow2(capacity));
+        ASL_ASSERT(is_pow2(m_capacity) && m_capacity >= Group::kWidth);
 
         FindSlotResult result{};
 
-        const isize_t capacity_mask = capacity - 1;
         const uint64_t hash = KeyHasher::hash(value);
-        const auto starting_index = static_cast<isize_t>(hash >> 7) & capacity_mask;
+        const isize_t group_mask = hash_set_internal::group_count_mask(m_capacity);
+        isize_t group = hash_set_internal::starting_group(hash, m_capacity);
 
         result.tag = static_cast<uint8_t>(hash & kHashMask) | kHasValue;
 
-        // NOLINTBEGIN(*-pointer-arithmetic)
-        for (
-            isize_t i = starting_index;
-            i != starting_index || result.first_available_index < 0;
-            i = (i + 1) & capacity_mask)
+        // Slots are probed one group at a time, and within a group, in any
+        // order. An element always lands in the first group of its probe
+        // sequence with an available slot, so the probe can stop at the first
+        // group with an empty slot.
+        for (isize_t probed = 0; probed <= group_mask; ++probed)
         {
-            uint8_t t = tags[i];
+            const isize_t base = group * Group::kWidth;
+            const Group g{m_storage.group_tags(group)};
 
-            if ((t & kHasValue) == 0 && result.first_available_index < 0)
+            for (const isize_t i: g.match(result.tag))
             {
-                result.first_available_index = i;
+                if (KeyComparator::eq(m_storage.value(base + i).as_init_unsafe(), value))
+                {
+                    result.already_present_index = base + i;
+                    if (result.first_available_index < 0)
+                    {
+                        result.first_available_index = base + i;
+                    }
+                    return result;
+                }
             }
 
-            if (t == result.tag && KeyComparator::eq(values[i].as_init_unsafe(), value))
+            if (result.first_available_index < 0)
             {
-                ASL_ASSERT(result.already_present_index < 0);
-                result.already_present_index = i;
-                if (result.first_available_index < 0)
+                const auto available = g.match_available();
+                if (available.has_any())
                 {
-                    result.first_available_index = i;
+                    result.first_available_index = base + available.lowest();
                 }
-                break;
             }
 
-            if (t == kEmpty) { break; }
-        }
+            if (g.match_empty().has_any()) { break; }
 
-        // NOLINTEND(*-pointer-arithmetic)
+            group = (group + 1) & group_mask;
+        }
 
         return result;
     }
@@ -266,43 +958,40 @@ protected:
     {
         if (m_size <= 0) { return -1; };
 
-        ASL_ASSERT(is_pow2(m_capacity));
-
-        const isize_t capacity_mask = m_capacity - 1;
-        const uint64_t hash = KeyHasher::hash(value);
-        const uint8_t tag = static_cast<uint8_t>(hash & kHashMask) | kHasValue;
-        const auto starting_index = static_cast<isize_t>(hash >> 7) & capacity_mask;
-
-        // NOLINTBEGIN(*-pointer-arithmetic)
-
-        isize_t i = starting_index;
-        do
-        {
-            const uint8_t t = m_tags[i];
-
-            if (t == tag && KeyComparator::eq(m_values[i].as_init_unsafe(), value)) { return i; }
-            if (t == kEmpty) { break; }
-
-            i = (i + 1) & capacity_mask;
-        } while (i != starting_index);
-
-        // NOLINTEND(*-pointer-arithmetic)
-
-        return -1;
+        return find_slot_lookup(value, KeyHasher::hash(value));
     }
 
     template<typename U>
+    requires key_comparator<KeyComparator, T, U>
+    isize_t find_slot_lookup(const U& value, uint64_t hash) const
+    {
+        return hash_set_internal::find_slot_lookup<KeyComparator>(m_storage, m_capacity, value, hash);
+    }
+
+    // Calls callback(index in values, slot) for each value, with a
+    // negative slot when it's missing.
+    template<typename U, typename Callback>
     requires key_hasher<KeyHasher, U> && key_comparator<KeyComparator, T, U>
-    FindSlotResult find_slot_insert(const U& value)
+    void find_slots_lookup(span<const U> values, const Callback& callback) const
     {
-        return find_slot_insert(value, m_tags, m_values, m_capacity);
+        hash_set_internal::find_slots_lookup<KeyHasher, KeyComparator>(
+            m_storage, m_capacity, m_size, values, callback);
     }
 
     void maybe_grow_to_fit_one_more()
     {
-        if (m_size >= max_size())
+        if (m_size + m_tombstones >= max_size())
         {
-            grow_and_rehash();
+            // When most of the load is tombstones, clearing them is enough
+            // to make room, and the capacity stays the same.
+            if (m_size < max_size() / 2)
+            {
+                rehash_in_place();
+            }
+            else
+            {
+                resize(max(kMinCapacity, m_capacity * 2));
+            }
         }
     }
 
@@ -335,10 +1024,10 @@ public:
 
     hash_set(hash_set&& other)
         requires move_constructible<Allocator>
-        : m_tags{std::exchange(other.m_tags, nullptr)}
-        , m_values{std::exchange(other.m_values, nullptr)}
+        : m_storage{std::exchange(other.m_storage, {})}
         , m_capacity{std::exchange(other.m_capacity, 0)}
         , m_size{std::exchange(other.m_size, 0)}
+        , m_tombstones{std::exchange(other.m_tombstones, 0)}
         , m_allocator{std::move(other.m_allocator)}
     {}
 
@@ -347,10 +1036,10 @@ public:
         if (&other != this)
         {
             destroy();
-            m_tags = std::exchange(other.m_tags, nullptr);
-            m_values = std::exchange(other.m_values, nullptr);
+            m_storage = std::exchange(other.m_storage, {});
             m_capacity = std::exchange(other.m_capacity, 0);
             m_size = std::exchange(other.m_size, 0);
+            m_tombstones = std::exchange(other.m_tombstones, 0);
             m_allocator = std::move(other.m_allocator);
         }
         return *this;
@@ -365,11 +1054,11 @@ public:
     {
         clear_values();
         m_size = 0;
+        m_tombstones = 0;
 
         if (m_capacity > 0)
         {
-            m_allocator.dealloc(m_tags, layout::array<uint8_t>(m_capacity));
-            m_allocator.dealloc(m_values, layout::array<maybe_uninit<T>>(m_capacity));
+            m_storage.deallocate(m_allocator, m_capacity);
             m_capacity = 0;
         }
     }
@@ -378,10 +1067,11 @@ public:
     {
         clear_values();
         m_size = 0;
+        m_tombstones = 0;
 
         if (m_capacity > 0)
         {
-            asl::memzero(m_tags, m_capacity);
+            m_storage.clear_tags(m_capacity);
         }
     }
 
@@ -389,13 +1079,42 @@ public:
 
     [[nodiscard]] constexpr bool is_empty() const { return m_size == 0; }
 
+    [[nodiscard]] constexpr isize_t capacity() const { return m_capacity; }
+
+    // Rehashes into the smallest capacity that holds max(min_size, size())
+    // values, which gets rid of all tombstones. The memory is freed when
+    // both are zero.
+    void rehash(isize_t min_size)
+    {
+        ASL_ASSERT(min_size >= 0);
+
+        const isize_t size = max(min_size, m_size);
+        if (size == 0)
+        {
+            destroy();
+        }
+        else if (const isize_t new_capacity = size_to_capacity(size); new_capacity == m_capacity)
+        {
+            rehash_in_place();
+        }
+        else
+        {
+            resize(new_capacity);
+        }
+    }
+
+    void shrink_to_fit()
+    {
+        rehash(0);
+    }
+
     template<typename... Args>
     void insert(Args&&... args)
         requires constructible_from<T, Args&&...>
     {
         maybe_grow_to_fit_one_more();
-        ASL_ASSERT(m_size < max_size());
-        insert_inner(T{std::forward<Args>(args)...}, m_tags, m_values, m_capacity, &m_size);
+        ASL_ASSERT(m_size + m_tombstones < max_size());
+        insert_inner(T{std::forward<Args>(args)...});
     }
 
     template<typename U>
@@ -405,6 +1124,17 @@ public:
         return find_slot_lookup(value) >= 0;
     }
 
+    // Looks up many values at once, much faster than one by one when the
+    // set doesn't fit in the cache. out[i] is set to the element equal to
+    // values[i], or nullptr when there is none.
+    void get_many(span<const T> values, span<const T*> out) const
+    {
+        ASL_ASSERT(values.size() == out.size());
+        find_slots_lookup(values, [&](isize_t i, isize_t slot) {
+            out[i] = slot >= 0 ? &m_storage.value(slot).as_init_unsafe() : nullptr;
+        });
+    }
+
     template<typename U>
     requires key_hasher<KeyHasher, U> && key_comparator<KeyComparator, T, U>
     bool remove(const U& value)
@@ -412,12 +1142,56 @@ public:
         isize_t slot = find_slot_lookup(value);
         if (slot < 0) { return false; }
 
-        m_values[slot].destroy_unsafe(); // NOLINT(*-pointer-arithmetic)
-        m_tags[slot] = kTombstone; // NOLINT(*-pointer-arithmetic)
+        m_storage.value(slot).destroy_unsafe();
+        erase_slot(slot);
         m_size -= 1;
 
         return true;
     }
+
+    // Writes the whole table, as it is in memory, so that it can later be
+    // looked up in place with a hash_set_view, for example from a mapped
+    // file. The image has to be loaded at an address aligned on
+    // max(alignof(T), 16), and only on a machine of the same architecture.
+    void write_image(Writer* writer) const
+        requires is_trivially_copyable<T>
+    {
+        using hash_set_internal::ImageHeader;
+
+        const isize_t storage_offset = round_up_pow2<isize_t>(static_cast<isize_t>(sizeof(ImageHeader)), Storage::kImageAlign);
+
+        ImageHeader header{
+            .magic = ImageHeader::kMagic,
+            .version = ImageHeader::kVersion,
+            .layout = static_cast<uint32_t>(Layout),
+            .group_width = static_cast<uint32_t>(Group::kWidth),
+            .value_size = static_cast<uint32_t>(sizeof(T)),
+            .value_align = static_cast<uint32_t>(alignof(T)),
+            .capacity = m_capacity,
+            .size = m_size,
+            .hash_check = 0,
+            .seed = hash_set_internal::key_hasher_seed<KeyHasher>(),
+            .storage_offset = storage_offset,
+            .storage_size = m_capacity > 0 ? Storage::image_size(m_capacity) : 0,
+        };
+
+        for (isize_t i = 0; i < m_capacity; ++i)
+        {
+            if ((m_storage.tag(i) & kHasValue) != 0)
+            {
+                header.hash_check = KeyHasher::hash(m_storage.value(i).as_init_unsafe());
+                break;
+            }
+        }
+
+        writer->write(as_bytes(span<const ImageHeader>{&header, 1}));
+        hash_set_internal::write_zeros(writer, storage_offset - static_cast<isize_t>(sizeof(ImageHeader)));
+
+        if (m_capacity > 0)
+        {
+            m_storage.write_image(writer, m_capacity);
+        }
+    }
 };
 
 } // namespace asl
@@ -188,3 +188,229 @@ ASL_TEST(move)
     }
 }
 
+struct CollidingHasher
+{
+    // Same tag and same starting group for everyone, so
+    // that probing has to go through several groups.
+    static uint64_t hash(int) { return 0x2a; }
+};
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(collisions)
+{
+    static constexpr int kCount = 100;
+
+    asl::hash_set<int, asl::DefaultAllocator, CollidingHasher> set;
+
+    for (int i = 0; i < kCount; ++i)
+    {
+        set.insert(i);
+    }
+
+    ASL_TEST_EXPECT(set.size() == kCount);
+
+    for (int i = 0; i < kCount; i += 2)
+    {
+        ASL_TEST_EXPECT(set.remove(i));
+    }
+
+    ASL_TEST_EXPECT(set.size() == kCount / 2);
+
+    for (int i = 0; i < kCount * 2; ++i)
+    {
+        ASL_TEST_EXPECT(set.contains(i) == (i < kCount && i % 2 == 1));
+    }
+
+    for (int i = 0; i < kCount; ++i)
+    {
+        set.insert(i);
+    }
+
+    ASL_TEST_EXPECT(set.size() == kCount);
+
+    for (int i = 0; i < kCount * 2; ++i)
+    {
+        ASL_TEST_EXPECT(set.contains(i) == (i < kCount));
+    }
+}
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(churn_keeps_capacity)
+{
+    static constexpr int kLive = 100;
+
+    asl::hash_set<int> set;
+
+    for (int i = 0; i < kLive; ++i)
+    {
+        set.insert(i);
+    }
+
+    const isize_t capacity = set.capacity();
+
+    // Always the same number of live values, the tombstones left behind
+    // have to be cleaned up without growing.
+    for (int i = kLive; i < kLive * 100; ++i)
+    {
+        ASL_TEST_EXPECT(set.remove(i - kLive));
+        set.insert(i);
+        ASL_TEST_EXPECT(set.size() == kLive);
+    }
+
+    ASL_TEST_EXPECT(set.capacity() == capacity);
+
+    for (int i = 0; i < kLive * 100; ++i)
+    {
+        ASL_TEST_EXPECT(set.contains(i) == (i >= kLive * 99));
+    }
+}
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(churn_with_collisions)
+{
+    static constexpr int kLive = 20;
+
+    asl::hash_set<int, asl::DefaultAllocator, CollidingHasher> set;
+
+    for (int i = 0; i < kLive; ++i)
+    {
+        set.insert(i);
+    }
+
+    const isize_t capacity = set.capacity();
+
+    for (int i = kLive; i < kLive * 50; ++i)
+    {
+        ASL_TEST_EXPECT(set.remove(i - kLive));
+        set.insert(i);
+    }
+
+    ASL_TEST_EXPECT(set.size() == kLive);
+    ASL_TEST_EXPECT(set.capacity() == capacity);
+
+    for (int i = 0; i < kLive * 50; ++i)
+    {
+        ASL_TEST_EXPECT(set.contains(i) == (i >= kLive * 49));
+    }
+}
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(rehash_and_shrink_to_fit)
+{
+    asl::hash_set<int> set;
+
+    set.rehash(1000);
+    const isize_t capacity = set.capacity();
+    ASL_TEST_EXPECT(capacity >= 1000);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        set.insert(i);
+    }
+    ASL_TEST_EXPECT(set.capacity() == capacity);
+
+    for (int i = 0; i < 1000; i += 10)
+    {
+        ASL_TEST_EXPECT(set.remove(i));
+        ASL_TEST_EXPECT(set.remove(i + 1));
+        ASL_TEST_EXPECT(set.remove(i + 2));
+    }
+
+    set.shrink_to_fit();
+    ASL_TEST_EXPECT(set.size() == 700);
+    ASL_TEST_EXPECT(set.capacity() < capacity);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASL_TEST_EXPECT(set.contains(i) == (i % 10 >= 3));
+    }
+
+    set.clear();
+    set.shrink_to_fit();
+    ASL_TEST_EXPECT(set.capacity() == 0);
+    ASL_TEST_EXPECT(!set.contains(5));
+}
+
+static_assert(asl::default_hash_set_layout<uint64_t> == asl::hash_set_layout::kGrouped);
+static_assert(asl::default_hash_set_layout<asl::string<>> == asl::hash_set_layout::kSplit);
+
+struct alignas(32) OverAligned
+{
+    int x;
+
+    constexpr bool operator==(const OverAligned&) const = default;
+};
+
+struct OverAlignedHasher
+{
+    static uint64_t hash(const OverAligned& v) { return asl::hash_value(v.x); }
+};
+
+template<typename T, asl::hash_set_layout kLayout, typename Hasher = asl::default_key_hasher<T>>
+static void check_layout(auto make)
+{
+    asl::hash_set<T, asl::DefaultAllocator, Hasher, asl::default_key_comparator<T>, kLayout> set;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        set.insert(make(i));
+    }
+
+    for (int i = 0; i < 1000; i += 3)
+    {
+        ASL_TEST_EXPECT(set.remove(make(i)));
+    }
+
+    ASL_TEST_EXPECT(set.size() == 666);
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        ASL_TEST_EXPECT(set.contains(make(i)) == (i < 1000 && i % 3 != 0));
+    }
+}
+
+ASL_TEST(layouts)
+{
+    const auto make_int = [](int i) { return i; };
+    check_layout<int, asl::hash_set_layout::kSplit>(make_int);
+    check_layout<int, asl::hash_set_layout::kGrouped>(make_int);
+
+    const auto make_over_aligned = [](int i) { return OverAligned{i}; };
+    check_layout<OverAligned, asl::hash_set_layout::kSplit, OverAlignedHasher>(make_over_aligned);
+    check_layout<OverAligned, asl::hash_set_layout::kGrouped, OverAlignedHasher>(make_over_aligned);
+}
+
+ASL_TEST(get_many)
+{
+    asl::hash_set<int> set;
+
+    for (int i = 0; i < 1000; i += 3)
+    {
+        set.insert(i);
+    }
+
+    int values[50];
+    const int* found[50];
+
+    for (int i = 0; i < 50; ++i)
+    {
+        values[i] = i * 37; // NOLINT(*-constant-array-index)
+    }
+
+    set.get_many(values, found);
+
+    for (int i = 0; i < 50; ++i)
+    {
+        // NOLINTBEGIN(*-constant-array-index)
+        if (values[i] % 3 == 0 && values[i] < 1000)
+        {
+            ASL_TEST_ASSERT(found[i] != nullptr);
+            ASL_TEST_EXPECT(*found[i] == values[i]);
+        }
+        else
+        {
+            ASL_TEST_EXPECT(found[i] == nullptr);
+        }
+        // NOLINTEND(*-constant-array-index)
+    }
+}
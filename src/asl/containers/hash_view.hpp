@@ -0,0 +1,274 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "asl/base/support.hpp"
+#include "asl/base/meta.hpp"
+#include "asl/base/byte.hpp"
+#include "asl/base/numeric.hpp"
+#include "asl/base/memory_ops.hpp"
+#include "asl/types/span.hpp"
+#include "asl/types/status.hpp"
+#include "asl/types/status_or.hpp"
+#include "asl/containers/hash_set.hpp"
+#include "asl/containers/hash_map.hpp"
+
+namespace asl::hash_set_internal
+{
+
+// Checks that an image was written by a set with this storage, and that it
+// was loaded whole, at a suitable address. Returns its header.
+template<typename T, typename KeyHasher, hash_set_layout Layout>
+status_or<ImageHeader> check_image(span<const std::byte> image)
+{
+    using Storage = StorageFor<T, Layout>;
+
+    if (image.size() < static_cast<isize_t>(sizeof(ImageHeader)))
+    {
+        return invalid_argument_error("Image is too small for its header");
+    }
+
+    // NOLINTNEXTLINE(*-reinterpret-cast)
+    if ((reinterpret_cast<uintptr_t>(image.data()) & static_cast<uintptr_t>(Storage::kImageAlign - 1)) != 0)
+    {
+        return invalid_argument_error("Image must be aligned on {} bytes", Storage::kImageAlign);
+    }
+
+    ImageHeader header{};
+    asl::memcpy(&header, image.data(), sizeof(ImageHeader));
+
+    if (header.magic != ImageHeader::kMagic)
+    {
+        return invalid_argument_error("Not a hash set image");
+    }
+
+    if (header.version != ImageHeader::kVersion)
+    {
+        return invalid_argument_error("Unsupported image version {}", header.version);
+    }
+
+    if (header.layout != static_cast<uint32_t>(Layout) ||
+        header.group_width != static_cast<uint32_t>(Group::kWidth) ||
+        header.value_size != sizeof(T) ||
+        header.value_align != alignof(T))
+    {
+        return invalid_argument_error("Image was written by a different kind of hash set");
+    }
+
+    if (header.seed != key_hasher_seed<KeyHasher>())
+    {
+        return invalid_argument_error("Image was written with a different hash seed");
+    }
+
+    const bool valid_capacity = header.capacity == 0 ||
+        (header.capacity >= Group::kWidth && is_pow2(header.capacity));
+
+    if (!valid_capacity || header.size < 0 || header.size > header.capacity)
+    {
+        return invalid_argument_error("Invalid capacity or size in image");
+    }
+
+    // Every slot takes at least a tag and a value, which bounds the
+    // capacity before the storage size is computed from it.
+    if (header.capacity > image.size() / (static_cast<isize_t>(sizeof(T)) + 1))
+    {
+        return invalid_argument_error("Image is truncated");
+    }
+
+    const isize_t storage_offset =
+        round_up_pow2<isize_t>(static_cast<isize_t>(sizeof(ImageHeader)), Storage::kImageAlign);
+    const isize_t storage_size = header.capacity > 0 ? Storage::image_size(header.capacity) : 0;
+
+    if (header.storage_offset != storage_offset || header.storage_size != storage_size)
+    {
+        return invalid_argument_error("Invalid storage bounds in image");
+    }
+
+    if (image.size() - storage_offset < storage_size)
+    {
+        return invalid_argument_error("Image is truncated");
+    }
+
+    if (header.size > 0)
+    {
+        // NOLINTNEXTLINE(*-pointer-arithmetic)
+        const Storage storage = Storage::from_image(image.data() + storage_offset, header.capacity);
+
+        for (isize_t i = 0; i < header.capacity; ++i)
+        {
+            if ((storage.tag(i) & kHasValue) != 0)
+            {
+                if (KeyHasher::hash(storage.value(i).as_init_unsafe()) != header.hash_check)
+                {
+                    return invalid_argument_error("Image was written with a different hash function");
+                }
+                break;
+            }
+        }
+    }
+
+    return header;
+}
+
+} // namespace asl::hash_set_internal
+
+namespace asl
+{
+
+// Read-only hash_set looking up values in place in an image written by
+// hash_set::write_image, without copying or allocating anything. The
+// image, typically a mapped file, has to outlive the view.
+template<
+    is_object T,
+    key_hasher<T> KeyHasher = default_key_hasher<T>,
+    key_comparator<T> KeyComparator = default_key_comparator<T>,
+    hash_set_layout Layout = default_hash_set_layout<T>
+>
+requires is_trivially_copyable<T>
+class hash_set_view
+{
+protected:
+    using Storage = hash_set_internal::StorageFor<T, Layout>;
+
+    Storage m_storage{};
+    isize_t m_capacity{};
+    isize_t m_size{};
+
+    template<typename U>
+    requires key_hasher<KeyHasher, U> && key_comparator<KeyComparator, T, U>
+    isize_t find_slot_lookup(const U& value) const
+    {
+        if (m_size <= 0) { return -1; }
+
+        return hash_set_internal::find_slot_lookup<KeyComparator>(
+            m_storage, m_capacity, value, KeyHasher::hash(value));
+    }
+
+    template<typename U, typename Callback>
+    requires key_hasher<KeyHasher, U> && key_comparator<KeyComparator, T, U>
+    void find_slots_lookup(span<const U> values, const Callback& callback) const
+    {
+        hash_set_internal::find_slots_lookup<KeyHasher, KeyComparator>(
+            m_storage, m_capacity, m_size, values, callback);
+    }
+
+public:
+    // Empty view.
+    constexpr hash_set_view() = default;
+
+    // Fails when the image wasn't written by a hash_set of the same type,
+    // layout and hash function, or is truncated or misaligned.
+    static status_or<hash_set_view> from_image(span<const std::byte> image)
+    {
+        auto header = hash_set_internal::check_image<T, KeyHasher, Layout>(image);
+        if (!header.ok())
+        {
+            return std::move(header).throw_status();
+        }
+
+        hash_set_view view;
+        view.m_capacity = header.value().capacity;
+        view.m_size = header.value().size;
+
+        if (view.m_capacity > 0)
+        {
+            // NOLINTNEXTLINE(*-pointer-arithmetic)
+            view.m_storage = Storage::from_image(image.data() + header.value().storage_offset, view.m_capacity);
+        }
+
+        return view;
+    }
+
+    [[nodiscard]] constexpr isize_t size() const { return m_size; }
+
+    [[nodiscard]] constexpr bool is_empty() const { return m_size == 0; }
+
+    template<typename U>
+    requires key_hasher<KeyHasher, U> && key_comparator<KeyComparator, T, U>
+    bool contains(const U& value) const
+    {
+        return find_slot_lookup(value) >= 0;
+    }
+
+    // Same as hash_set::get_many.
+    void get_many(span<const T> values, span<const T*> out) const
+    {
+        ASL_ASSERT(values.size() == out.size());
+        find_slots_lookup(values, [&](isize_t i, isize_t slot) {
+            out[i] = slot >= 0 ? &m_storage.value(slot).as_init_unsafe() : nullptr;
+        });
+    }
+};
+
+// Read-only hash_map looking up values in place in an image written by
+// hash_map::write_image. The image has to outlive the view.
+template<
+    is_object K,
+    is_object V,
+    key_hasher<K> KeyHasher = default_key_hasher<K>,
+    key_comparator<K> KeyComparator = default_key_comparator<K>,
+    hash_set_layout Layout = default_hash_set_layout<hash_map_internal::Slot<K, V>>
+>
+requires is_trivially_copyable<K> && is_trivially_copyable<V>
+class hash_map_view : protected hash_set_view<
+    hash_map_internal::Slot<K, V>,
+    hash_map_internal::SlotHasher<K, V, KeyHasher>,
+    hash_map_internal::SlotComparator<K, V, KeyComparator>,
+    Layout>
+{
+    using Base =
+        hash_set_view<
+            hash_map_internal::Slot<K, V>,
+            hash_map_internal::SlotHasher<K, V, KeyHasher>,
+            hash_map_internal::SlotComparator<K, V, KeyComparator>,
+            Layout>;
+
+    explicit constexpr hash_map_view(const Base& base) : Base{base} {}
+
+public:
+    // Empty view.
+    constexpr hash_map_view() = default;
+
+    // Fails when the image wasn't written by a hash_map of the same types,
+    // layout and hash function, or is truncated or misaligned.
+    static status_or<hash_map_view> from_image(span<const std::byte> image)
+    {
+        auto base = Base::from_image(image);
+        if (!base.ok())
+        {
+            return std::move(base).throw_status();
+        }
+        return hash_map_view{base.value()};
+    }
+
+    using Base::size;
+
+    using Base::is_empty;
+
+    using Base::contains;
+
+    template<typename U>
+    requires key_hasher<KeyHasher, U> && key_comparator<KeyComparator, K, U>
+    const V* get(const U& key) const
+    {
+        const isize_t index = Base::find_slot_lookup(key);
+        if (index >= 0)
+        {
+            return &Base::m_storage.value(index).as_init_unsafe().value;
+        }
+        return nullptr;
+    }
+
+    // Same as hash_map::get_many.
+    void get_many(span<const K> keys, span<const V*> out) const
+    {
+        ASL_ASSERT(keys.size() == out.size());
+        Base::find_slots_lookup(keys, [&](isize_t i, isize_t slot) {
+            out[i] = slot >= 0 ? &Base::m_storage.value(slot).as_init_unsafe().value : nullptr;
+        });
+    }
+};
+
+} // namespace asl
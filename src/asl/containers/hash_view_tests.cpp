@@ -0,0 +1,243 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/testing/testing.hpp"
+#include "asl/containers/hash_view.hpp"
+#include "asl/containers/hash_map.hpp"
+#include "asl/containers/hash_set.hpp"
+#include "asl/allocator/allocator.hpp"
+#include "asl/base/memory_ops.hpp"
+#include "asl/io/writer.hpp"
+
+// Collects an image in memory, aligned like a mapped file would be.
+class ImageWriter : public asl::Writer
+{
+    static constexpr isize_t kAlign = 64;
+
+    asl::DefaultAllocator m_allocator;
+    std::byte*            m_data{};
+    isize_t               m_size{};
+    isize_t               m_capacity{};
+
+public:
+    ImageWriter() = default;
+    ASL_DELETE_COPY_MOVE(ImageWriter);
+
+    ~ImageWriter() override
+    {
+        if (m_data != nullptr)
+        {
+            m_allocator.dealloc(m_data, asl::layout{ .size = m_capacity, .align = kAlign });
+        }
+    }
+
+    void write(asl::span<const std::byte> bytes) override
+    {
+        if (m_size + bytes.size() > m_capacity)
+        {
+            const isize_t capacity = asl::max(m_capacity * 2, m_size + bytes.size());
+            m_data = static_cast<std::byte*>(m_data == nullptr
+                ? m_allocator.alloc(asl::layout{ .size = capacity, .align = kAlign })
+                : m_allocator.realloc(
+                    m_data,
+                    asl::layout{ .size = m_capacity, .align = kAlign },
+                    asl::layout{ .size = capacity, .align = kAlign }));
+            m_capacity = capacity;
+        }
+
+        asl::memcpy(m_data + m_size, bytes.data(), bytes.size()); // NOLINT(*-pointer-arithmetic)
+        m_size += bytes.size();
+    }
+
+    [[nodiscard]] asl::span<std::byte> bytes() const { return {m_data, m_size}; }
+};
+
+template<asl::hash_set_layout kLayout>
+static void check_set_image()
+{
+    asl::hash_set<int, asl::DefaultAllocator, asl::default_key_hasher<int>, asl::default_key_comparator<int>, kLayout> set;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        set.insert(i);
+    }
+    for (int i = 0; i < 1000; i += 2)
+    {
+        set.remove(i);
+    }
+
+    ImageWriter writer;
+    set.write_image(&writer);
+
+    auto view = asl::hash_set_view<int, asl::default_key_hasher<int>, asl::default_key_comparator<int>, kLayout>
+        ::from_image(writer.bytes());
+    ASL_TEST_ASSERT(view.ok());
+    ASL_TEST_EXPECT(view.value().size() == 500);
+
+    for (int i = -10; i < 1010; ++i)
+    {
+        ASL_TEST_EXPECT(view.value().contains(i) == (i >= 0 && i < 1000 && i % 2 == 1));
+    }
+
+    int values[3] = { 1, 2, 999 };
+    const int* found[3];
+    view.value().get_many(values, found);
+
+    ASL_TEST_EXPECT(found[0] != nullptr && *found[0] == 1);
+    ASL_TEST_EXPECT(found[1] == nullptr);
+    ASL_TEST_EXPECT(found[2] != nullptr && *found[2] == 999);
+}
+
+ASL_TEST(set_image)
+{
+    check_set_image<asl::hash_set_layout::kSplit>();
+    check_set_image<asl::hash_set_layout::kGrouped>();
+}
+
+ASL_TEST(map_image)
+{
+    asl::hash_map<int, int64_t> map;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        map.insert(i, int64_t{i} * 3);
+    }
+
+    ImageWriter writer;
+    map.write_image(&writer);
+
+    auto view = asl::hash_map_view<int, int64_t>::from_image(writer.bytes());
+    ASL_TEST_ASSERT(view.ok());
+    ASL_TEST_EXPECT(view.value().size() == 1000);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        const int64_t* value = view.value().get(i);
+        ASL_TEST_ASSERT(value != nullptr);
+        ASL_TEST_EXPECT(*value == int64_t{i} * 3);
+    }
+    ASL_TEST_EXPECT(view.value().get(1000) == nullptr);
+    ASL_TEST_EXPECT(!view.value().contains(-1));
+
+    int keys[2] = { 12, 2000 };
+    const int64_t* found[2];
+    view.value().get_many(keys, found);
+
+    ASL_TEST_EXPECT(found[0] != nullptr && *found[0] == 36);
+    ASL_TEST_EXPECT(found[1] == nullptr);
+}
+
+ASL_TEST(empty_image)
+{
+    const asl::hash_set<int> set;
+
+    ImageWriter writer;
+    set.write_image(&writer);
+
+    auto view = asl::hash_set_view<int>::from_image(writer.bytes());
+    ASL_TEST_ASSERT(view.ok());
+    ASL_TEST_EXPECT(view.value().is_empty());
+    ASL_TEST_EXPECT(!view.value().contains(0));
+}
+
+struct OtherHasher
+{
+    static uint64_t hash(int x) { return static_cast<uint64_t>(x) * 0x9e37'79b9'7f4a'7c15ULL; }
+};
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(invalid_image)
+{
+    asl::hash_set<int> set;
+    for (int i = 0; i < 100; ++i)
+    {
+        set.insert(i);
+    }
+
+    ImageWriter writer;
+    set.write_image(&writer);
+    const asl::span<std::byte> image = writer.bytes();
+
+    ASL_TEST_EXPECT(asl::hash_set_view<int>::from_image(image).ok());
+
+    // Different type, different hash function.
+    ASL_TEST_EXPECT(!asl::hash_set_view<int64_t>::from_image(image).ok());
+    ASL_TEST_EXPECT(!asl::hash_set_view<int, OtherHasher>::from_image(image).ok());
+
+    // Truncated, misaligned.
+    ASL_TEST_EXPECT(!asl::hash_set_view<int>::from_image(image.first(image.size() - 1)).ok());
+    ASL_TEST_EXPECT(!asl::hash_set_view<int>::from_image(image.first(8)).ok());
+    ASL_TEST_EXPECT(!asl::hash_set_view<int>::from_image(image.subspan(1)).ok());
+
+    // Corrupted magic.
+    image[0] = std::byte{'X'};
+    ASL_TEST_EXPECT(!asl::hash_set_view<int>::from_image(image).ok());
+}
+
+ASL_TEST(huge_capacity_image)
+{
+    const asl::hash_set<int> set;
+
+    ImageWriter writer;
+    set.write_image(&writer);
+    const asl::span<std::byte> image = writer.bytes();
+
+    // Big enough for the storage size to overflow.
+    using asl::hash_set_internal::ImageHeader;
+    const int64_t capacity = int64_t{1} << 62;
+    asl::memcpy(&image[static_cast<isize_t>(offsetof(ImageHeader, capacity))], &capacity, static_cast<isize_t>(sizeof(capacity)));
+    ASL_TEST_EXPECT(!asl::hash_set_view<int>::from_image(image).ok());
+}
+
+ASL_TEST(image_seed)
+{
+    asl::hash_set<int> set;
+    for (int i = 0; i < 100; ++i)
+    {
+        set.insert(i);
+    }
+
+    ImageWriter writer;
+    set.write_image(&writer);
+    const asl::span<std::byte> image = writer.bytes();
+    ASL_TEST_EXPECT(asl::hash_set_view<int>::from_image(image).ok());
+
+    // Written with a hasher seeded differently.
+    using asl::hash_set_internal::ImageHeader;
+    image[static_cast<isize_t>(offsetof(ImageHeader, seed))] ^= std::byte{1};
+    ASL_TEST_EXPECT(!asl::hash_set_view<int>::from_image(image).ok());
+}
+
+ASL_TEST(seeded_image)
+{
+    using SeededSet = asl::hash_set<int, asl::DefaultAllocator, asl::seeded_key_hasher<int>>;
+    using SeededView = asl::hash_set_view<int, asl::seeded_key_hasher<int>>;
+
+    SeededSet set;
+    for (int i = 0; i < 100; ++i)
+    {
+        set.insert(i);
+    }
+
+    ImageWriter writer;
+    set.write_image(&writer);
+
+    auto view = SeededView::from_image(writer.bytes());
+    ASL_TEST_ASSERT(view.ok());
+    ASL_TEST_EXPECT(view.value().contains(42));
+    ASL_TEST_EXPECT(!asl::hash_set_view<int>::from_image(writer.bytes()).ok());
+}
+
+ASL_TEST(empty_seeded_image)
+{
+    const asl::hash_set<int, asl::DefaultAllocator, asl::keyed_key_hasher<int>> set;
+
+    ImageWriter writer;
+    set.write_image(&writer);
+
+    // There are no values to check the hash function with, only the seed.
+    ASL_TEST_EXPECT(asl::hash_set_view<int, asl::keyed_key_hasher<int>>::from_image(writer.bytes()).ok());
+    ASL_TEST_EXPECT(!asl::hash_set_view<int>::from_image(writer.bytes()).ok());
+    ASL_TEST_EXPECT(!asl::hash_set_view<int, asl::seeded_key_hasher<int>>::from_image(writer.bytes()).ok());
+}
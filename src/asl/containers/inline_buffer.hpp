@@ -0,0 +1,411 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "asl/base/support.hpp"
+#include "asl/base/memory.hpp"
+#include "asl/base/memory_ops.hpp"
+#include "asl/base/meta.hpp"
+#include "asl/base/assert.hpp"
+#include "asl/types/span.hpp"
+#include "asl/types/maybe_uninit.hpp"
+#include "asl/hashing/hash.hpp"
+#include "asl/allocator/allocator.hpp"
+#include "asl/containers/buffer.hpp"
+
+namespace asl
+{
+
+// Same as buffer, but with room for kInlineCapacity elements in the
+// object itself, whatever their size. Elements are moved to the heap
+// when there are more of them.
+template<
+    typename T,
+    isize_t kInlineCapacity_,
+    allocator Allocator = DefaultAllocator,
+    growth_policy Growth = doubling_growth>
+requires is_object<T> && movable<T> && (kInlineCapacity_ > 0)
+class inline_buffer
+{
+public:
+    static constexpr isize_t kInlineCapacity = kInlineCapacity_;
+
+private:
+    // nullptr when the elements are inline.
+    T*      m_heap_data{};
+    isize_t m_size{};
+    isize_t m_capacity{kInlineCapacity};
+
+    maybe_uninit<T> m_inline[kInlineCapacity];
+
+    ASL_NO_UNIQUE_ADDRESS Allocator m_allocator;
+
+    [[nodiscard]] constexpr bool is_on_heap() const
+    {
+        return m_heap_data != nullptr;
+    }
+
+    constexpr void* push_uninit()
+    {
+        const isize_t sz = size();
+        resize_uninit_inner(sz + 1);
+        return data() + sz;
+    }
+
+    constexpr void resize_uninit_inner(isize_t new_size)
+    {
+        ASL_ASSERT(new_size >= 0);
+
+        if constexpr (!is_trivially_destructible<T>)
+        {
+            const isize_t old_size = size();
+            if (new_size < old_size)
+            {
+                destroy_n(data() + new_size, old_size - new_size);
+            }
+        }
+        reserve_capacity(new_size);
+        m_size = new_size;
+    }
+
+    // NOLINTNEXTLINE(*-rvalue-reference-param-not-moved)
+    void move_from_other(inline_buffer&& other, bool assign)
+    {
+        if (other.is_on_heap())
+        {
+            // Adopt other's heap data. We'll soon adopt the allocator
+            // as well.
+            destroy();
+            m_heap_data = std::exchange(other.m_heap_data, nullptr);
+            m_capacity = std::exchange(other.m_capacity, kInlineCapacity);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        else
+        {
+            // Other's elements are inline, so they always fit here. Our
+            // heap data can be kept if other's allocator can free it.
+            if (assign && !(m_allocator == other.m_allocator))
+            {
+                destroy();
+            }
+            else
+            {
+                clear();
+            }
+
+            relocate_uninit_n(data(), other.data(), other.m_size);
+            m_size = std::exchange(other.m_size, 0);
+        }
+
+        if (assign)
+        {
+            m_allocator = std::move(other.m_allocator);
+        }
+    }
+
+    void copy_range(span<const T> to_copy)
+    {
+        const isize_t this_size = size();
+        const isize_t new_size = to_copy.size();
+
+        resize_uninit_inner(new_size);
+        ASL_ASSERT(capacity() >= new_size);
+
+        if (new_size <= this_size)
+        {
+            copy_assign_n(data(), to_copy.data(), new_size);
+        }
+        else
+        {
+            copy_assign_n(data(), to_copy.data(), this_size);
+            copy_uninit_n(data() + this_size, to_copy.data() + this_size, new_size - this_size);
+        }
+    }
+
+    template<typename... Args>
+    void resize_inner(isize_t new_size, Args&&... args)
+        requires constructible_from<T, Args&&...>
+    {
+        const isize_t old_size = size();
+        resize_uninit_inner(new_size);
+
+        T* data_ptr = data();
+        T* end = data_ptr + new_size;
+
+        // NOLINTNEXTLINE(*-pointer-arithmetic)
+        for (T* it = data_ptr + old_size; it < end; ++it)
+        {
+            construct_at<T>(it, std::forward<Args>(args)...);
+        }
+    }
+
+    // Moves the elements to a heap allocation of at least new_capacity
+    // elements, which must be able to hold all of them.
+    void reallocate_heap(isize_t new_capacity)
+    {
+        ASL_ASSERT(new_capacity > kInlineCapacity);
+        ASL_ASSERT(new_capacity >= m_size);
+
+        auto old_layout = layout::array<T>(m_capacity);
+        auto new_layout = layout::array<T>(new_capacity);
+
+        if (is_on_heap() && is_trivially_relocatable<T>)
+        {
+            const allocation a = realloc_at_least(m_allocator, m_heap_data, old_layout, new_layout);
+            m_heap_data = static_cast<T*>(a.ptr);
+            m_capacity = a.size / static_cast<isize_t>(sizeof(T));
+            return;
+        }
+
+        const allocation a = alloc_at_least(m_allocator, new_layout);
+        auto* new_data = static_cast<T*>(a.ptr);
+
+        relocate_uninit_n(new_data, data(), m_size);
+
+        if (is_on_heap())
+        {
+            m_allocator.dealloc(m_heap_data, old_layout);
+        }
+
+        m_heap_data = new_data;
+        m_capacity = a.size / static_cast<isize_t>(sizeof(T));
+    }
+
+    // Moves the elements from the heap back to the inline storage, and
+    // frees the heap allocation.
+    void move_to_inline()
+    {
+        ASL_ASSERT(is_on_heap());
+        ASL_ASSERT(m_size <= kInlineCapacity);
+
+        T* old_data = std::exchange(m_heap_data, nullptr);
+        const isize_t old_capacity = std::exchange(m_capacity, kInlineCapacity);
+
+        relocate_uninit_n(data(), old_data, m_size);
+        m_allocator.dealloc(old_data, layout::array<T>(old_capacity));
+    }
+
+public:
+    constexpr inline_buffer() requires is_default_constructible<Allocator> = default;
+
+    explicit constexpr inline_buffer(span<const T> s)
+        requires is_default_constructible<Allocator>
+        : inline_buffer{}
+    {
+        copy_range(s);
+    }
+
+    explicit constexpr inline_buffer(Allocator allocator)
+        : m_allocator{std::move(allocator)}
+    {}
+
+    explicit constexpr inline_buffer(span<const T> s, Allocator allocator)
+        : m_allocator{std::move(allocator)}
+    {
+        copy_range(s);
+    }
+
+    constexpr inline_buffer(const inline_buffer& other)
+        requires copy_constructible<Allocator> && copyable<T>
+        : m_allocator{other.m_allocator}
+    {
+        copy_range(other);
+    }
+
+    constexpr inline_buffer(inline_buffer&& other)
+        : inline_buffer(std::move(other.m_allocator))
+    {
+        move_from_other(std::move(other), false);
+    }
+
+    constexpr inline_buffer& operator=(const inline_buffer& other)
+        requires copyable<T>
+    {
+        if (&other == this) { return *this; }
+        copy_range(other);
+        return *this;
+    }
+
+    constexpr inline_buffer& operator=(inline_buffer&& other)
+    {
+        if (&other == this) { return *this; }
+        move_from_other(std::move(other), true);
+        return *this;
+    }
+
+    ~inline_buffer()
+    {
+        destroy();
+    }
+
+    constexpr Allocator allocator_copy() const
+        requires copy_constructible<Allocator>
+    {
+        return m_allocator;
+    }
+
+    constexpr Allocator& allocator() { return m_allocator; }
+
+    [[nodiscard]] constexpr isize_t size() const { return m_size; }
+
+    [[nodiscard]] constexpr bool is_empty() const { return m_size == 0; }
+
+    [[nodiscard]] constexpr isize_t capacity() const { return m_capacity; }
+
+    void clear()
+    {
+        destroy_n(data(), m_size);
+        m_size = 0;
+    }
+
+    void destroy()
+    {
+        clear();
+        if (is_on_heap())
+        {
+            m_allocator.dealloc(m_heap_data, layout::array<T>(m_capacity));
+            m_heap_data = nullptr;
+            m_capacity = kInlineCapacity;
+        }
+    }
+
+    // Same as buffer::reserve_capacity.
+    void reserve_capacity(isize_t new_capacity)
+    {
+        ASL_ASSERT(new_capacity >= 0);
+
+        if (new_capacity <= m_capacity) { return; }
+
+        const isize_t grown = Growth::grow(m_capacity, new_capacity, static_cast<isize_t>(sizeof(T)));
+        ASL_ASSERT(grown >= new_capacity);
+
+        reallocate_heap(grown);
+    }
+
+    // Same as buffer::reserve_exact.
+    void reserve_exact(isize_t new_capacity)
+    {
+        ASL_ASSERT(new_capacity >= 0);
+
+        if (new_capacity <= m_capacity) { return; }
+        reallocate_heap(new_capacity);
+    }
+
+    // Same as buffer::shrink_to_fit.
+    void shrink_to_fit()
+    {
+        if (!is_on_heap()) { return; }
+
+        if (m_size <= kInlineCapacity)
+        {
+            move_to_inline();
+        }
+        else if (m_size < m_capacity)
+        {
+            reallocate_heap(m_size);
+        }
+    }
+
+    constexpr void resize_uninit(isize_t new_size)
+        requires is_trivially_default_constructible<T>
+    {
+        resize_uninit_inner(new_size);
+    }
+
+    constexpr void resize_zero(isize_t new_size)
+        requires is_trivially_default_constructible<T>
+    {
+        const isize_t old_size = size();
+        resize_uninit_inner(new_size);
+
+        if (new_size > old_size)
+        {
+            memzero(data() + old_size, (new_size - old_size) * static_cast<isize_t>(sizeof(T)));
+        }
+    }
+
+    void resize(isize_t new_size)
+        requires is_default_constructible<T>
+    {
+        if constexpr (is_trivially_default_constructible<T>)
+        {
+            resize_zero(new_size);
+        }
+        else
+        {
+            resize_inner(new_size);
+        }
+    }
+
+    void resize(isize_t new_size, const T& value)
+    {
+        resize_inner(new_size, value);
+    }
+
+    constexpr T& push(auto&&... args)
+        requires constructible_from<T, decltype(args)&&...>
+    {
+        void* uninit = push_uninit();
+        T* init = construct_at<T>(uninit, std::forward<decltype(args)>(args)...);
+        return *init;
+    }
+
+    auto data(this auto&& self)
+    {
+        using return_type = add_ptr_t<copy_const_t<remove_ref_t<decltype(self)>, T>>;
+        return self.is_on_heap()
+            ? return_type{ self.m_heap_data }
+            // NOLINTNEXTLINE(*-reinterpret-cast)
+            : std::launder(reinterpret_cast<return_type>(&self.m_inline));
+    }
+
+    constexpr auto begin(this auto&& self)
+    {
+        using type = copy_const_t<remove_ref_t<decltype(self)>, T>;
+        return contiguous_iterator<type>{self.data()};
+    }
+
+    constexpr auto end(this auto&& self)
+    {
+        using type = copy_const_t<remove_ref_t<decltype(self)>, T>;
+        return contiguous_iterator<type>{self.data() + self.size()};
+    }
+
+    constexpr operator span<const T>() const // NOLINT(*explicit*)
+    {
+        return as_span();
+    }
+
+    constexpr operator span<T>() // NOLINT(*explicit*)
+    {
+        return as_span();
+    }
+
+    constexpr auto as_span(this auto&& self)
+    {
+        using type = copy_const_t<remove_ref_t<decltype(self)>, T>;
+        return span<type>{self.data(), self.size()};
+    }
+
+    constexpr auto&& operator[](this auto&& self, isize_t i)
+    {
+        ASL_ASSERT(i >= 0 && i < self.size());
+        return std::forward_like<decltype(self)>(std::forward<decltype(self)>(self).data()[i]);
+    }
+
+    template<typename H>
+    requires hashable<T>
+    friend H AslHashValue(H h, const inline_buffer& b)
+    {
+        return H::combine_contiguous(std::move(h), b.as_span());
+    }
+};
+
+// Inline elements are copied along with the buffer, heap ones don't move.
+template<typename T, isize_t kInlineCapacity, allocator Allocator, growth_policy Growth>
+struct trivially_relocatable<inline_buffer<T, kInlineCapacity, Allocator, Growth>>
+    : bool_constant<is_trivially_relocatable<T> && is_trivially_relocatable<Allocator>> {};
+
+} // namespace asl
@@ -0,0 +1,43 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/containers/inline_buffer.hpp"
+#include "asl/benchmarking/benchmarking.hpp"
+
+using asl::benchmarking::CountingAllocator;
+
+struct Entry
+{
+    int64_t id;
+    int64_t data[2];
+};
+
+// Pushes state.arg() small structs into a new buffer, which are too big
+// for its inline storage.
+ASL_BENCHMARK_ARGS(buffer_push_small_structs, 4, 16, 32, 64)
+{
+    while (state.keep_running())
+    {
+        asl::buffer<Entry, CountingAllocator> b;
+        for (int64_t i = 0; i < state.arg(); ++i)
+        {
+            b.push(Entry{ .id = i, .data = {} });
+        }
+        asl::benchmarking::do_not_optimize(b.data());
+    }
+}
+
+// Same, with an inline_buffer which only allocates past 32 elements.
+ASL_BENCHMARK_ARGS(inline_buffer_push_small_structs, 4, 16, 32, 64)
+{
+    while (state.keep_running())
+    {
+        asl::inline_buffer<Entry, 32, CountingAllocator> b;
+        for (int64_t i = 0; i < state.arg(); ++i)
+        {
+            b.push(Entry{ .id = i, .data = {} });
+        }
+        asl::benchmarking::do_not_optimize(b.data());
+    }
+}
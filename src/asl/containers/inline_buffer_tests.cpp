@@ -0,0 +1,267 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/containers/inline_buffer.hpp"
+
+#include "asl/testing/testing.hpp"
+#include "asl/tests/types.hpp"
+#include "asl/tests/counting_allocator.hpp"
+
+struct Request
+{
+    uint64_t id;
+    uint64_t data[3];
+};
+
+static_assert(asl::inline_buffer<Request, 8>::kInlineCapacity == 8);
+static_assert(asl::is_trivially_relocatable<asl::inline_buffer<Request, 8>>);
+static_assert(!asl::is_trivially_relocatable<asl::inline_buffer<DestructorObserver, 2>>);
+
+ASL_TEST(default_size)
+{
+    const asl::inline_buffer<Request, 8> b;
+    ASL_TEST_EXPECT(b.size() == 0);
+    ASL_TEST_EXPECT(b.capacity() == 8);
+    ASL_TEST_EXPECT(b.is_empty());
+}
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(spill_to_heap)
+{
+    CountingAllocator::Stats stats;
+    asl::inline_buffer<Request, 4, CountingAllocator> b(CountingAllocator{&stats});
+
+    for (uint64_t i = 0; i < 4; ++i)
+    {
+        b.push(Request{ .id = i, .data = {} });
+    }
+    ASL_TEST_EXPECT(b.size() == 4);
+    ASL_TEST_EXPECT(b.capacity() == 4);
+    ASL_TEST_EXPECT(stats.any_alloc_count() == 0);
+
+    const auto* obj = reinterpret_cast<const std::byte*>(&b); // NOLINT(*-reinterpret-cast)
+    const auto* data = reinterpret_cast<const std::byte*>(b.data()); // NOLINT(*-reinterpret-cast)
+    ASL_TEST_EXPECT(data >= obj && data < obj + sizeof(b)); // NOLINT(*-pointer-arithmetic)
+
+    b.push(Request{ .id = 4, .data = {} });
+    ASL_TEST_EXPECT(b.size() == 5);
+    ASL_TEST_EXPECT(b.capacity() == 8);
+    ASL_TEST_EXPECT(stats.alloc_count == 1);
+
+    for (uint64_t i = 5; i < 20; ++i)
+    {
+        b.push(Request{ .id = i, .data = {} });
+    }
+    ASL_TEST_EXPECT(b.capacity() == 32);
+
+    for (isize_t i = 0; i < 20; ++i)
+    {
+        ASL_TEST_EXPECT(b[i].id == static_cast<uint64_t>(i));
+    }
+
+    b.destroy();
+    ASL_TEST_EXPECT(b.capacity() == 4);
+    ASL_TEST_EXPECT(stats.alive_bytes == 0);
+}
+
+ASL_TEST(from_span)
+{
+    int32_t data[] = {1, 2, 3, 4, 5, 6};
+
+    const asl::inline_buffer<int32_t, 8> b1{data};
+    ASL_TEST_EXPECT(b1.size() == 6);
+    ASL_TEST_EXPECT(b1.capacity() == 8);
+
+    const asl::inline_buffer<int32_t, 2> b2{data};
+    ASL_TEST_EXPECT(b2.size() == 6);
+
+    for (isize_t i = 0; i < 6; ++i)
+    {
+        ASL_TEST_EXPECT(b1[i] == i + 1);
+        ASL_TEST_EXPECT(b2[i] == i + 1);
+    }
+}
+
+ASL_TEST(clear_destructor)
+{
+    bool d[5]{};
+    asl::inline_buffer<DestructorObserver, 3> b;
+
+    for (bool& x: d) { b.push(&x); }
+    ASL_TEST_EXPECT(b.size() == 5);
+
+    for (const bool x: d) { ASL_TEST_EXPECT(!x); }
+
+    b.clear();
+    for (const bool x: d) { ASL_TEST_EXPECT(x); }
+}
+
+ASL_TEST(move_construct_from_inline)
+{
+    bool d[2]{};
+    asl::inline_buffer<DestructorObserver, 3> b;
+    b.push(&d[0]);
+    b.push(&d[1]);
+
+    {
+        const asl::inline_buffer<DestructorObserver, 3> b2(std::move(b));
+        ASL_TEST_EXPECT(b2.size() == 2);
+        ASL_TEST_EXPECT(b.size() == 0); // NOLINT(*-use-after-move)
+        ASL_TEST_EXPECT(!d[0]);
+        ASL_TEST_EXPECT(!d[1]);
+    }
+
+    ASL_TEST_EXPECT(d[0]);
+    ASL_TEST_EXPECT(d[1]);
+}
+
+ASL_TEST(move_construct_from_heap)
+{
+    CountingAllocator::Stats stats;
+    asl::inline_buffer<int64_t, 2, CountingAllocator> b(CountingAllocator{&stats});
+    b.push(1);
+    b.push(2);
+    b.push(3);
+    ASL_TEST_EXPECT(stats.alloc_count == 1);
+
+    const auto* heap_data = b.data();
+
+    {
+        const asl::inline_buffer<int64_t, 2, CountingAllocator> b2(std::move(b));
+        ASL_TEST_EXPECT(b2.size() == 3);
+        ASL_TEST_EXPECT(b2.data() == heap_data);
+        ASL_TEST_EXPECT(b.capacity() == 2); // NOLINT(*-use-after-move)
+        ASL_TEST_EXPECT(stats.alloc_count == 1);
+    }
+
+    ASL_TEST_EXPECT(stats.dealloc_count == 1);
+    ASL_TEST_EXPECT(stats.alive_bytes == 0);
+}
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(move_assign)
+{
+    bool d[6]{};
+
+    asl::inline_buffer<DestructorObserver, 2> heap;
+    heap.push(&d[0]);
+    heap.push(&d[1]);
+    heap.push(&d[2]);
+
+    asl::inline_buffer<DestructorObserver, 2> small;
+    small.push(&d[3]);
+
+    // Heap into inline.
+    small = std::move(heap);
+    ASL_TEST_EXPECT(small.size() == 3);
+    ASL_TEST_EXPECT(heap.size() == 0); // NOLINT(*-use-after-move)
+    ASL_TEST_EXPECT(d[3]);
+    ASL_TEST_EXPECT(!d[0] && !d[1] && !d[2]);
+
+    // Inline into heap, which keeps its allocation.
+    asl::inline_buffer<DestructorObserver, 2> other;
+    other.push(&d[4]);
+    other.push(&d[5]);
+
+    small = std::move(other);
+    ASL_TEST_EXPECT(small.size() == 2);
+    ASL_TEST_EXPECT(small.capacity() == 4);
+    ASL_TEST_EXPECT(d[0] && d[1] && d[2]);
+    ASL_TEST_EXPECT(!d[4] && !d[5]);
+    ASL_TEST_EXPECT(small[0].destroyed == &d[4]);
+    ASL_TEST_EXPECT(small[1].destroyed == &d[5]);
+}
+
+ASL_TEST(copy)
+{
+    asl::inline_buffer<int32_t, 4> b;
+    for (int32_t i = 0; i < 6; ++i) { b.push(i); }
+
+    const asl::inline_buffer<int32_t, 4> b2 = b;
+    ASL_TEST_EXPECT(b2.size() == 6);
+
+    asl::inline_buffer<int32_t, 4> b3;
+    b3.push(12);
+    b3 = b2;
+    ASL_TEST_EXPECT(b3.size() == 6);
+
+    for (int32_t i = 0; i < 6; ++i)
+    {
+        ASL_TEST_EXPECT(b2[i] == i);
+        ASL_TEST_EXPECT(b3[i] == i);
+    }
+}
+
+ASL_TEST(resize)
+{
+    asl::inline_buffer<int32_t, 4> b;
+    b.resize(3, 7);
+    ASL_TEST_EXPECT(b.size() == 3);
+    ASL_TEST_EXPECT(b.capacity() == 4);
+
+    b.resize(6);
+    ASL_TEST_EXPECT(b.size() == 6);
+    ASL_TEST_EXPECT(b[2] == 7);
+    ASL_TEST_EXPECT(b[3] == 0);
+    ASL_TEST_EXPECT(b[5] == 0);
+
+    b.resize(1);
+    ASL_TEST_EXPECT(b.size() == 1);
+    ASL_TEST_EXPECT(b[0] == 7);
+}
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(shrink_to_fit)
+{
+    CountingAllocator::Stats stats;
+    asl::inline_buffer<int32_t, 4, CountingAllocator> b(CountingAllocator{&stats});
+
+    for (int32_t i = 0; i < 10; ++i) { b.push(i); }
+    ASL_TEST_EXPECT(b.capacity() == 16);
+
+    b.shrink_to_fit();
+    ASL_TEST_EXPECT(b.capacity() == 10);
+
+    // Back to inline storage.
+    b.resize(3);
+    b.shrink_to_fit();
+    ASL_TEST_EXPECT(b.capacity() == 4);
+    ASL_TEST_EXPECT(stats.alive_bytes == 0);
+    ASL_TEST_EXPECT(b.size() == 3);
+    ASL_TEST_EXPECT(b[0] == 0);
+    ASL_TEST_EXPECT(b[2] == 2);
+}
+
+ASL_TEST(relocate)
+{
+    int moves = 0;
+    asl::inline_buffer<RelocatableType, 4> b;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        b.push(i, &moves);
+    }
+    b.shrink_to_fit();
+
+    // Spilling, growing and shrinking didn't move any element.
+    ASL_TEST_EXPECT(moves == 0);
+    for (int i = 0; i < 100; ++i)
+    {
+        ASL_TEST_EXPECT(b[i].value == i);
+    }
+}
+
+ASL_TEST(reserve_exact)
+{
+    CountingAllocator::Stats stats;
+    asl::inline_buffer<int64_t, 4, CountingAllocator> b(CountingAllocator{&stats});
+
+    b.reserve_exact(3);
+    ASL_TEST_EXPECT(b.capacity() == 4);
+    ASL_TEST_EXPECT(stats.any_alloc_count() == 0);
+
+    b.reserve_exact(7);
+    ASL_TEST_EXPECT(b.capacity() == 7);
+    ASL_TEST_EXPECT(stats.alloc_count == 1);
+}
@@ -6,8 +6,64 @@
 #include "asl/base/assert.hpp"
 #include "asl/base/bits.hpp"
 #include "asl/base/meta.hpp"
+#include "asl/base/memory_ops.hpp"
 #include "asl/base/numeric.hpp"
 
+namespace
+{
+
+// Characters of a formatted value, rendered on the stack before being
+// padded and written at once.
+template<isize_t kCapacity>
+class TextBuffer
+{
+    char    m_data[kCapacity]; // NOLINT(*-member-init)
+    isize_t m_size{};
+
+public:
+    TextBuffer() = default;
+    ASL_DELETE_COPY_MOVE(TextBuffer);
+    ~TextBuffer() = default;
+
+    void push(char c)
+    {
+        ASL_ASSERT(m_size < kCapacity);
+        m_data[m_size++] = c; // NOLINT(*-constant-array-index)
+    }
+
+    void append(asl::string_view s)
+    {
+        ASL_ASSERT(s.size() <= kCapacity - m_size);
+        asl::memcpy(m_data + m_size, s.data(), s.size()); // NOLINT(*-pointer-arithmetic)
+        m_size += s.size();
+    }
+
+    void append_n(char c, isize_t n)
+    {
+        ASL_ASSERT(n >= 0 && n <= kCapacity - m_size);
+        __builtin_memset(m_data + m_size, c, static_cast<size_t>(n)); // NOLINT(*-pointer-arithmetic)
+        m_size += n;
+    }
+
+    char& operator[](isize_t i)
+    {
+        ASL_ASSERT(i >= 0 && i < m_size);
+        return m_data[i]; // NOLINT(*-constant-array-index)
+    }
+
+    [[nodiscard]] isize_t size() const { return m_size; }
+
+    [[nodiscard]] asl::string_view substr(isize_t offset, isize_t count) const
+    {
+        ASL_ASSERT(offset >= 0 && count >= 0 && offset + count <= m_size);
+        return { m_data + offset, count }; // NOLINT(*-pointer-arithmetic)
+    }
+
+    [[nodiscard]] asl::string_view as_string_view() const { return { m_data, m_size }; }
+};
+
+}  // namespace
+
 void asl::format_internals::format(
     Writer* writer,
     string_view fmt,
@@ -23,35 +79,40 @@ void asl::format_internals::format(
     {
         if (fmt[i] == '{')
         {
-            if (i + 1 < fmt.size())
+            if (i + 1 < fmt.size() && fmt[i + 1] == '{')
             {
-                if (fmt[i + 1] == '}')
-                {
-                    f.write(fmt.substr(0, i));
-                    fmt = fmt.substr(i + 2);
-                    i = 0;
+                f.write(fmt.substr(0, i + 1));
+                fmt = fmt.substr(i + 2);
+                i = 0;
 
-                    if (arg_it == arg_end)
+                continue;
+            }
+
+            const isize_t end = find_placeholder_end(fmt, i);
+            if (end >= 0)
+            {
+                format_spec spec{};
+                const bool is_spec_valid = end == i + 1
+                    || parse_format_spec(fmt.substr(i + 2, end - i - 2), &spec);
+
+                f.write(fmt.substr(0, i));
+                fmt = fmt.substr(end + 1);
+                i = 0;
+
+                if (arg_it == arg_end)
+                {
+                    f.write("<ERROR>");
+                }
+                else
+                {
+                    if (!is_spec_valid || !arg_it->fn(f, arg_it->data, spec))
                     {
                         f.write("<ERROR>");
                     }
-                    else
-                    {
-                        arg_it->fn(f, arg_it->data);
-                        arg_it++;
-                    }
-
-                    continue;
+                    arg_it++;
                 }
 
-                if (fmt[i + 1] == '{')
-                {
-                    f.write(fmt.substr(0, i + 1));
-                    fmt = fmt.substr(i + 2);
-                    i = 0;
-
-                    continue;
-                }
+                continue;
             }
 
             f.write(fmt.substr(0, i));
@@ -75,11 +136,161 @@ void asl::format_internals::format(
     f.write(fmt);
 }
 
+void asl::format_internals::write_escaped(Formatter& f, string_view s)
+{
+    // Escapes are always doubled braces, we write up to and including
+    // the first brace, and skip the second one.
+    isize_t i = 0;
+    while (i + 1 < s.size())
+    {
+        if ((s[i] == '{' || s[i] == '}') && s[i + 1] == s[i])
+        {
+            f.write(s.first(i + 1));
+            s = s.substr(i + 2);
+            i = 0;
+        }
+        else
+        {
+            i += 1;
+        }
+    }
+
+    if (!s.is_empty())
+    {
+        f.write(s);
+    }
+}
+
+void asl::format_internals::format(
+    Writer* writer,
+    const parsed_format& fmt,
+    span<const type_erased_arg> args)
+{
+    if (fmt.segments.is_empty())
+    {
+        format(writer, fmt.runtime, args);
+        return;
+    }
+
+    ASL_ASSERT(fmt.segments.size() == args.size() + 1);
+
+    Formatter f(writer);
+    write_segment(f, fmt.segments[0]);
+
+    for (isize_t i = 0; i < args.size(); ++i)
+    {
+        // Specs were checked against the argument types at compile time.
+        args[i].fn(f, args[i].data, fmt.specs[i]);
+        write_segment(f, fmt.segments[i + 1]);
+    }
+}
+
+void asl::Formatter::write_padded(
+    string_view text,
+    const format_spec& spec,
+    format_align default_align,
+    isize_t prefix_size)
+{
+    const isize_t padding = spec.width - text.size();
+    if (padding <= 0)
+    {
+        write(text);
+        return;
+    }
+
+    // The width is bounded, so the padded text always fits.
+    TextBuffer<kMaxFormatWidth> buffer;
+
+    if (spec.zero_pad && spec.align == format_align::kDefault)
+    {
+        buffer.append(text.first(prefix_size));
+        buffer.append_n('0', padding);
+        buffer.append(text.substr(prefix_size));
+    }
+    else
+    {
+        const format_align align = spec.align == format_align::kDefault ? default_align : spec.align;
+
+        isize_t before = padding;
+        if (align == format_align::kLeft) { before = 0; }
+        else if (align == format_align::kCenter) { before = padding / 2; }
+
+        buffer.append_n(spec.fill, before);
+        buffer.append(text);
+        buffer.append_n(spec.fill, padding - before);
+    }
+
+    write(buffer.as_string_view());
+}
+
+namespace
+{
+
+// Keeps the output of a value for padding it. Once it's longer than any
+// width it can't need padding, so it's passed through instead.
+class PaddingWriter : public asl::Writer
+{
+    asl::Writer*                     m_next;
+    TextBuffer<asl::kMaxFormatWidth> m_buffer;
+    bool                             m_passthrough{};
+
+public:
+    explicit PaddingWriter(asl::Writer* next)
+        : m_next{next}
+    {}
+
+    ASL_DELETE_COPY_MOVE(PaddingWriter);
+    ~PaddingWriter() override = default;
+
+    void write(asl::span<const std::byte> s) override
+    {
+        if (!m_passthrough && s.size() <= asl::kMaxFormatWidth - m_buffer.size())
+        {
+            m_buffer.append({ reinterpret_cast<const char*>(s.data()), s.size() }); // NOLINT(*-reinterpret-cast)
+            return;
+        }
+
+        if (!m_passthrough)
+        {
+            m_passthrough = true;
+            m_next->write(asl::as_bytes(m_buffer.as_string_view().as_span()));
+        }
+        m_next->write(s);
+    }
+
+    [[nodiscard]] bool is_passthrough() const { return m_passthrough; }
+
+    [[nodiscard]] asl::string_view contents() const { return m_buffer.as_string_view(); }
+};
+
+}  // namespace
+
+void asl::format_internals::format_padded(
+    Formatter& f,
+    const format_spec& spec,
+    const void* data,
+    void (*fn)(Formatter&, const void*))
+{
+    PaddingWriter writer{f.writer()};
+    Formatter inner{&writer};
+    fn(inner, data);
+
+    if (!writer.is_passthrough())
+    {
+        f.write_padded(writer.contents(), spec, format_align::kLeft);
+    }
+}
+
 void asl::AslFormat(Formatter& f, const char* str)
 {
     f.write({str, asl::strlen(str)});
 }
 
+void asl::AslFormat(Formatter& f, const char* str, const format_spec& spec)
+{
+    f.write_padded({str, asl::strlen(str)}, spec, format_align::kLeft);
+}
+
 void asl::AslFormat(Formatter& f, bool v)
 {
     if (v)
@@ -92,6 +303,11 @@ void asl::AslFormat(Formatter& f, bool v)
     }
 }
 
+void asl::AslFormat(Formatter& f, bool v, const format_spec& spec)
+{
+    f.write_padded(v ? "true"_sv : "false"_sv, spec, format_align::kLeft);
+}
+
 void asl::AslFormat(Formatter& f, uint8_t v)
 {
     AslFormat(f, static_cast<uint64_t>(v));
@@ -204,20 +420,175 @@ void asl::AslFormat(Formatter& f, int64_t v)
         AslFormat(f, static_cast<uint64_t>(v));
     }
 }
-static constexpr isize_t kZeroCount = 100;
-static constexpr char kZeros[kZeroCount] = {
-    '0', '0', '0', '0', '0', '0', '0', '0', '0', '0',
-    '0', '0', '0', '0', '0', '0', '0', '0', '0', '0',
-    '0', '0', '0', '0', '0', '0', '0', '0', '0', '0',
-    '0', '0', '0', '0', '0', '0', '0', '0', '0', '0',
-    '0', '0', '0', '0', '0', '0', '0', '0', '0', '0',
-    '0', '0', '0', '0', '0', '0', '0', '0', '0', '0',
-    '0', '0', '0', '0', '0', '0', '0', '0', '0', '0',
-    '0', '0', '0', '0', '0', '0', '0', '0', '0', '0',
-    '0', '0', '0', '0', '0', '0', '0', '0', '0', '0',
-    '0', '0', '0', '0', '0', '0', '0', '0', '0', '0',
+
+namespace
+{
+
+// Digits of every byte value, so hex is written a byte at a time.
+struct HexPairs
+{
+    char chars[512];
 };
 
+// Digits of every nibble value, so binary is written 4 bits at a time.
+struct BinaryNibbles
+{
+    char chars[64];
+};
+
+}  // namespace
+
+static constexpr HexPairs make_hex_pairs(asl::string_view digits)
+{
+    HexPairs pairs{};
+    for (isize_t i = 0; i < 256; ++i)
+    {
+        pairs.chars[i * 2] = digits[i >> 4]; // NOLINT(*-constant-array-index)
+        pairs.chars[i * 2 + 1] = digits[i & 15]; // NOLINT(*-constant-array-index)
+    }
+    return pairs;
+}
+
+static constexpr BinaryNibbles make_binary_nibbles()
+{
+    BinaryNibbles nibbles{};
+    for (isize_t i = 0; i < 16; ++i)
+    {
+        for (isize_t bit = 0; bit < 4; ++bit)
+        {
+            nibbles.chars[i * 4 + bit] = ((i >> (3 - bit)) & 1) != 0 ? '1' : '0'; // NOLINT(*-constant-array-index)
+        }
+    }
+    return nibbles;
+}
+
+static constexpr HexPairs kHexPairsLower = make_hex_pairs("0123456789abcdef");
+static constexpr HexPairs kHexPairsUpper = make_hex_pairs("0123456789ABCDEF");
+static constexpr BinaryNibbles kBinaryNibbles = make_binary_nibbles();
+
+static asl::string_view format_hex(uint64_t v, asl::span<char, 16> buffer, const HexPairs& pairs)
+{
+    const isize_t digit_count = (asl::bit_width(v | 1) + 3) / 4;
+
+    // Whole bytes are written, the leading zero of an odd count is cut.
+    isize_t cursor = buffer.size();
+    do
+    {
+        cursor -= 2;
+        asl::memcpy(buffer.data() + cursor, pairs.chars + (v & 0xff) * 2, 2); // NOLINT(*-pointer-arithmetic)
+        v >>= 8;
+    } while (v != 0);
+
+    return asl::string_view(buffer.data(), buffer.size()).last(digit_count);
+}
+
+static asl::string_view format_binary(uint64_t v, asl::span<char, 64> buffer)
+{
+    const isize_t digit_count = asl::bit_width(v | 1);
+
+    isize_t cursor = buffer.size();
+    do
+    {
+        cursor -= 4;
+        asl::memcpy(buffer.data() + cursor, kBinaryNibbles.chars + (v & 0xf) * 4, 4); // NOLINT(*-pointer-arithmetic)
+        v >>= 4;
+    } while (v != 0);
+
+    return asl::string_view(buffer.data(), buffer.size()).last(digit_count);
+}
+
+static void format_integer(asl::Formatter& f, uint64_t magnitude, bool is_negative, const asl::format_spec& spec)
+{
+    // Digits are written at the end of the buffer, so that the sign and
+    // base prefix can go right before them.
+    static constexpr isize_t kPrefixCapacity = 3;
+    static constexpr isize_t kCapacity = kPrefixCapacity + 64;
+
+    char buffer[kCapacity];
+    const auto digits_buffer = asl::span<char, kCapacity>(buffer).last<64>();
+
+    asl::string_view digits;
+    asl::string_view base_prefix;
+    switch (spec.type)
+    {
+        case asl::format_type::kHex:
+            digits = format_hex(magnitude, digits_buffer.last<16>(), kHexPairsLower);
+            base_prefix = "0x";
+            break;
+        case asl::format_type::kHexUpper:
+            digits = format_hex(magnitude, digits_buffer.last<16>(), kHexPairsUpper);
+            base_prefix = "0X";
+            break;
+        case asl::format_type::kBinary:
+            digits = format_binary(magnitude, digits_buffer);
+            base_prefix = "0b";
+            break;
+        case asl::format_type::kDefault:
+        case asl::format_type::kDecimal:
+        case asl::format_type::kFixed:
+        case asl::format_type::kExponent:
+        default:
+            digits = asl::format_uint64(magnitude, digits_buffer.last<kMaxUint64Digits>());
+            break;
+    }
+
+    isize_t begin = kCapacity - digits.size();
+    if (spec.alternate)
+    {
+        begin -= base_prefix.size();
+        asl::memcpy(buffer + begin, base_prefix.data(), base_prefix.size()); // NOLINT(*-pointer-arithmetic)
+    }
+    if (is_negative)
+    {
+        begin -= 1;
+        buffer[begin] = '-'; // NOLINT(*-constant-array-index)
+    }
+
+    const isize_t prefix_size = kCapacity - digits.size() - begin;
+    f.write_padded(asl::string_view(buffer + begin, kCapacity - begin), spec, asl::format_align::kRight, prefix_size); // NOLINT(*-pointer-arithmetic)
+}
+
+void asl::AslFormat(Formatter& f, uint8_t v, const format_spec& spec)
+{
+    format_integer(f, v, false, spec);
+}
+
+void asl::AslFormat(Formatter& f, uint16_t v, const format_spec& spec)
+{
+    format_integer(f, v, false, spec);
+}
+
+void asl::AslFormat(Formatter& f, uint32_t v, const format_spec& spec)
+{
+    format_integer(f, v, false, spec);
+}
+
+void asl::AslFormat(Formatter& f, uint64_t v, const format_spec& spec)
+{
+    format_integer(f, v, false, spec);
+}
+
+void asl::AslFormat(Formatter& f, int8_t v, const format_spec& spec)
+{
+    AslFormat(f, static_cast<int64_t>(v), spec);
+}
+
+void asl::AslFormat(Formatter& f, int16_t v, const format_spec& spec)
+{
+    AslFormat(f, static_cast<int64_t>(v), spec);
+}
+
+void asl::AslFormat(Formatter& f, int32_t v, const format_spec& spec)
+{
+    AslFormat(f, static_cast<int64_t>(v), spec);
+}
+
+void asl::AslFormat(Formatter& f, int64_t v, const format_spec& spec)
+{
+    const auto bits = std::bit_cast<uint64_t>(v);
+    format_integer(f, v < 0 ? ~(bits - 1) : bits, v < 0, spec);
+}
+
 static constexpr bool is_zero(float32_t x)
 {
     return (std::bit_cast<uint32_t>(x) & 0x7fff'ffffU) == 0;
@@ -245,85 +616,435 @@ void jkj_dragonbox_to_decimal(
 
 } // namespace asl
 
-template<asl::is_floating_point T>
-static void format_float(asl::Formatter& f, T value)
+// Enough 32-bit limbs for the 1074 bits of the smallest fractional part,
+// and the 1024 bits of the largest integer part.
+static constexpr int kMaxLimbs = 34;
+
+// Exact decimal digits are produced 9 at a time, with 32-bit limbs
+// multiplied or divided by 10^9 in 64-bit arithmetic.
+static constexpr uint32_t kChunkBase = 1'000'000'000;
+static constexpr isize_t kChunkDigits = 9;
+
+namespace
+{
+
+// Doubles are m * 2^e, with m < 2^53 and -1074 <= e <= 971.
+struct binary_float
 {
-    if (asl::is_infinity(value))
+    uint64_t mantissa;
+    int      exponent;
+};
+
+// Integer part of the largest double, or leading zeros of the smallest
+// one, plus kMaxFormatPrecision digits and a chunk to round with.
+using DigitBuffer = TextBuffer<768>;
+
+// Fractional part of a double, as an integer of `bits` bits over 2^bits.
+// Multiplying it by 10^9 moves the next 9 decimal digits above those bits.
+class FractionDigits
+{
+    uint32_t m_limbs[kMaxLimbs]{};
+    int      m_size{};
+    int      m_low{};
+    int      m_top_bits{};
+
+    void skip_zero_limbs()
     {
-        if (value > 0)
+        // Limbs below m_low are zero, and stay zero when multiplying.
+        while (m_low < m_size && m_limbs[m_low] == 0) // NOLINT(*-constant-array-index)
         {
-            f.write("Infinity"_sv);
+            m_low += 1;
         }
-        else
+    }
+
+public:
+    explicit FractionDigits(binary_float v)
+    {
+        if (v.exponent >= 0) { return; }
+
+        const int bits = -v.exponent;
+        const uint64_t fraction = bits >= 64
+            ? v.mantissa
+            : v.mantissa & ((uint64_t{1} << bits) - 1);
+
+        m_size = (bits + 31) / 32;
+        m_top_bits = bits - (m_size - 1) * 32;
+        m_limbs[0] = static_cast<uint32_t>(fraction);
+        if (m_size > 1)
+        {
+            m_limbs[1] = static_cast<uint32_t>(fraction >> 32);
+        }
+
+        skip_zero_limbs();
+    }
+
+    [[nodiscard]] bool is_zero() const { return m_low == m_size; }
+
+    uint32_t next_chunk()
+    {
+        uint64_t carry = 0;
+        for (int i = m_low; i < m_size; ++i)
+        {
+            const uint64_t product = uint64_t{m_limbs[i]} * kChunkBase + carry; // NOLINT(*-constant-array-index)
+            m_limbs[i] = static_cast<uint32_t>(product); // NOLINT(*-constant-array-index)
+            carry = product >> 32;
+        }
+
+        uint64_t chunk = carry;
+        if (m_top_bits < 32)
+        {
+            uint32_t& top = m_limbs[m_size - 1]; // NOLINT(*-constant-array-index)
+            chunk = (carry << (32 - m_top_bits)) | (top >> m_top_bits);
+            top &= (uint32_t{1} << m_top_bits) - 1;
+        }
+
+        skip_zero_limbs();
+
+        ASL_ASSERT(chunk < kChunkBase);
+        return static_cast<uint32_t>(chunk);
+    }
+};
+
+}  // namespace
+
+static binary_float decompose(float64_t value)
+{
+    const auto bits = std::bit_cast<uint64_t>(value);
+    const auto biased_exponent = static_cast<int>((bits >> 52) & 0x7ff);
+    const uint64_t fraction = bits & ((uint64_t{1} << 52) - 1);
+
+    if (biased_exponent == 0)
+    {
+        return { .mantissa = fraction, .exponent = -1074 };
+    }
+    return { .mantissa = fraction | (uint64_t{1} << 52), .exponent = biased_exponent - 1075 };
+}
+
+static void append_chunk(DigitBuffer* out, uint32_t chunk)
+{
+    char buffer[20];
+    const asl::string_view digits = asl::format_uint64(chunk, buffer);
+    out->append_n('0', kChunkDigits - digits.size());
+    out->append(digits);
+}
+
+// Appends the digits of the integer part of v, nothing when it's zero.
+static void append_integer_digits(DigitBuffer* out, binary_float v)
+{
+    char buffer[20];
+
+    if (v.exponent < 0)
+    {
+        if (v.exponent > -64 && (v.mantissa >> -v.exponent) > 0)
         {
-            f.write("-Infinity"_sv);
+            out->append(asl::format_uint64(v.mantissa >> -v.exponent, buffer));
         }
         return;
     }
 
-    if (is_zero(value))
+    if (v.exponent <= 11)
     {
-        f.write("0"_sv);
+        out->append(asl::format_uint64(v.mantissa << v.exponent, buffer));
         return;
     }
 
-    if (asl::is_nan(value))
+    uint32_t limbs[kMaxLimbs]{};
+    const int offset = v.exponent / 32;
+    const int shift = v.exponent % 32;
+
+    // NOLINTBEGIN(*-constant-array-index)
+    limbs[offset] = static_cast<uint32_t>(v.mantissa << shift);
+    limbs[offset + 1] = static_cast<uint32_t>(v.mantissa >> (32 - shift));
+    limbs[offset + 2] = shift == 0 ? 0 : static_cast<uint32_t>(v.mantissa >> (64 - shift));
+
+    int size = offset + 3;
+    while (limbs[size - 1] == 0) { size -= 1; }
+
+    // Converted to base 10^9 by repeated division, least significant first.
+    uint32_t chunks[35];
+    int chunk_count = 0;
+    while (size > 0)
     {
-        f.write("NaN"_sv);
+        uint64_t remainder = 0;
+        for (int i = size - 1; i >= 0; --i)
+        {
+            const uint64_t current = (remainder << 32) | limbs[i];
+            limbs[i] = static_cast<uint32_t>(current / kChunkBase);
+            remainder = current % kChunkBase;
+        }
+
+        chunks[chunk_count++] = static_cast<uint32_t>(remainder);
+        while (size > 0 && limbs[size - 1] == 0) { size -= 1; }
+    }
+
+    out->append(asl::format_uint64(chunks[chunk_count - 1], buffer));
+    for (int i = chunk_count - 2; i >= 0; --i)
+    {
+        append_chunk(out, chunks[i]);
+    }
+    // NOLINTEND(*-constant-array-index)
+}
+
+// Keeps the first `keep` digits, rounding to nearest with ties to even.
+// The digits after them, and whether anything non-zero follows those,
+// decide the direction. Returns true when rounding up carries out of
+// the first digit, which leaves them all zero.
+static bool round_digits(DigitBuffer* digits, isize_t first, isize_t keep, bool sticky)
+{
+    const isize_t next = first + keep;
+    if (next >= digits->size()) { return false; }
+
+    bool round_up = (*digits)[next] > '5';
+    if ((*digits)[next] == '5')
+    {
+        bool is_tie = !sticky;
+        for (isize_t i = next + 1; is_tie && i < digits->size(); ++i)
+        {
+            is_tie = (*digits)[i] == '0';
+        }
+
+        const bool is_odd = keep > 0 && ((*digits)[next - 1] - '0') % 2 == 1;
+        round_up = !is_tie || is_odd;
+    }
+
+    if (!round_up) { return false; }
+
+    for (isize_t i = next - 1; i >= first; --i)
+    {
+        if ((*digits)[i] != '9')
+        {
+            (*digits)[i] = static_cast<char>((*digits)[i] + 1);
+            return false;
+        }
+        (*digits)[i] = '0';
+    }
+
+    return true;
+}
+
+template<isize_t N>
+static void append_exponent_suffix(TextBuffer<N>* out, int exponent)
+{
+    out->push('e');
+    out->push(exponent < 0 ? '-' : '+');
+    if (exponent > -10 && exponent < 10)
+    {
+        out->push('0');
+    }
+
+    char buffer[20];
+    out->append(asl::format_uint64(static_cast<uint64_t>(exponent < 0 ? -exponent : exponent), buffer));
+}
+
+// Appends v with `precision` decimals, correctly rounded from its exact
+// binary value like printf's %.*f.
+template<isize_t N>
+static void append_fixed(TextBuffer<N>* out, binary_float v, isize_t precision)
+{
+    DigitBuffer digits;
+    append_integer_digits(&digits, v);
+    const isize_t integer_size = digits.size();
+
+    FractionDigits fraction{v};
+    while (digits.size() - integer_size <= precision && !fraction.is_zero())
+    {
+        append_chunk(&digits, fraction.next_chunk());
+    }
+
+    if (digits.size() < integer_size + precision)
+    {
+        digits.append_n('0', integer_size + precision - digits.size());
+    }
+
+    if (round_digits(&digits, 0, integer_size + precision, !fraction.is_zero()))
+    {
+        out->push('1');
+    }
+    else if (integer_size == 0)
+    {
+        out->push('0');
+    }
+
+    out->append(digits.substr(0, integer_size));
+    if (precision > 0)
+    {
+        out->push('.');
+        out->append(digits.substr(integer_size, precision));
+    }
+}
+
+// Appends v with one digit before the point and `precision` after it,
+// correctly rounded like printf's %.*e.
+template<isize_t N>
+static void append_exponent(TextBuffer<N>* out, binary_float v, isize_t precision)
+{
+    if (v.mantissa == 0)
+    {
+        out->push('0');
+        if (precision > 0)
+        {
+            out->push('.');
+            out->append_n('0', precision);
+        }
+        append_exponent_suffix(out, 0);
         return;
     }
 
-    bool is_negative{};
-    int exponent{};
-    uint64_t significand{};
+    DigitBuffer digits;
+    append_integer_digits(&digits, v);
+    const isize_t integer_size = digits.size();
 
-    asl::jkj_dragonbox_to_decimal(value, &is_negative, &exponent, &significand);
+    // Below 1, the fractional part starts with zeros that we skip.
+    FractionDigits fraction{v};
+    isize_t first = integer_size > 0 ? 0 : -1;
+    while (!fraction.is_zero() && (first < 0 || digits.size() - first <= precision + 1))
+    {
+        const isize_t chunk_begin = digits.size();
+        append_chunk(&digits, fraction.next_chunk());
+
+        for (isize_t i = chunk_begin; first < 0 && i < digits.size(); ++i)
+        {
+            if (digits[i] != '0') { first = i; }
+        }
+    }
 
-    if (is_negative) { f.write("-"); }
+    ASL_ASSERT(first >= 0);
+    if (digits.size() < first + precision + 1)
+    {
+        digits.append_n('0', first + precision + 1 - digits.size());
+    }
+
+    auto exponent = static_cast<int>(integer_size - 1 - first);
+    if (round_digits(&digits, first, precision + 1, !fraction.is_zero()))
+    {
+        digits[first] = '1';
+        exponent += 1;
+    }
 
+    out->push(digits[first]);
+    if (precision > 0)
+    {
+        out->push('.');
+        out->append(digits.substr(first + 1, precision));
+    }
+    append_exponent_suffix(out, exponent);
+}
+
+// Appends the shortest digits that round-trip, from dragonbox.
+template<isize_t N>
+static void append_shortest(TextBuffer<N>* out, uint64_t significand, int exponent, bool scientific)
+{
     char buffer[20];
     const asl::string_view digits = asl::format_uint64(significand, buffer);
 
-    if (exponent >= 0)
+    if (scientific)
     {
-        f.write(digits);
-        while (exponent > 0)
+        out->push(digits[0]);
+        if (digits.size() > 1)
         {
-            const isize_t to_write = asl::min(static_cast<isize_t>(exponent), kZeroCount);
-            f.write(asl::string_view(static_cast<const char*>(kZeros), to_write));
-            exponent -= static_cast<int>(to_write);
+            out->push('.');
+            out->append(digits.substr(1));
         }
+        append_exponent_suffix(out, exponent + static_cast<int>(digits.size()) - 1);
+    }
+    else if (exponent >= 0)
+    {
+        out->append(digits);
+        out->append_n('0', exponent);
+    }
+    else if (digits.size() <= -exponent)
+    {
+        out->append("0.");
+        out->append_n('0', -exponent - digits.size());
+        out->append(digits);
     }
     else
     {
-        if (digits.size() <= -exponent)
+        out->append(digits.first(digits.size() + exponent));
+        out->push('.');
+        out->append(digits.last(-exponent));
+    }
+}
+
+// The longest text is the 309 integer digits of the largest double
+// followed by kMaxFormatPrecision decimals.
+using FloatText = TextBuffer<512>;
+
+template<asl::is_floating_point T>
+static void format_float(asl::Formatter& f, T value, const asl::format_spec& spec)
+{
+    if (asl::is_infinity(value) || asl::is_nan(value))
+    {
+        asl::format_spec text_spec = spec;
+        text_spec.zero_pad = false;
+
+        asl::string_view text = "NaN";
+        if (asl::is_infinity(value))
         {
-            f.write("0.");
-            exponent = -exponent - static_cast<int>(digits.size());
-            while (exponent > 0)
-            {
-                const isize_t to_write = asl::min(static_cast<isize_t>(exponent), kZeroCount);
-                f.write(asl::string_view(static_cast<const char*>(kZeros), to_write));
-                exponent -= static_cast<int>(to_write);
-            }
-            f.write(digits);
+            text = value > 0 ? "Infinity"_sv : "-Infinity"_sv;
+        }
+
+        f.write_padded(text, text_spec, asl::format_align::kRight);
+        return;
+    }
+
+    FloatText text;
+    isize_t sign_size = 0;
+    if (value < 0)
+    {
+        text.push('-');
+        sign_size = 1;
+    }
+
+    const T magnitude = value < 0 ? -value : value;
+    const bool scientific = spec.type == asl::format_type::kExponent;
+
+    if (spec.precision >= 0)
+    {
+        // Floats convert exactly to doubles, so one implementation does.
+        const binary_float v = decompose(static_cast<float64_t>(magnitude));
+        if (scientific)
+        {
+            append_exponent(&text, v, spec.precision);
         }
         else
         {
-            f.write(digits.first(digits.size() + exponent));
-            f.write(".");
-            f.write(digits.last(-exponent));
+            append_fixed(&text, v, spec.precision);
         }
     }
+    else if (is_zero(magnitude))
+    {
+        text.append(scientific ? "0e+00"_sv : "0"_sv);
+    }
+    else
+    {
+        bool is_negative{};
+        int exponent{};
+        uint64_t significand{};
+
+        asl::jkj_dragonbox_to_decimal(magnitude, &is_negative, &exponent, &significand);
+        append_shortest(&text, significand, exponent, scientific);
+    }
+
+    f.write_padded(text.as_string_view(), spec, asl::format_align::kRight, sign_size);
 }
 
 void asl::AslFormat(Formatter& f, float32_t value)
 {
-    format_float(f, value);
+    format_float(f, value, format_spec{});
 }
 
 void asl::AslFormat(Formatter& f, float64_t value)
 {
-    format_float(f, value);
+    format_float(f, value, format_spec{});
 }
 
+void asl::AslFormat(Formatter& f, float32_t value, const format_spec& spec)
+{
+    format_float(f, value, spec);
+}
+
+void asl::AslFormat(Formatter& f, float64_t value, const format_spec& spec)
+{
+    format_float(f, value, spec);
+}
@@ -16,24 +16,210 @@ namespace asl
 
 class Formatter;
 
+enum class format_align : uint8_t
+{
+    kDefault,
+    kLeft,
+    kRight,
+    kCenter,
+};
+
+enum class format_type : uint8_t
+{
+    kDefault,
+    kDecimal,
+    kHex,
+    kHexUpper,
+    kBinary,
+    kFixed,
+    kExponent,
+};
+
+// Padded values and float digits are rendered in stack buffers, which
+// these bounds keep small.
+inline constexpr isize_t kMaxFormatWidth = 256;
+inline constexpr isize_t kMaxFormatPrecision = 100;
+
+// Parsed from the part of a placeholder after a colon:
+//
+//     {:[[fill]align][#][0][width][.precision][type]}
+//
+// - fill is a single ASCII character, a space by default.
+// - align is < (left), > (right) or ^ (center). Numbers are aligned
+//   to the right by default, everything else to the left.
+// - # adds a 0x, 0X or 0b prefix to hex and binary integers.
+// - 0 pads numbers with zeros after their sign and prefix.
+// - precision is the number of decimals of floats, or digits after the
+//   point with e. Without it, floats use their shortest representation.
+// - type is d, x, X or b for integers, and f or e for floats.
+//
+// Types other than numbers only take fill, alignment and width.
+struct format_spec
+{
+    uint16_t     width{};
+    int16_t      precision = -1;
+    char         fill = ' ';
+    format_align align = format_align::kDefault;
+    format_type  type = format_type::kDefault;
+    bool         zero_pad{};
+    bool         alternate{};
+
+    // Fill, alignment and zero padding have no effect without a width.
+    [[nodiscard]] constexpr bool is_default() const
+    {
+        return width == 0 && precision < 0 && type == format_type::kDefault && !alternate;
+    }
+};
+
 template<typename T>
 concept formattable = requires (Formatter& f, const T& value)
 {
     AslFormat(f, value);
 };
 
+// Types can handle specs themselves with an overload taking a
+// format_spec, the output of other types is padded to the width.
+template<typename T>
+concept formattable_with_spec = formattable<T> && requires (Formatter& f, const T& value, const format_spec& spec)
+{
+    AslFormat(f, value, spec);
+};
+
 namespace format_internals
 {
 
+// Parses the part of a placeholder after the colon, returns false when
+// it's not a valid spec.
+constexpr bool parse_format_spec(string_view s, format_spec* spec)
+{
+    auto to_align = [](char c) {
+        switch (c)
+        {
+            case '<': return format_align::kLeft;
+            case '>': return format_align::kRight;
+            case '^': return format_align::kCenter;
+            default: return format_align::kDefault;
+        }
+    };
+
+    auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+
+    isize_t i = 0;
+    if (s.size() >= 2 && to_align(s[1]) != format_align::kDefault)
+    {
+        if (s[0] == '{') { return false; }
+        spec->fill = s[0];
+        spec->align = to_align(s[1]);
+        i = 2;
+    }
+    else if (!s.is_empty() && to_align(s[0]) != format_align::kDefault)
+    {
+        spec->align = to_align(s[0]);
+        i = 1;
+    }
+
+    if (i < s.size() && s[i] == '#')
+    {
+        spec->alternate = true;
+        i += 1;
+    }
+
+    if (i < s.size() && s[i] == '0')
+    {
+        spec->zero_pad = true;
+        i += 1;
+    }
+
+    isize_t width = 0;
+    while (i < s.size() && is_digit(s[i]))
+    {
+        width = width * 10 + (s[i] - '0');
+        if (width > kMaxFormatWidth) { return false; }
+        i += 1;
+    }
+    spec->width = static_cast<uint16_t>(width);
+
+    if (i < s.size() && s[i] == '.')
+    {
+        i += 1;
+
+        const isize_t digits_begin = i;
+        isize_t precision = 0;
+        while (i < s.size() && is_digit(s[i]))
+        {
+            precision = precision * 10 + (s[i] - '0');
+            if (precision > kMaxFormatPrecision) { return false; }
+            i += 1;
+        }
+
+        if (i == digits_begin) { return false; }
+        spec->precision = static_cast<int16_t>(precision);
+    }
+
+    if (i < s.size())
+    {
+        switch (s[i])
+        {
+            case 'd': spec->type = format_type::kDecimal; break;
+            case 'x': spec->type = format_type::kHex; break;
+            case 'X': spec->type = format_type::kHexUpper; break;
+            case 'b': spec->type = format_type::kBinary; break;
+            case 'f': spec->type = format_type::kFixed; break;
+            case 'e': spec->type = format_type::kExponent; break;
+            default: return false;
+        }
+        i += 1;
+    }
+
+    return i == s.size();
+}
+
+// Presentation types and precision only apply to numbers.
+template<typename T>
+constexpr bool is_valid_spec(const format_spec& spec)
+{
+    if constexpr (is_integral<T> && !is_same<T, bool>)
+    {
+        return spec.precision < 0 && (
+            spec.type == format_type::kDefault ||
+            spec.type == format_type::kDecimal ||
+            spec.type == format_type::kHex ||
+            spec.type == format_type::kHexUpper ||
+            spec.type == format_type::kBinary);
+    }
+    else if constexpr (is_floating_point<T>)
+    {
+        return !spec.alternate && (
+            spec.type == format_type::kDefault ||
+            spec.type == format_type::kFixed ||
+            spec.type == format_type::kExponent);
+    }
+    else
+    {
+        return spec.precision < 0
+            && !spec.alternate
+            && !spec.zero_pad
+            && spec.type == format_type::kDefault;
+    }
+}
+
+template<formattable T>
+constexpr void format_arg(Formatter& f, const T& value, const format_spec& spec);
+
 struct type_erased_arg
 {
     const void* data;
-    void (*fn)(Formatter&, const void*);
+
+    // Returns false, without writing anything, when the spec doesn't
+    // apply to the type of the argument.
+    bool (*fn)(Formatter&, const void*, const format_spec&);
 
     template<formattable T>
-    static constexpr void erased_fn(Formatter& f, const void* data)
+    static constexpr bool erased_fn(Formatter& f, const void* data, const format_spec& spec)
     {
-        AslFormat(f, *static_cast<const T*>(data));
+        if (!is_valid_spec<T>(spec)) { return false; }
+        format_arg(f, *static_cast<const T*>(data), spec);
+        return true;
     }
 
     template<formattable T>
@@ -43,10 +229,249 @@ struct type_erased_arg
     {}
 };
 
+// Literal text before a placeholder, or after the last one.
+struct format_segment
+{
+    string_view text;
+
+    // Contains {{ or }}, which must be unescaped when writing.
+    bool has_escapes;
+};
+
+enum class format_string_status : uint8_t
+{
+    kOk,
+    kTooManyPlaceholders,
+    kNotEnoughPlaceholders,
+    kUnmatchedBrace,
+    kInvalidSpec,
+};
+
+// Returns the index of the brace closing the placeholder opened at
+// `open`, or -1 when there is none.
+constexpr isize_t find_placeholder_end(string_view fmt, isize_t open)
+{
+    isize_t end = open + 1;
+    if (end < fmt.size() && fmt[end] == ':')
+    {
+        while (end < fmt.size() && fmt[end] != '}') { end += 1; }
+    }
+    return end < fmt.size() && fmt[end] == '}' ? end : -1;
+}
+
+// Splits fmt around its placeholders into arg_count + 1 segments, and
+// parses the spec of each placeholder. segments and specs may be null
+// to only validate the format string.
+constexpr format_string_status parse_format_string(
+    string_view fmt,
+    format_segment* segments,
+    format_spec* specs,
+    isize_t arg_count)
+{
+    isize_t placeholder = 0;
+    isize_t begin = 0;
+    bool has_escapes = false;
+
+    isize_t i = 0;
+    while (i < fmt.size())
+    {
+        const bool has_next = i + 1 < fmt.size();
+
+        if (fmt[i] == '{')
+        {
+            if (has_next && fmt[i + 1] == '{')
+            {
+                has_escapes = true;
+                i += 2;
+                continue;
+            }
+
+            const isize_t end = find_placeholder_end(fmt, i);
+            if (end < 0)
+            {
+                return format_string_status::kUnmatchedBrace;
+            }
+
+            format_spec spec{};
+            if (end > i + 1 && !parse_format_spec(fmt.substr(i + 2, end - i - 2), &spec))
+            {
+                return format_string_status::kInvalidSpec;
+            }
+
+            if (placeholder == arg_count)
+            {
+                return format_string_status::kTooManyPlaceholders;
+            }
+
+            if (segments != nullptr)
+            {
+                segments[placeholder] = { // NOLINT(*-pointer-arithmetic)
+                    .text = fmt.substr(begin, i - begin),
+                    .has_escapes = has_escapes,
+                };
+            }
+
+            if (specs != nullptr)
+            {
+                specs[placeholder] = spec; // NOLINT(*-pointer-arithmetic)
+            }
+
+            placeholder += 1;
+            i = end + 1;
+            begin = i;
+            has_escapes = false;
+        }
+        else if (fmt[i] == '}' && has_next && fmt[i + 1] == '}')
+        {
+            has_escapes = true;
+            i += 2;
+        }
+        else
+        {
+            i += 1;
+        }
+    }
+
+    if (placeholder != arg_count)
+    {
+        return format_string_status::kNotEnoughPlaceholders;
+    }
+
+    if (segments != nullptr)
+    {
+        segments[placeholder] = { // NOLINT(*-pointer-arithmetic)
+            .text = fmt.substr(begin),
+            .has_escapes = has_escapes,
+        };
+    }
+
+    return format_string_status::kOk;
+}
+
+// Never defined: calling them from the consteval format_string constructor
+// turns an invalid format string into a compile error naming the problem.
+void format_string_has_more_placeholders_than_arguments();
+void format_string_has_fewer_placeholders_than_arguments();
+void format_string_has_unmatched_brace();
+void format_string_has_invalid_spec();
+void format_spec_does_not_apply_to_argument_type();
+
+// Non-template view of a format_string. Runtime format strings have
+// no segments and are parsed when formatting.
+struct parsed_format
+{
+    span<const format_segment> segments;
+    span<const format_spec>    specs;
+    string_view                runtime;
+};
+
+void write_escaped(Formatter& f, string_view s);
+
+// Formats from a runtime string, scanning it for placeholders.
+// Errors are reported with <ERROR> in the output.
 void format(Writer*, string_view fmt, span<const type_erased_arg> args);
 
+void format(Writer*, const parsed_format& fmt, span<const type_erased_arg> args);
+
 }  // namespace format_internals
 
+// Format string whose placeholders don't match the arguments, to be
+// used with format strings only known at runtime.
+struct runtime_format_string
+{
+    string_view fmt;
+};
+
+constexpr runtime_format_string runtime_format(string_view fmt)
+{
+    return { fmt };
+}
+
+// Format string parsed at compile time, the placeholders must match
+// the number of arguments.
+template<typename... Args>
+class format_string
+{
+    static constexpr isize_t kArgCount = sizeof...(Args);
+
+    format_internals::format_segment m_segments[kArgCount + 1]{};
+    format_spec                      m_specs[kArgCount > 0 ? kArgCount : 1]{};
+    string_view                      m_runtime;
+    bool                             m_is_runtime{};
+
+    consteval void parse(string_view fmt)
+    {
+        switch (format_internals::parse_format_string(fmt, m_segments, m_specs, kArgCount))
+        {
+            case format_internals::format_string_status::kTooManyPlaceholders:
+                format_internals::format_string_has_more_placeholders_than_arguments();
+                break;
+            case format_internals::format_string_status::kNotEnoughPlaceholders:
+                format_internals::format_string_has_fewer_placeholders_than_arguments();
+                break;
+            case format_internals::format_string_status::kUnmatchedBrace:
+                format_internals::format_string_has_unmatched_brace();
+                break;
+            case format_internals::format_string_status::kInvalidSpec:
+                format_internals::format_string_has_invalid_spec();
+                break;
+            case format_internals::format_string_status::kOk:
+            default:
+                break;
+        }
+
+        [[maybe_unused]] isize_t index = 0;
+        if (!(format_internals::is_valid_spec<Args>(m_specs[index++]) && ...)) // NOLINT(*-constant-array-index)
+        {
+            format_internals::format_spec_does_not_apply_to_argument_type();
+        }
+    }
+
+public:
+    template<isize_t N>
+    consteval format_string(const char (&fmt)[N]) // NOLINT(*explicit*)
+    {
+        parse(string_view{fmt});
+    }
+
+    consteval explicit format_string(string_view fmt)
+    {
+        parse(fmt);
+    }
+
+    constexpr format_string(runtime_format_string fmt) // NOLINT(*explicit*)
+        : m_runtime{fmt.fmt}
+        , m_is_runtime{true}
+    {}
+
+    [[nodiscard]] constexpr bool is_runtime() const { return m_is_runtime; }
+
+    [[nodiscard]] constexpr string_view runtime() const { return m_runtime; }
+
+    [[nodiscard]] constexpr const format_internals::format_segment& segment(isize_t i) const
+    {
+        return m_segments[i]; // NOLINT(*-constant-array-index)
+    }
+
+    [[nodiscard]] constexpr const format_spec& spec(isize_t i) const
+    {
+        return m_specs[i]; // NOLINT(*-constant-array-index)
+    }
+
+    [[nodiscard]] constexpr format_internals::parsed_format parsed() const
+    {
+        if (m_is_runtime)
+        {
+            return { .segments = {}, .specs = {}, .runtime = m_runtime };
+        }
+        return {
+            .segments = m_segments,
+            .specs = span<const format_spec>{ m_specs, kArgCount },
+            .runtime = {},
+        };
+    }
+};
+
 class Formatter
 {
     Writer* m_writer;
@@ -61,43 +486,113 @@ public:
         m_writer->write(as_bytes(s.as_span()));
     }
 
+    // Writes text padded to the width of the spec, in a single write.
+    // Zero padding goes after the first prefix_size characters, which
+    // hold the sign and base prefix of numbers.
+    void write_padded(string_view text, const format_spec& spec, format_align default_align, isize_t prefix_size = 0);
+
     [[nodiscard]] constexpr Writer* writer() const { return m_writer; }
 };
 
-template<formattable... Args>
-void format(Writer* w, string_view fmt, const Args&... args)
+namespace format_internals
 {
-    if constexpr (sizeof...(Args) > 0)
+
+inline void write_segment(Formatter& f, const format_segment& segment)
+{
+    if (segment.has_escapes)
     {
-        const format_internals::type_erased_arg type_erased_args[] = {
-            format_internals::type_erased_arg(args)...
-        };
+        write_escaped(f, segment.text);
+    }
+    else if (!segment.text.is_empty())
+    {
+        f.write(segment.text);
+    }
+}
+
+// Formats the argument in a bounded buffer first, to pad it.
+void format_padded(Formatter& f, const format_spec& spec, const void* data, void (*fn)(Formatter&, const void*));
 
-        format_internals::format(w, fmt, type_erased_args);
+template<formattable T>
+constexpr void format_arg(Formatter& f, const T& value, const format_spec& spec)
+{
+    if (spec.is_default()) [[likely]]
+    {
+        AslFormat(f, value);
+    }
+    else if constexpr (formattable_with_spec<T>)
+    {
+        AslFormat(f, value, spec);
     }
     else
     {
-        format_internals::format(w, fmt, {});
+        format_padded(f, spec, &value, [](Formatter& inner, const void* data) {
+            AslFormat(inner, *static_cast<const T*>(data));
+        });
     }
 }
 
+}  // namespace format_internals
+
+template<formattable... Args>
+void format(Writer* w, format_string<type_identity_t<Args>...> fmt, const Args&... args)
+{
+    if (fmt.is_runtime()) [[unlikely]]
+    {
+        if constexpr (sizeof...(Args) > 0)
+        {
+            const format_internals::type_erased_arg type_erased_args[] = {
+                format_internals::type_erased_arg(args)...
+            };
+
+            format_internals::format(w, fmt.runtime(), type_erased_args);
+        }
+        else
+        {
+            format_internals::format(w, fmt.runtime(), {});
+        }
+        return;
+    }
+
+    Formatter f{w};
+    format_internals::write_segment(f, fmt.segment(0));
+
+    [[maybe_unused]] isize_t index = 0;
+    ((format_internals::format_arg(f, args, fmt.spec(index)),
+        format_internals::write_segment(f, fmt.segment(++index))), ...);
+}
+
 template<isize_t N>
 void AslFormat(Formatter& f, const char (&str)[N])
 {
     f.write(string_view(str, N - 1));
 }
 
+template<isize_t N>
+void AslFormat(Formatter& f, const char (&str)[N], const format_spec& spec)
+{
+    f.write_padded(string_view(str, N - 1), spec, format_align::kLeft);
+}
+
 void AslFormat(Formatter& f, const char* str);
+void AslFormat(Formatter& f, const char* str, const format_spec&);
 
 inline void AslFormat(Formatter& f, string_view sv)
 {
     f.write(sv);
 }
 
+inline void AslFormat(Formatter& f, string_view sv, const format_spec& spec)
+{
+    f.write_padded(sv, spec, format_align::kLeft);
+}
+
 void AslFormat(Formatter& f, float32_t);
 void AslFormat(Formatter& f, float64_t);
+void AslFormat(Formatter& f, float32_t, const format_spec&);
+void AslFormat(Formatter& f, float64_t, const format_spec&);
 
 void AslFormat(Formatter& f, bool);
+void AslFormat(Formatter& f, bool, const format_spec&);
 
 void AslFormat(Formatter& f, uint8_t);
 void AslFormat(Formatter& f, uint16_t);
@@ -109,6 +604,16 @@ void AslFormat(Formatter& f, int16_t);
 void AslFormat(Formatter& f, int32_t);
 void AslFormat(Formatter& f, int64_t);
 
+void AslFormat(Formatter& f, uint8_t, const format_spec&);
+void AslFormat(Formatter& f, uint16_t, const format_spec&);
+void AslFormat(Formatter& f, uint32_t, const format_spec&);
+void AslFormat(Formatter& f, uint64_t, const format_spec&);
+
+void AslFormat(Formatter& f, int8_t, const format_spec&);
+void AslFormat(Formatter& f, int16_t, const format_spec&);
+void AslFormat(Formatter& f, int32_t, const format_spec&);
+void AslFormat(Formatter& f, int64_t, const format_spec&);
+
 string_view format_uint64(uint64_t value, span<char, 20> buffer);
 
 } // namespace asl
@@ -0,0 +1,124 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/formatting/format.hpp"
+#include "asl/benchmarking/benchmarking.hpp"
+
+// Discards the output, only counting the bytes so nothing gets optimized out.
+class NullWriter : public asl::Writer
+{
+public:
+    isize_t written = 0;
+
+    void write(asl::span<const std::byte> s) override
+    {
+        written += s.size();
+    }
+};
+
+static constexpr uint64_t kIntegers[] = {
+    0, 7, 42, 1234, 99999, 1234567, 4294967295, 123456789012345, 18446744073709551615ULL,
+};
+
+static constexpr float64_t kFloats[] = {
+    0.0, 1.0, 0.1, 3.14159265358979, 1e-300, 6.02214076e23, 123456.789, 2.5e-5, 1.7976931348623157e308,
+};
+
+static constexpr float32_t kFloats32[] = {
+    0.0F, 1.0F, 0.1F, 3.1415927F, 1e-30F, 6.0221408e23F, 123456.79F, 2.5e-5F, 3.4028235e38F,
+};
+
+static constexpr isize_t kValueCount = 9;
+
+ASL_BENCHMARK(format_uint64)
+{
+    char buffer[20];
+
+    isize_t i = 0;
+    while (state.keep_running())
+    {
+        const asl::string_view s = asl::format_uint64(kIntegers[i], buffer); // NOLINT(*-constant-array-index)
+        asl::benchmarking::do_not_optimize(s.size());
+        asl::benchmarking::clobber_memory();
+        i = i + 1 == kValueCount ? 0 : i + 1;
+    }
+}
+
+ASL_BENCHMARK(format_integer_args)
+{
+    NullWriter writer;
+
+    isize_t i = 0;
+    while (state.keep_running())
+    {
+        asl::format(&writer, "value = {}, index = {}\n", kIntegers[i], i); // NOLINT(*-constant-array-index)
+        i = i + 1 == kValueCount ? 0 : i + 1;
+    }
+    asl::benchmarking::do_not_optimize(writer.written);
+}
+
+ASL_BENCHMARK(format_float64)
+{
+    NullWriter writer;
+
+    isize_t i = 0;
+    while (state.keep_running())
+    {
+        asl::format(&writer, "{}", kFloats[i]); // NOLINT(*-constant-array-index)
+        i = i + 1 == kValueCount ? 0 : i + 1;
+    }
+    asl::benchmarking::do_not_optimize(writer.written);
+}
+
+ASL_BENCHMARK(format_float32)
+{
+    NullWriter writer;
+
+    isize_t i = 0;
+    while (state.keep_running())
+    {
+        asl::format(&writer, "{}", kFloats32[i]); // NOLINT(*-constant-array-index)
+        i = i + 1 == kValueCount ? 0 : i + 1;
+    }
+    asl::benchmarking::do_not_optimize(writer.written);
+}
+
+ASL_BENCHMARK(format_integer_specs)
+{
+    NullWriter writer;
+
+    isize_t i = 0;
+    while (state.keep_running())
+    {
+        asl::format(&writer, "{:016x} {:>20}\n", kIntegers[i], kIntegers[i]); // NOLINT(*-constant-array-index)
+        i = i + 1 == kValueCount ? 0 : i + 1;
+    }
+    asl::benchmarking::do_not_optimize(writer.written);
+}
+
+ASL_BENCHMARK(format_float64_fixed)
+{
+    NullWriter writer;
+
+    isize_t i = 0;
+    while (state.keep_running())
+    {
+        asl::format(&writer, "{:12.3f}", kFloats[i]); // NOLINT(*-constant-array-index)
+        i = i + 1 == kValueCount ? 0 : i + 1;
+    }
+    asl::benchmarking::do_not_optimize(writer.written);
+}
+
+ASL_BENCHMARK(format_float64_exponent)
+{
+    NullWriter writer;
+
+    isize_t i = 0;
+    while (state.keep_running())
+    {
+        asl::format(&writer, "{:.6e}", kFloats[i]); // NOLINT(*-constant-array-index)
+        i = i + 1 == kValueCount ? 0 : i + 1;
+    }
+    asl::benchmarking::do_not_optimize(writer.written);
+}
@@ -22,26 +22,76 @@ ASL_TEST(format_args)
     s = asl::format_to_string("Hello, {}!", "world");
     ASL_TEST_EXPECT(s == "Hello, world!"_sv);
 
-    s = asl::format_to_string("Hello, {}! {}", "world");
+    s = asl::format_to_string("{}", "CHEESE");
+    ASL_TEST_EXPECT(s == "CHEESE"_sv);
+
+    s = asl::format_to_string("a{{b");
+    ASL_TEST_EXPECT(s == "a{b"_sv);
+
+    s = asl::format_to_string("{{{}}} }", "CHEESE");
+    ASL_TEST_EXPECT(s == "{CHEESE} }"_sv);
+
+    s = asl::format_to_string("}}{}{{{}}}{{", 1, 2);
+    ASL_TEST_EXPECT(s == "}1{2}{"_sv);
+}
+
+static constexpr asl::format_internals::format_string_status check(asl::string_view fmt, isize_t arg_count)
+{
+    return asl::format_internals::parse_format_string(fmt, nullptr, nullptr, arg_count);
+}
+
+static_assert(check("Hello, {}!", 1) == asl::format_internals::format_string_status::kOk);
+static_assert(check("{{}}", 0) == asl::format_internals::format_string_status::kOk);
+static_assert(check("Hello, {}! {}", 1) == asl::format_internals::format_string_status::kTooManyPlaceholders);
+static_assert(check("Hello, pup!", 1) == asl::format_internals::format_string_status::kNotEnoughPlaceholders);
+static_assert(check("{   ", 1) == asl::format_internals::format_string_status::kUnmatchedBrace);
+static_assert(check("{", 1) == asl::format_internals::format_string_status::kUnmatchedBrace);
+static_assert(check("{:>8}", 1) == asl::format_internals::format_string_status::kOk);
+static_assert(check("{:*^+8.2f}", 1) == asl::format_internals::format_string_status::kInvalidSpec);
+static_assert(check("{:.f}", 1) == asl::format_internals::format_string_status::kInvalidSpec);
+static_assert(check("{:999}", 1) == asl::format_internals::format_string_status::kInvalidSpec);
+static_assert(check("{:08x", 1) == asl::format_internals::format_string_status::kUnmatchedBrace);
+
+template<typename T>
+static constexpr bool is_valid_spec(asl::string_view s)
+{
+    asl::format_spec spec{};
+    return asl::format_internals::parse_format_spec(s, &spec)
+        && asl::format_internals::is_valid_spec<T>(spec);
+}
+
+static_assert(is_valid_spec<int>("x"));
+static_assert(!is_valid_spec<int>(".2"));
+static_assert(is_valid_spec<float64_t>(".2"));
+static_assert(!is_valid_spec<float64_t>("x"));
+static_assert(!is_valid_spec<bool>("05"));
+static_assert(is_valid_spec<bool>("*^5"));
+
+ASL_TEST(format_runtime)
+{
+    auto s = asl::format_to_string(asl::runtime_format("Hello, {}!"), "world");
+    ASL_TEST_EXPECT(s == "Hello, world!"_sv);
+
+    s = asl::format_to_string(asl::runtime_format("Hello, {}! {}"), "world");
     ASL_TEST_EXPECT(s == "Hello, world! <ERROR>"_sv);
 
-    s = asl::format_to_string("Hello, pup!", "world");
+    s = asl::format_to_string(asl::runtime_format("Hello, pup!"), "world");
     ASL_TEST_EXPECT(s == "Hello, pup!"_sv);
 
-    s = asl::format_to_string("{}", "CHEESE");
-    ASL_TEST_EXPECT(s == "CHEESE"_sv);
-
-    s = asl::format_to_string("{   ", "CHEESE");
+    s = asl::format_to_string(asl::runtime_format("{   "), "CHEESE");
     ASL_TEST_EXPECT(s == "<ERROR>   "_sv);
 
-    s = asl::format_to_string("{", "CHEESE");
+    s = asl::format_to_string(asl::runtime_format("{"), "CHEESE");
     ASL_TEST_EXPECT(s == "<ERROR>"_sv);
 
-    s = asl::format_to_string("a{{b");
-    ASL_TEST_EXPECT(s == "a{b"_sv);
-
-    s = asl::format_to_string("{{{}}} }", "CHEESE");
+    s = asl::format_to_string(asl::runtime_format("{{{}}} }"), "CHEESE");
     ASL_TEST_EXPECT(s == "{CHEESE} }"_sv);
+
+    s = asl::format_to_string(asl::runtime_format("[{:>6}] [{:04x}]"), "pup", 42);
+    ASL_TEST_EXPECT(s == "[   pup] [002a]"_sv);
+
+    s = asl::format_to_string(asl::runtime_format("[{:q}] [{:.2}] {}"), 1, "pup", 2);
+    ASL_TEST_EXPECT(s == "[<ERROR>] [<ERROR>] 2"_sv);
 }
 
 ASL_TEST(format_integers)
@@ -86,6 +136,67 @@ ASL_TEST(format_floats)
     ASL_TEST_EXPECT(s == "NaN"_sv);
 }
 
+ASL_TEST(format_integer_specs)
+{
+    auto s = asl::format_to_string("{:08x} {:X} {:#x} {:#X}", 0xbeefU, 48879, 255, uint8_t{10});
+    ASL_TEST_EXPECT(s == "0000beef BEEF 0xff 0XA"_sv);
+
+    s = asl::format_to_string("{:b} {:#b} {:010b} {:x}", 5, 0, -6, 0);
+    ASL_TEST_EXPECT(s == "101 0b0 -000000110 0"_sv);
+
+    s = asl::format_to_string("{:x} {:X}", uint64_t{0xffff'ffff'ffff'ffff}, int64_t{-0x1234'5678'9abc'def0});
+    ASL_TEST_EXPECT(s == "ffffffffffffffff -123456789ABCDEF0"_sv);
+
+    s = asl::format_to_string("[{:5}] [{:<5}] [{:^5}] [{:*>5d}]", 42, 42, 42, -42);
+    ASL_TEST_EXPECT(s == "[   42] [42   ] [ 42  ] [**-42]"_sv);
+
+    s = asl::format_to_string("[{:06}] [{:#06x}] [{:<06}]", -42, 42, 42);
+    ASL_TEST_EXPECT(s == "[-00042] [0x002a] [42    ]"_sv);
+
+    s = asl::format_to_string("[{:2}] [{:x}]", 12345, 0xabc);
+    ASL_TEST_EXPECT(s == "[12345] [abc]"_sv);
+}
+
+ASL_TEST(format_float_specs)
+{
+    auto s = asl::format_to_string("{:.3f} {:.0f} {:.2f} {:.1f}", 3.14159, 2.5, -0.004, 0.96F);
+    ASL_TEST_EXPECT(s == "3.142 2 -0.00 1.0"_sv);
+
+    // Rounding is from the exact binary value, 2.675 is slightly below.
+    s = asl::format_to_string("{:.2f} {:.2f} {:.1f}", 2.675, 0.125, 9.95);
+    ASL_TEST_EXPECT(s == "2.67 0.12 9.9"_sv);
+
+    s = asl::format_to_string("{:.20f}", 0.1);
+    ASL_TEST_EXPECT(s == "0.10000000000000000555"_sv);
+
+    s = asl::format_to_string("{:.3f}", 1e22);
+    ASL_TEST_EXPECT(s == "10000000000000000000000.000"_sv);
+
+    s = asl::format_to_string("{:.3e} {:.0e} {:.2e} {:.1e}", 123456.0, 5e-324, 0.0, 9.96);
+    ASL_TEST_EXPECT(s == "1.235e+05 5e-324 0.00e+00 1.0e+01"_sv);
+
+    s = asl::format_to_string("{:e} {:e} {:e} {:e}", 1.0, 1234.5, 0.00012F, 0.0);
+    ASL_TEST_EXPECT(s == "1e+00 1.2345e+03 1.2e-04 0e+00"_sv);
+
+    s = asl::format_to_string("{:f} {:.2}", 0.001, 1.005);
+    ASL_TEST_EXPECT(s == "0.001 1.00"_sv);
+
+    s = asl::format_to_string("[{:8.2f}] [{:<8.2f}] [{:08.2f}] [{:^9.1f}]", 3.14159, 3.14159, -3.14159, 2.5);
+    ASL_TEST_EXPECT(s == "[    3.14] [3.14    ] [-0003.14] [   2.5   ]"_sv);
+
+    s = asl::format_to_string("[{:06}] [{:>5}]", asl::infinity<float64_t>(), asl::nan<float32_t>());
+    ASL_TEST_EXPECT(s == "[Infinity] [  NaN]"_sv);
+}
+
+ASL_TEST(format_text_specs)
+{
+    auto s = asl::format_to_string("[{:6}] [{:>6}] [{:^6}] [{:-^7}]", "ab", "ab"_sv, "ab", "ab");
+    ASL_TEST_EXPECT(s == "[ab    ] [    ab] [  ab  ] [--ab---]"_sv);
+
+    s = asl::format_to_string("[{:>7}] [{:2}]", true, "long text");
+    ASL_TEST_EXPECT(s == "[   true] [long text]"_sv);
+}
+
 ASL_TEST(format_boolean)
 {
     auto s = asl::format_to_string("{} {}", true, false);
@@ -111,4 +222,7 @@ ASL_TEST(format_custom)
 {
     auto s = asl::format_to_string("{}", CustomFormat{37});
     ASL_TEST_EXPECT(s == "(37)"_sv);
+
+    s = asl::format_to_string("[{:>6}] [{:.<6}]", CustomFormat{37}, CustomFormat{5});
+    ASL_TEST_EXPECT(s == "[  (37)] [(5)...]"_sv);
 }
@@ -8,10 +8,31 @@
 #include "asl/allocator/allocator.hpp"
 #include "asl/containers/chunked_buffer.hpp"
 
+namespace asl::dense_handle_pool_internal
+{
+
+template<typename Handle, typename T>
+struct Slot
+{
+    Handle h;
+    T obj;
+
+    template<typename... Args>
+    explicit Slot(Handle h_, Args&&... args)
+        : h{h_}
+        , obj(std::forward<Args>(args)...)
+    {}
+};
+
+} // namespace asl::dense_handle_pool_internal
 
 namespace asl
 {
 
+template<typename Handle, typename T>
+struct trivially_relocatable<dense_handle_pool_internal::Slot<Handle, T>>
+    : bool_constant<is_trivially_relocatable<Handle> && is_trivially_relocatable<T>> {};
+
 // @Todo If we want the allocator to be non-copyable, we could
 // introduce a reference allocator type that is copyable, and store
 // the "main" allocator in the pool.
@@ -29,17 +50,7 @@ class DenseHandlePool
 {
     using ThisIndexPool = IndexPool<kIndexBits, kGenBits, UserType, kUserBits, isize_t, Allocator>;
 
-    struct Slot
-    {
-        ThisIndexPool::handle h;
-        T obj;
-
-        template<typename... Args>
-        explicit Slot(ThisIndexPool::handle h_, Args&&... args)
-            : h{h_}
-            , obj(std::forward<Args>(args)...)
-        {}
-    };
+    using Slot = dense_handle_pool_internal::Slot<typename ThisIndexPool::handle, T>;
 
     using Buffer = chunked_buffer<Slot, kChunkSize, Allocator>;
 
@@ -131,14 +142,11 @@ public:
         const auto to_release_index = *m_index_pool.get_payload(to_release_handle);
         if (to_release_index < m_buffer.size() - 1)
         {
-            const auto to_swap_index = m_buffer.size() - 1;
-            const auto to_swap_handle = m_buffer[to_swap_index].h;
-
-            m_buffer[to_release_index] = std::move(m_buffer[to_swap_index]);
+            const auto to_swap_handle = m_buffer[m_buffer.size() - 1].h;
             m_index_pool.exchange_payload(to_swap_handle, to_release_index);
         }
 
-        m_buffer.pop();
+        m_buffer.swap_remove(to_release_index);
         m_index_pool.release(to_release_handle);
     }
 
@@ -5,7 +5,9 @@
 #pragma once
 
 #include "asl/base/meta.hpp"
+#include "asl/base/assert.hpp"
 #include "asl/base/integers.hpp"
+#include "asl/base/memory_ops.hpp"
 #include "asl/types/span.hpp"
 
 namespace asl::city_hash
@@ -56,6 +58,85 @@ constexpr uint64_t Hash128to64(const uint128_t& x)
 
 } // namespace asl::city_hash
 
+namespace asl::hash_internal
+{
+
+// Arbitrary odd constants with about as many bits set as unset.
+static constexpr uint64_t kSmallSeed0 = 0xa076'1d64'78bd'642fULL;
+static constexpr uint64_t kSmallSeed1 = 0xe703'7ed1'a0b4'28dbULL;
+
+// Full 128 bits product, with both halves folded together.
+constexpr uint64_t folded_multiply(uint64_t a, uint64_t b)
+{
+    const __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64U);
+}
+
+inline uint64_t load_u64(const std::byte* data)
+{
+    uint64_t value{};
+    asl::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint64_t load_u32(const std::byte* data)
+{
+    uint32_t value{};
+    asl::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// Mixes 1 to 16 bytes into a state with two multiplications, which is
+// much cheaper than CityHash for small inputs. The bytes are read as two,
+// possibly overlapping, words which together cover all of them, and the
+// size goes into the high half of the state, so that all inputs of the
+// same size give different words.
+//
+// When one operand of the first multiplication is zero, its product loses
+// the other word, so both words go into the second one as well. Then no
+// single word can cancel the others out.
+//
+// The mixing is weak on its own, but Hash128to64 in hash_value mixes the
+// whole state again, so all bits of the final hash stay usable.
+inline uint128_t combine_small(uint128_t state, const std::byte* data, isize_t size)
+{
+    ASL_ASSERT(size >= 1 && size <= 16);
+
+    uint64_t low{};
+    uint64_t high{};
+
+    // NOLINTBEGIN(*-pointer-arithmetic)
+    if (size >= 8)
+    {
+        low = load_u64(data);
+        high = load_u64(data + size - 8);
+    }
+    else if (size >= 4)
+    {
+        low = load_u32(data);
+        high = load_u32(data + size - 4);
+    }
+    else
+    {
+        low = (static_cast<uint64_t>(data[0]) << 16U) |
+            (static_cast<uint64_t>(data[size / 2]) << 8U) |
+            static_cast<uint64_t>(data[size - 1]);
+    }
+    // NOLINTEND(*-pointer-arithmetic)
+
+    const auto len = static_cast<uint64_t>(size);
+    const uint64_t a = low ^ state.low ^ kSmallSeed0;
+    const uint64_t b = high ^ state.high ^ kSmallSeed1 ^ len;
+    const uint64_t mixed = folded_multiply(a, b);
+
+    return uint128_t{
+        .high = state.high + len,
+        .low = folded_multiply(mixed ^ a ^ kSmallSeed1, mixed ^ b ^ kSmallSeed0),
+    };
+}
+
+} // namespace asl::hash_internal
+
 namespace asl
 {
 
@@ -65,9 +146,18 @@ concept hashable_generic = requires(const T& value, H h)
     { AslHashValue(h, value) } -> same_as<H>;
 };
 
+// Inputs of up to 16 bytes, like most fields of a key, are accumulated in
+// a small buffer, which is mixed into the state each time it's full, and
+// once more at the end in finish(). A key made of several small fields
+// then costs about one mixing per 16 bytes, instead of one per field.
+// Bigger inputs are hashed with CityHash after flushing the buffer.
 struct HashState
 {
+    static constexpr isize_t kBufferSize = 16;
+
     uint128_t state{};
+    std::byte buffer[kBufferSize]{};
+    isize_t   buffered{};
 
     constexpr HashState() = default;
     explicit constexpr HashState(uint128_t s) : state{s} {}
@@ -78,6 +168,12 @@ struct HashState
         if constexpr (has_unique_object_representations_v<T>)
         {
             auto bytes = as_bytes(s);
+            if (bytes.size() >= 1 && bytes.size() <= kBufferSize)
+            {
+                return append_small(std::move(h), bytes.data(), bytes.size());
+            }
+
+            h = flush(std::move(h));
             auto hashed = city_hash::CityHash128WithSeed(
                 reinterpret_cast<const char*>(bytes.data()), // NOLINT(*-reinterpret-cast)
                 static_cast<size_t>(bytes.size()),
@@ -94,6 +190,45 @@ struct HashState
         }
     }
 
+    // NOLINTBEGIN(*-pointer-arithmetic)
+    static HashState append_small(HashState h, const std::byte* data, isize_t size)
+    {
+        ASL_ASSERT(size >= 1 && size <= kBufferSize);
+
+        const isize_t room = kBufferSize - h.buffered;
+        if (size <= room)
+        {
+            asl::memcpy(h.buffer + h.buffered, data, size);
+            h.buffered += size;
+        }
+        else
+        {
+            asl::memcpy(h.buffer + h.buffered, data, room);
+            h.state = hash_internal::combine_small(h.state, h.buffer, kBufferSize);
+            asl::memcpy(h.buffer, data + room, size - room);
+            h.buffered = size - room;
+        }
+
+        return h;
+    }
+    // NOLINTEND(*-pointer-arithmetic)
+
+    // Mixes whatever is left in the buffer into the state.
+    static HashState flush(HashState h)
+    {
+        if (h.buffered > 0)
+        {
+            h.state = hash_internal::combine_small(h.state, h.buffer, h.buffered);
+            h.buffered = 0;
+        }
+        return h;
+    }
+
+    static uint128_t finish(HashState h)
+    {
+        return flush(std::move(h)).state;
+    }
+
     static constexpr HashState combine(HashState h)
     {
         return h;
@@ -131,12 +266,92 @@ constexpr H AslHashValue(H h, const span<T>& s)
     return H::combine_contiguous(std::move(h), span<const T>{s.data(), s.size()});
 }
 
+// Values of type U can stand for keys of type T in hashed containers, which
+// then don't convert them to T for lookups. They must hash identically, and
+// compare equal to the keys they stand for.
+template<typename T, typename U> struct is_transparent_key       : false_type {};
+template<typename T>             struct is_transparent_key<T, T> : true_type {};
+
+template<typename U, typename T>
+concept transparent_key_for = is_transparent_key<T, U>::value;
+
 template<hashable T>
 constexpr uint64_t hash_value(const T& value)
 {
-    auto result = AslHashValue(HashState{}, value).state;
+    auto result = HashState::finish(AslHashValue(HashState{}, value));
     return city_hash::Hash128to64(result);
 }
 
+namespace hash_internal
+{
+
+struct ProcessSeeds
+{
+    uint128_t seed;
+    uint128_t siphash_key;
+};
+
+// Random bytes from the OS.
+ProcessSeeds random_seeds();
+
+// Drawn on first use, then the same for the whole life of the process.
+inline const ProcessSeeds& process_seeds()
+{
+    static const ProcessSeeds s_seeds = random_seeds();
+    return s_seeds;
+}
+
+} // namespace hash_internal
+
+// Random seed for seeded_hash_value, the same for the whole process.
+inline uint128_t process_hash_seed()
+{
+    return hash_internal::process_seeds().seed;
+}
+
+// Same as hash_value, but starting from the given seed, so that hashes
+// can't be predicted without knowing it. This is as fast as hash_value,
+// but isn't designed to resist attackers, see siphash_value for that.
+template<hashable T>
+uint64_t seeded_hash_value(const T& value, uint128_t seed)
+{
+    auto result = HashState::finish(AslHashValue(HashState{seed}, value));
+    return city_hash::Hash128to64(result);
+}
+
+// Same as hash_value on each element, out[i] being the hash of values[i].
+//
+// Values hashed as their bytes, and no bigger than 16 bytes, like integers
+// and handles, skip HashState and its buffering entirely. This leaves a
+// short sequence of multiplications per element, independent from one
+// element to the next, so the CPU overlaps the hashing of several of them.
+template<hashable T>
+void hash_values(span<const T> values, span<uint64_t> out)
+{
+    ASL_ASSERT(values.size() == out.size());
+
+    // bool is hashed as an int.
+    if constexpr (
+        has_unique_object_representations_v<T> &&
+        !same_as<T, bool> &&
+        static_cast<isize_t>(sizeof(T)) <= HashState::kBufferSize)
+    {
+        for (isize_t i = 0; i < values.size(); ++i)
+        {
+            // NOLINTNEXTLINE(*-reinterpret-cast)
+            const auto* bytes = reinterpret_cast<const std::byte*>(&values[i]);
+            const uint128_t state = hash_internal::combine_small(uint128_t{}, bytes, static_cast<isize_t>(sizeof(T)));
+            out[i] = city_hash::Hash128to64(state);
+        }
+    }
+    else
+    {
+        for (isize_t i = 0; i < values.size(); ++i)
+        {
+            out[i] = hash_value(values[i]);
+        }
+    }
+}
+
 } // namespace asl
 
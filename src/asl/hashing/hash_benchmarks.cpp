@@ -0,0 +1,101 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/hashing/hash.hpp"
+#include "asl/strings/string_view.hpp"
+#include "asl/benchmarking/benchmarking.hpp"
+
+static constexpr isize_t kMaxLength = 4096;
+
+static const char* input_bytes()
+{
+    static char s_bytes[kMaxLength];
+    static bool s_init = false;
+    if (!s_init)
+    {
+        for (isize_t i = 0; i < kMaxLength; ++i)
+        {
+            s_bytes[i] = static_cast<char>(i * 31 + 7); // NOLINT(*-constant-array-index)
+        }
+        s_init = true;
+    }
+    return s_bytes;
+}
+
+ASL_BENCHMARK_ARGS(city_hash64, 4, 8, 16, 32, 64, 256, 4096)
+{
+    const char* bytes = input_bytes();
+    const auto length = static_cast<size_t>(state.arg());
+
+    while (state.keep_running())
+    {
+        asl::benchmarking::do_not_optimize(asl::city_hash::CityHash64(bytes, length));
+        asl::benchmarking::clobber_memory();
+    }
+}
+
+ASL_BENCHMARK(hash_value_uint64)
+{
+    uint64_t value = 0;
+    while (state.keep_running())
+    {
+        const uint64_t h = asl::hash_value(value);
+        asl::benchmarking::do_not_optimize(h);
+        value += 1;
+    }
+}
+
+// 1024 values per iteration.
+ASL_BENCHMARK(hash_values_uint64)
+{
+    static constexpr isize_t kCount = 1024;
+    static uint64_t s_values[kCount];
+    static uint64_t s_hashes[kCount];
+
+    for (isize_t i = 0; i < kCount; ++i)
+    {
+        s_values[i] = static_cast<uint64_t>(i) * 0x1234'5679ULL; // NOLINT(*-constant-array-index)
+    }
+
+    while (state.keep_running())
+    {
+        asl::hash_values<uint64_t>(s_values, s_hashes);
+        asl::benchmarking::clobber_memory();
+    }
+}
+
+struct CompositeKey
+{
+    uint32_t tenant;
+    uint32_t kind;
+    uint64_t id;
+    uint64_t version;
+
+    template<typename H>
+    friend H AslHashValue(H h, const CompositeKey& key)
+    {
+        return H::combine(std::move(h), key.tenant, key.kind, key.id, key.version);
+    }
+};
+
+ASL_BENCHMARK(hash_value_composite)
+{
+    CompositeKey key{ .tenant = 3, .kind = 1, .id = 0, .version = 7 };
+    while (state.keep_running())
+    {
+        asl::benchmarking::do_not_optimize(asl::hash_value(key));
+        key.id += 1;
+    }
+}
+
+ASL_BENCHMARK_ARGS(hash_value_string_view, 4, 8, 16, 32, 64, 256, 4096)
+{
+    const asl::string_view sv{input_bytes(), state.arg()};
+
+    while (state.keep_running())
+    {
+        asl::benchmarking::do_not_optimize(asl::hash_value(sv));
+        asl::benchmarking::clobber_memory();
+    }
+}
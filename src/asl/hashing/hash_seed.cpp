@@ -0,0 +1,48 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/hashing/hash.hpp"
+
+#include "asl/base/assert.hpp"
+
+#if defined(ASL_OS_WINDOWS)
+    #define _CRT_RAND_S
+    #include <stdlib.h>
+#elif defined(ASL_OS_LINUX)
+    #include <errno.h>
+    #include <sys/random.h>
+#endif
+
+asl::hash_internal::ProcessSeeds asl::hash_internal::random_seeds()
+{
+    ProcessSeeds seeds{};
+
+#if defined(ASL_OS_WINDOWS)
+    uint32_t words[sizeof(ProcessSeeds) / sizeof(uint32_t)];
+    for (uint32_t& word: words)
+    {
+        unsigned int value = 0;
+        ASL_ASSERT_RELEASE(rand_s(&value) == 0);
+        word = value;
+    }
+    asl::memcpy(&seeds, words, sizeof(seeds));
+#elif defined(ASL_OS_LINUX)
+    auto* bytes = reinterpret_cast<char*>(&seeds); // NOLINT(*-reinterpret-cast)
+    size_t filled = 0;
+
+    while (filled < sizeof(seeds))
+    {
+        // NOLINTNEXTLINE(*-pointer-arithmetic)
+        const ssize_t result = ::getrandom(bytes + filled, sizeof(seeds) - filled, 0);
+        if (result < 0)
+        {
+            ASL_ASSERT_RELEASE(errno == EINTR);
+            continue;
+        }
+        filled += static_cast<size_t>(result);
+    }
+#endif
+
+    return seeds;
+}
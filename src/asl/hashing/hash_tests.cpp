@@ -4,6 +4,7 @@
 
 #include "asl/testing/testing.hpp"
 #include "asl/hashing/hash.hpp"
+#include "asl/hashing/siphash.hpp"
 #include "asl/strings/string_view.hpp"
 #include "asl/strings/string.hpp"
 #include "asl/containers/buffer.hpp"
@@ -39,6 +40,162 @@ ASL_TEST(integers)
     ASL_TEST_EXPECT(a != d);
 }
 
+struct Pair
+{
+    uint32_t a;
+    uint32_t b;
+
+    template<typename H>
+    friend H AslHashValue(H h, const Pair& p)
+    {
+        return H::combine(std::move(h), p.a, p.b);
+    }
+};
+
+ASL_TEST(small_keys)
+{
+    // All sizes up to 16 bytes go through the small keys path.
+    ASL_TEST_EXPECT(asl::hash_value<uint8_t>(1) != asl::hash_value<uint8_t>(2));
+    ASL_TEST_EXPECT(asl::hash_value<uint64_t>(1) != asl::hash_value<uint64_t>(2));
+    ASL_TEST_EXPECT(asl::hash_value<uint64_t>(1) != asl::hash_value<uint64_t>(uint64_t{1} << 32U));
+    ASL_TEST_EXPECT(asl::hash_value(uint128_t{1, 2}) != asl::hash_value(uint128_t{2, 1}));
+    ASL_TEST_EXPECT(asl::hash_value("abcdefghij"_sv) != asl::hash_value("abcdefghik"_sv));
+
+    ASL_TEST_EXPECT(asl::hash_value(Pair{1, 2}) == asl::hash_value(Pair{1, 2}));
+    ASL_TEST_EXPECT(asl::hash_value(Pair{1, 2}) != asl::hash_value(Pair{2, 1}));
+
+    // hash_set takes the tag from the low 7 bits, and the group from the
+    // bits above, so both have to vary between consecutive keys.
+    uint64_t tags_or = 0;
+    uint64_t tags_and = ~uint64_t{0};
+    uint64_t groups_or = 0;
+    uint64_t groups_and = ~uint64_t{0};
+    for (uint64_t i = 0; i < 256; ++i)
+    {
+        const uint64_t h = asl::hash_value(i);
+        tags_or |= h & 0x7fU;
+        tags_and &= h & 0x7fU;
+        groups_or |= (h >> 7U) & 0xffffU;
+        groups_and &= (h >> 7U) & 0xffffU;
+    }
+    ASL_TEST_EXPECT(tags_or == 0x7fU);
+    ASL_TEST_EXPECT(tags_and == 0);
+    ASL_TEST_EXPECT(groups_or == 0xffffU);
+    ASL_TEST_EXPECT(groups_and == 0);
+}
+
+ASL_TEST(small_keys_zero_operand)
+{
+    using asl::hash_internal::kSmallSeed0;
+    using asl::hash_internal::kSmallSeed1;
+
+    // With the default state, these words zero an operand of the first
+    // multiplication for 16 bytes keys. The other word must still count.
+    ASL_TEST_EXPECT(asl::hash_value(uint128_t{kSmallSeed0, 1}) != asl::hash_value(uint128_t{kSmallSeed0, 2}));
+    ASL_TEST_EXPECT(asl::hash_value(uint128_t{1, kSmallSeed1 ^ 16U}) != asl::hash_value(uint128_t{2, kSmallSeed1 ^ 16U}));
+}
+
+struct Record
+{
+    uint32_t         tenant;
+    asl::string_view name;
+    int64_t          a;
+    int64_t          b;
+    uint8_t          c;
+
+    template<typename H>
+    friend H AslHashValue(H h, const Record& r)
+    {
+        return H::combine(std::move(h), r.tenant, r.name, r.a, r.b, r.c);
+    }
+};
+
+ASL_TEST(several_fields)
+{
+    // Fields are buffered, and the buffer is mixed in at various points
+    // depending on their sizes, but every field still matters.
+    const Record r{ .tenant = 1, .name = "hello", .a = 2, .b = 3, .c = 4 };
+
+    ASL_TEST_EXPECT(asl::hash_value(r) == asl::hash_value(Record{ r }));
+    ASL_TEST_EXPECT(asl::hash_value(r) != asl::hash_value(Record{ .tenant = 2, .name = "hello", .a = 2, .b = 3, .c = 4 }));
+    ASL_TEST_EXPECT(asl::hash_value(r) != asl::hash_value(Record{ .tenant = 1, .name = "hellp", .a = 2, .b = 3, .c = 4 }));
+    ASL_TEST_EXPECT(asl::hash_value(r) != asl::hash_value(Record{ .tenant = 1, .name = "hello", .a = 3, .b = 3, .c = 4 }));
+    ASL_TEST_EXPECT(asl::hash_value(r) != asl::hash_value(Record{ .tenant = 1, .name = "hello", .a = 2, .b = 2, .c = 4 }));
+    ASL_TEST_EXPECT(asl::hash_value(r) != asl::hash_value(Record{ .tenant = 1, .name = "hello", .a = 2, .b = 3, .c = 5 }));
+
+    // Long strings aren't buffered.
+    const Record r2{ .tenant = 1, .name = "a rather long name, longer than the buffer", .a = 2, .b = 3, .c = 4 };
+    ASL_TEST_EXPECT(asl::hash_value(r2) != asl::hash_value(r));
+    ASL_TEST_EXPECT(asl::hash_value(r2) == asl::hash_value(Record{ r2 }));
+}
+
+template<typename T>
+static bool hash_values_match(asl::span<const T> values)
+{
+    uint64_t hashes[16];
+    asl::hash_values(values, asl::span<uint64_t>{hashes, values.size()});
+    for (isize_t i = 0; i < values.size(); ++i)
+    {
+        if (hashes[i] != asl::hash_value(values[i])) { return false; } // NOLINT(*-constant-array-index)
+    }
+    return true;
+}
+
+ASL_TEST(hash_values)
+{
+    const uint64_t u64[] = { 0, 1, 2, 0xffff'ffff'ffff'ffffULL, 1ULL << 40U };
+    const uint32_t u32[] = { 0, 7, 0xdead'beefU };
+    const uint8_t u8[] = { 0, 255 };
+    const uint128_t u128[] = { {1, 2}, {2, 1} };
+    const bool bools[] = { true, false };
+    const asl::string_view strs[] = { "a", "hello", "a string longer than sixteen bytes" };
+
+    ASL_TEST_EXPECT(hash_values_match<uint64_t>(u64));
+    ASL_TEST_EXPECT(hash_values_match<uint32_t>(u32));
+    ASL_TEST_EXPECT(hash_values_match<uint8_t>(u8));
+    ASL_TEST_EXPECT(hash_values_match<uint128_t>(u128));
+    ASL_TEST_EXPECT(hash_values_match<bool>(bools));
+    ASL_TEST_EXPECT(hash_values_match<asl::string_view>(strs));
+}
+
+ASL_TEST(seeded)
+{
+    const asl::uint128_t seed1{ .high = 1, .low = 2 };
+    const asl::uint128_t seed2{ .high = 1, .low = 3 };
+
+    ASL_TEST_EXPECT(asl::seeded_hash_value(45, asl::uint128_t{}) == asl::hash_value(45));
+    ASL_TEST_EXPECT(asl::seeded_hash_value(45, seed1) == asl::seeded_hash_value(45, seed1));
+    ASL_TEST_EXPECT(asl::seeded_hash_value(45, seed1) != asl::seeded_hash_value(45, seed2));
+    ASL_TEST_EXPECT(asl::seeded_hash_value("hello"_sv, seed1) != asl::seeded_hash_value("hello"_sv, seed2));
+
+    ASL_TEST_EXPECT(asl::process_hash_seed().low == asl::process_hash_seed().low);
+    ASL_TEST_EXPECT(asl::process_hash_seed().high == asl::process_hash_seed().high);
+}
+
+ASL_TEST(siphash)
+{
+    // Reference vectors of SipHash-1-3, with key 00 01 .. 0f, and
+    // messages 00 01 .. (n - 1).
+    const asl::uint128_t key{ .high = 0x0f0e'0d0c'0b0a'0908ULL, .low = 0x0706'0504'0302'0100ULL };
+    uint8_t message[16];
+    for (uint8_t i = 0; i < 16; ++i)
+    {
+        message[i] = i; // NOLINT(*-constant-array-index)
+    }
+
+    ASL_TEST_EXPECT(asl::siphash_value(asl::span<const uint8_t>{message, 0}, key) == 0xabac'0158'050f'c4dcULL);
+    ASL_TEST_EXPECT(asl::siphash_value(asl::span<const uint8_t>{message, 15}, key) == 0xd320'd86d'2a51'9956ULL);
+
+    // Same result when the message is combined in several pieces.
+    auto h = asl::SipHashState{key};
+    h = asl::SipHashState::combine_contiguous(std::move(h), asl::span<const uint8_t>{message, 3});
+    h = asl::SipHashState::combine_contiguous(std::move(h), asl::span<const uint8_t>{message + 3, 12}); // NOLINT(*-pointer-arithmetic)
+    ASL_TEST_EXPECT(asl::SipHashState::finish(std::move(h)) == 0xd320'd86d'2a51'9956ULL);
+
+    ASL_TEST_EXPECT(asl::siphash_value("hello"_sv, key) != asl::siphash_value("hellp"_sv, key));
+    ASL_TEST_EXPECT(asl::siphash_value(45, key) != asl::siphash_value(45, asl::uint128_t{}));
+}
+
 static_assert(asl::hashable<bool>);
 
 ASL_TEST(bool)
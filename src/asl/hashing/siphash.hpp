@@ -0,0 +1,160 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "asl/base/meta.hpp"
+#include "asl/base/bits.hpp"
+#include "asl/base/integers.hpp"
+#include "asl/base/memory_ops.hpp"
+#include "asl/types/span.hpp"
+#include "asl/hashing/hash.hpp"
+
+namespace asl
+{
+
+// Hash state computing SipHash-1-3 of everything combined into it, which
+// can be used instead of HashState with any AslHashValue.
+//
+// SipHash is a keyed hash function: without the key, an attacker can't
+// find inputs that collide, even by looking at many of their hashes. It's
+// a few times slower than HashState on small keys.
+class SipHashState
+{
+    uint64_t m_v0;
+    uint64_t m_v1;
+    uint64_t m_v2;
+    uint64_t m_v3;
+
+    // Bytes not yet compressed, which are less than a word.
+    uint64_t m_tail{};
+    int      m_tail_size{};
+
+    uint64_t m_length{};
+
+    constexpr void round()
+    {
+        m_v0 += m_v1;
+        m_v1 = rotl(m_v1, 13);
+        m_v1 ^= m_v0;
+        m_v0 = rotl(m_v0, 32);
+        m_v2 += m_v3;
+        m_v3 = rotl(m_v3, 16);
+        m_v3 ^= m_v2;
+        m_v0 += m_v3;
+        m_v3 = rotl(m_v3, 21);
+        m_v3 ^= m_v0;
+        m_v2 += m_v1;
+        m_v1 = rotl(m_v1, 17);
+        m_v1 ^= m_v2;
+        m_v2 = rotl(m_v2, 32);
+    }
+
+    constexpr void compress(uint64_t word)
+    {
+        m_v3 ^= word;
+        round();
+        m_v0 ^= word;
+    }
+
+    // Words are read in little endian, which all supported targets are.
+    void write(span<const std::byte> bytes)
+    {
+        m_length += static_cast<uint64_t>(bytes.size());
+
+        while (!bytes.is_empty() && (m_tail_size > 0 || bytes.size() < 8))
+        {
+            m_tail |= static_cast<uint64_t>(bytes[0]) << (8 * m_tail_size);
+            m_tail_size += 1;
+            bytes = bytes.subspan(1);
+
+            if (m_tail_size == 8)
+            {
+                compress(m_tail);
+                m_tail = 0;
+                m_tail_size = 0;
+            }
+        }
+
+        while (bytes.size() >= 8)
+        {
+            uint64_t word{};
+            asl::memcpy(&word, bytes.data(), 8);
+            compress(word);
+            bytes = bytes.subspan(8);
+        }
+
+        for (const std::byte b: bytes)
+        {
+            m_tail |= static_cast<uint64_t>(b) << (8 * m_tail_size);
+            m_tail_size += 1;
+        }
+    }
+
+public:
+    explicit constexpr SipHashState(uint128_t key)
+        : m_v0{key.low ^ 0x736f'6d65'7073'6575ULL}
+        , m_v1{key.high ^ 0x646f'7261'6e64'6f6dULL}
+        , m_v2{key.low ^ 0x6c79'6765'6e65'7261ULL}
+        , m_v3{key.high ^ 0x7465'6462'7974'6573ULL}
+    {}
+
+    template<typename T>
+    static SipHashState combine_contiguous(SipHashState h, span<const T> s)
+    {
+        if constexpr (has_unique_object_representations_v<T>)
+        {
+            h.write(as_bytes(s));
+            return h;
+        }
+        else
+        {
+            for (const auto& value: s)
+            {
+                h = AslHashValue(std::move(h), value);
+            }
+            return h;
+        }
+    }
+
+    static constexpr SipHashState combine(SipHashState h)
+    {
+        return h;
+    }
+
+    template<hashable_generic<SipHashState> Arg, hashable_generic<SipHashState>... Remaining>
+    static constexpr SipHashState combine(SipHashState h, const Arg& arg, const Remaining&... remaining)
+    {
+        return combine(AslHashValue(std::move(h), arg), remaining...);
+    }
+
+    static constexpr uint64_t finish(SipHashState h)
+    {
+        h.compress(h.m_tail | (h.m_length << 56U));
+
+        h.m_v2 ^= 0xff;
+        h.round();
+        h.round();
+        h.round();
+
+        return h.m_v0 ^ h.m_v1 ^ h.m_v2 ^ h.m_v3;
+    }
+};
+
+// Random key for siphash_value, the same for the whole process.
+inline uint128_t process_siphash_key()
+{
+    return hash_internal::process_seeds().siphash_key;
+}
+
+template<typename T>
+concept siphashable = hashable_generic<T, SipHashState>;
+
+template<siphashable T>
+uint64_t siphash_value(const T& value, uint128_t key)
+{
+    return SipHashState::finish(AslHashValue(SipHashState{key}, value));
+}
+
+} // namespace asl
@@ -0,0 +1,159 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/io/buffered_file_writer.hpp"
+
+#include "asl/allocator/allocator.hpp"
+#include "asl/base/assert.hpp"
+#include "asl/base/memory_ops.hpp"
+#include "asl/base/numeric.hpp"
+#include "asl/types/status.hpp"
+
+#if defined(ASL_OS_WINDOWS)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#elif defined(ASL_OS_LINUX)
+    #include <errno.h>
+    #include <sys/uio.h>
+#endif
+
+#if defined(ASL_OS_WINDOWS)
+
+static asl::status write_all(asl::native_file file, asl::span<const std::byte> s)
+{
+    while (!s.is_empty())
+    {
+        DWORD written = 0;
+        const auto to_write = static_cast<DWORD>(asl::min<isize_t>(s.size(), 0x4000'0000));
+        if (WriteFile(file, s.data(), to_write, &written, nullptr) == 0)
+        {
+            return asl::runtime_error("Couldn't write to file: error {}", static_cast<uint32_t>(GetLastError()));
+        }
+        s = s.subspan(static_cast<isize_t>(written));
+    }
+    return asl::ok();
+}
+
+#endif
+
+static asl::status write_all(asl::native_file file, asl::span<const std::byte> a, asl::span<const std::byte> b)
+{
+#if defined(ASL_OS_WINDOWS)
+    // No vectored writes on regular handles, write both parts in turn.
+    asl::status s = write_all(file, a);
+    ASL_TRY(s);
+    return write_all(file, b);
+#elif defined(ASL_OS_LINUX)
+    iovec iov[2] = {
+        { .iov_base = const_cast<std::byte*>(a.data()), .iov_len = static_cast<size_t>(a.size()) }, // NOLINT(*-const-cast)
+        { .iov_base = const_cast<std::byte*>(b.data()), .iov_len = static_cast<size_t>(b.size()) }, // NOLINT(*-const-cast)
+    };
+
+    iovec* first = iov;
+    int count = 2;
+
+    while (count > 0)
+    {
+        const ssize_t written = ::writev(file, first, count);
+        if (written < 0)
+        {
+            if (errno == EINTR) { continue; }
+            return asl::runtime_error("Couldn't write to file: error {}", errno);
+        }
+
+        // Skip what was written, which may end in the middle of a part.
+        auto remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= first->iov_len)
+        {
+            remaining -= first->iov_len;
+            first += 1; // NOLINT(*-pointer-arithmetic)
+            count -= 1;
+        }
+
+        if (count > 0)
+        {
+            first->iov_base = static_cast<uint8_t*>(first->iov_base) + remaining; // NOLINT(*-pointer-arithmetic)
+            first->iov_len -= remaining;
+        }
+    }
+
+    return asl::ok();
+#endif
+}
+
+static bool contains_newline(asl::span<const std::byte> s)
+{
+    return __builtin_memchr(s.data(), '\n', static_cast<size_t>(s.size())) != nullptr;
+}
+
+asl::BufferedFileWriter::BufferedFileWriter(native_file file, flush_mode mode, isize_t buffer_size)
+    : m_file{file}
+    , m_buffer{nullptr}
+    , m_capacity{buffer_size}
+    , m_mode{mode}
+{
+    ASL_ASSERT(buffer_size > 0);
+
+    DefaultAllocator allocator{};
+    m_buffer = static_cast<std::byte*>(allocator.alloc(layout::array<std::byte>(m_capacity)));
+}
+
+asl::BufferedFileWriter::~BufferedFileWriter()
+{
+    flush();
+
+    DefaultAllocator allocator{};
+    allocator.dealloc(m_buffer, layout::array<std::byte>(m_capacity));
+}
+
+void asl::BufferedFileWriter::write(span<const std::byte> s)
+{
+    if (s.size() <= m_capacity - m_size)
+    {
+        asl::memcpy(m_buffer + m_size, s.data(), s.size()); // NOLINT(*-pointer-arithmetic)
+        m_size += s.size();
+
+        if (m_mode == flush_mode::kLine && contains_newline(s))
+        {
+            flush();
+        }
+    }
+    else
+    {
+        record_status(write_all(m_file, {m_buffer, m_size}, s));
+        m_size = 0;
+    }
+}
+
+void asl::BufferedFileWriter::flush()
+{
+    if (m_size > 0)
+    {
+        record_status(write_all(m_file, {m_buffer, m_size}, {}));
+        m_size = 0;
+    }
+}
+
+void asl::BufferedFileWriter::record_status(status s)
+{
+    if (m_status.ok())
+    {
+        m_status = std::move(s);
+    }
+}
+
+void asl::BufferedFileWriter::clear_write_status()
+{
+    m_status = ok();
+}
+
+void asl::BufferedFileWriter::set_mode(flush_mode mode)
+{
+    m_mode = mode;
+    if (m_mode == flush_mode::kLine)
+    {
+        flush();
+    }
+}
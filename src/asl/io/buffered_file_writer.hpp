@@ -0,0 +1,73 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "asl/base/support.hpp"
+#include "asl/base/integers.hpp"
+#include "asl/io/writer.hpp"
+#include "asl/types/status.hpp"
+
+namespace asl
+{
+
+// File descriptor on Linux, HANDLE on Windows.
+#if defined(ASL_OS_WINDOWS)
+using native_file = void*;
+#elif defined(ASL_OS_LINUX)
+using native_file = int;
+#endif
+
+enum class flush_mode : uint8_t
+{
+    // Output is written when the buffer is full, or on flush().
+    kBuffered,
+
+    // Output is also written after each write containing a newline.
+    kLine,
+};
+
+// Writer accumulating output in its own buffer, and writing it straight
+// to the file without going through stdio. When a write doesn't fit,
+// the buffer and the new data are written out together in one call.
+//
+// The file is not owned, the writer flushes on destruction but doesn't close it.
+//
+// When writing to the file fails, what couldn't be written is dropped and
+// the error is kept in write_status(). Later writes are still attempted,
+// but only the first error is kept until clear_write_status() is called.
+class BufferedFileWriter : public Writer
+{
+    native_file m_file;
+    std::byte*  m_buffer;
+    isize_t     m_capacity;
+    isize_t     m_size{};
+    flush_mode  m_mode;
+    status      m_status = ok();
+
+    void record_status(status);
+
+public:
+    static constexpr isize_t kDefaultBufferSize = 4096;
+
+    BufferedFileWriter(native_file file, flush_mode mode, isize_t buffer_size = kDefaultBufferSize);
+
+    ASL_DELETE_COPY_MOVE(BufferedFileWriter);
+
+    ~BufferedFileWriter() override;
+
+    void write(span<const std::byte>) override;
+
+    void flush() override;
+
+    [[nodiscard]] constexpr flush_mode mode() const { return m_mode; }
+
+    void set_mode(flush_mode mode);
+
+    [[nodiscard]] constexpr const status& write_status() const { return m_status; }
+
+    void clear_write_status();
+};
+
+} // namespace asl
@@ -0,0 +1,160 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/io/buffered_file_writer.hpp"
+#include "asl/base/defer.hpp"
+#include "asl/strings/string_view.hpp"
+#include "asl/testing/testing.hpp"
+#include "asl/tests/temp_file.hpp"
+
+#if defined(ASL_OS_LINUX)
+    #include <signal.h>
+    #include <sys/resource.h>
+#endif
+
+static void write(asl::Writer& writer, asl::string_view sv)
+{
+    writer.write(asl::as_bytes(sv.as_span()));
+}
+
+static bool file_is(const TempFile& file, asl::string_view expected)
+{
+    char data[256];
+    const isize_t size = file.read(data, 256);
+    return asl::string_view{data, size} == expected;
+}
+
+ASL_TEST(buffered)
+{
+    const TempFile file;
+    asl::BufferedFileWriter writer{file.handle(), asl::flush_mode::kBuffered, 16};
+
+    write(writer, "hello\n");
+    ASL_TEST_EXPECT(file_is(file, ""));
+
+    // Exactly fills the buffer.
+    write(writer, "0123456789");
+    ASL_TEST_EXPECT(file_is(file, ""));
+
+    write(writer, "x");
+    ASL_TEST_EXPECT(file_is(file, "hello\n0123456789x"));
+}
+
+ASL_TEST(line)
+{
+    const TempFile file;
+    asl::BufferedFileWriter writer{file.handle(), asl::flush_mode::kLine, 16};
+
+    write(writer, "abc");
+    ASL_TEST_EXPECT(file_is(file, ""));
+
+    // Everything pending goes out, including what follows the newline.
+    write(writer, "de\nf");
+    ASL_TEST_EXPECT(file_is(file, "abcde\nf"));
+
+    write(writer, "g");
+    ASL_TEST_EXPECT(file_is(file, "abcde\nf"));
+}
+
+ASL_TEST(larger_than_buffer)
+{
+    const TempFile file;
+    asl::BufferedFileWriter writer{file.handle(), asl::flush_mode::kBuffered, 8};
+
+    write(writer, "abc");
+    write(writer, "this doesn't fit in 8 bytes");
+    ASL_TEST_EXPECT(file_is(file, "abcthis doesn't fit in 8 bytes"));
+
+    // The buffer is empty again, and used for the next writes.
+    write(writer, "z");
+    ASL_TEST_EXPECT(file_is(file, "abcthis doesn't fit in 8 bytes"));
+
+    writer.flush();
+    ASL_TEST_EXPECT(file_is(file, "abcthis doesn't fit in 8 bytesz"));
+    ASL_TEST_EXPECT(writer.write_status().ok());
+}
+
+ASL_TEST(flush)
+{
+    const TempFile file;
+
+    {
+        asl::BufferedFileWriter writer{file.handle(), asl::flush_mode::kBuffered, 16};
+
+        write(writer, "abc");
+        writer.flush();
+        ASL_TEST_EXPECT(file_is(file, "abc"));
+
+        // Nothing pending.
+        writer.flush();
+        ASL_TEST_EXPECT(file_is(file, "abc"));
+
+        write(writer, "def");
+        ASL_TEST_EXPECT(file_is(file, "abc"));
+    }
+
+    // Flushed on destruction.
+    ASL_TEST_EXPECT(file_is(file, "abcdef"));
+}
+
+ASL_TEST(set_mode)
+{
+    const TempFile file;
+    asl::BufferedFileWriter writer{file.handle(), asl::flush_mode::kBuffered, 16};
+
+    write(writer, "a\nb");
+    ASL_TEST_EXPECT(file_is(file, ""));
+
+    writer.set_mode(asl::flush_mode::kLine);
+    ASL_TEST_EXPECT(writer.mode() == asl::flush_mode::kLine);
+    ASL_TEST_EXPECT(file_is(file, "a\nb"));
+}
+
+#if defined(ASL_OS_LINUX)
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(partial_write)
+{
+    const TempFile file;
+    asl::BufferedFileWriter writer{file.handle(), asl::flush_mode::kBuffered, 8};
+
+    // With a file size limit, writev only writes what fits under it and
+    // then fails, instead of raising SIGXFSZ.
+    rlimit old_limit{};
+    ASL_TEST_ASSERT(getrlimit(RLIMIT_FSIZE, &old_limit) == 0);
+    ASL_TEST_ASSERT(old_limit.rlim_max == RLIM_INFINITY || old_limit.rlim_max >= 10);
+
+    auto* old_handler = signal(SIGXFSZ, SIG_IGN); // NOLINT(*-cstyle-cast)
+    ASL_DEFER [&old_limit, old_handler]() {
+        setrlimit(RLIMIT_FSIZE, &old_limit);
+        signal(SIGXFSZ, old_handler);
+    };
+
+    rlimit limit = old_limit;
+    limit.rlim_cur = 10;
+    ASL_TEST_ASSERT(setrlimit(RLIMIT_FSIZE, &limit) == 0);
+
+    // The limit ends in the middle of the second part of the writev.
+    write(writer, "abcd");
+    write(writer, "efghijklmnop");
+    ASL_TEST_EXPECT(file_is(file, "abcdefghij"));
+    ASL_TEST_EXPECT(!writer.write_status().ok());
+    ASL_TEST_EXPECT(writer.write_status().code() == asl::status_code::runtime);
+
+    // Later writes fail as well.
+    write(writer, "0123456789");
+    ASL_TEST_EXPECT(file_is(file, "abcdefghij"));
+    ASL_TEST_EXPECT(!writer.write_status().ok());
+
+    ASL_TEST_ASSERT(setrlimit(RLIMIT_FSIZE, &old_limit) == 0);
+    writer.clear_write_status();
+    ASL_TEST_EXPECT(writer.write_status().ok());
+
+    // Nothing that failed is written again.
+    write(writer, "qrstuvwxyz");
+    ASL_TEST_EXPECT(file_is(file, "abcdefghijqrstuvwxyz"));
+    ASL_TEST_EXPECT(writer.write_status().ok());
+}
+
+#endif
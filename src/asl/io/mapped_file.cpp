@@ -0,0 +1,113 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/io/mapped_file.hpp"
+
+#include "asl/allocator/allocator.hpp"
+#include "asl/base/defer.hpp"
+#include "asl/base/memory_ops.hpp"
+#include "asl/types/status.hpp"
+
+#if defined(ASL_OS_WINDOWS)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#elif defined(ASL_OS_LINUX)
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+asl::status_or<asl::MappedFile> asl::MappedFile::open(string_view path)
+{
+    // The OS wants a null-terminated path.
+    DefaultAllocator allocator{};
+    const layout path_layout = layout::array<char>(path.size() + 1);
+    auto* c_path = static_cast<char*>(allocator.alloc(path_layout));
+    ASL_DEFER [&allocator, c_path, &path_layout]() { allocator.dealloc(c_path, path_layout); };
+
+    asl::memcpy(c_path, path.data(), path.size());
+    c_path[path.size()] = '\0'; // NOLINT(*-pointer-arithmetic)
+
+#if defined(ASL_OS_WINDOWS)
+    HANDLE file = CreateFileA(
+        c_path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return runtime_error("Couldn't open {}: error {}", path, static_cast<uint32_t>(GetLastError()));
+    }
+    ASL_DEFER [file]() { CloseHandle(file); };
+
+    LARGE_INTEGER size{};
+    if (GetFileSizeEx(file, &size) == 0)
+    {
+        return runtime_error("Couldn't get the size of {}: error {}", path, static_cast<uint32_t>(GetLastError()));
+    }
+
+    // Empty files can't be mapped.
+    if (size.QuadPart == 0) { return MappedFile{}; }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        return runtime_error("Couldn't map {}: error {}", path, static_cast<uint32_t>(GetLastError()));
+    }
+
+    // The view keeps the mapping alive.
+    ASL_DEFER [mapping]() { CloseHandle(mapping); };
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+    {
+        return runtime_error("Couldn't map {}: error {}", path, static_cast<uint32_t>(GetLastError()));
+    }
+
+    return MappedFile{static_cast<const std::byte*>(data), static_cast<isize_t>(size.QuadPart)};
+#elif defined(ASL_OS_LINUX)
+    const int file = ::open(c_path, O_RDONLY | O_CLOEXEC); // NOLINT(*-vararg)
+    if (file < 0)
+    {
+        return runtime_error("Couldn't open {}: error {}", path, errno);
+    }
+
+    // The mapping stays valid after the file is closed.
+    ASL_DEFER [file]() { ::close(file); };
+
+    struct stat info{};
+    if (::fstat(file, &info) != 0)
+    {
+        return runtime_error("Couldn't get the size of {}: error {}", path, errno);
+    }
+
+    // Empty files can't be mapped.
+    const auto size = static_cast<isize_t>(info.st_size);
+    if (size == 0) { return MappedFile{}; }
+
+    void* data = ::mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_PRIVATE, file, 0);
+    if (data == MAP_FAILED) // NOLINT(*-cstyle-cast)
+    {
+        return runtime_error("Couldn't map {}: error {}", path, errno);
+    }
+
+    return MappedFile{static_cast<const std::byte*>(data), size};
+#endif
+}
+
+void asl::MappedFile::unmap()
+{
+    if (m_data == nullptr) { return; }
+
+#if defined(ASL_OS_WINDOWS)
+    UnmapViewOfFile(m_data);
+#elif defined(ASL_OS_LINUX)
+    // NOLINTNEXTLINE(*-const-cast)
+    ::munmap(const_cast<std::byte*>(m_data), static_cast<size_t>(m_size));
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
@@ -0,0 +1,63 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "asl/base/support.hpp"
+#include "asl/base/byte.hpp"
+#include "asl/base/meta.hpp"
+#include "asl/strings/string_view.hpp"
+#include "asl/types/span.hpp"
+#include "asl/types/status_or.hpp"
+
+namespace asl
+{
+
+// Whole content of a file, mapped read-only in memory. Pages are read from
+// the file when first accessed, and are shared with the OS file cache,
+// so opening a big file is cheap, and nothing is copied.
+//
+// The mapping starts on a page boundary, which is aligned enough for
+// anything that can be loaded in place, like hash_set images.
+class MappedFile
+{
+    const std::byte* m_data{};
+    isize_t          m_size{};
+
+    MappedFile(const std::byte* data, isize_t size) : m_data{data}, m_size{size} {}
+
+    void unmap();
+
+public:
+    constexpr MappedFile() = default;
+
+    static status_or<MappedFile> open(string_view path);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other)
+        : m_data{std::exchange(other.m_data, nullptr)}
+        , m_size{std::exchange(other.m_size, 0)}
+    {}
+
+    MappedFile& operator=(MappedFile&& other)
+    {
+        if (&other != this)
+        {
+            unmap();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile() { unmap(); }
+
+    [[nodiscard]] span<const std::byte> bytes() const { return {m_data, m_size}; }
+
+    [[nodiscard]] isize_t size() const { return m_size; }
+};
+
+} // namespace asl
@@ -0,0 +1,60 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/io/mapped_file.hpp"
+#include "asl/io/buffered_file_writer.hpp"
+#include "asl/containers/hash_map.hpp"
+#include "asl/containers/hash_view.hpp"
+#include "asl/strings/string_view.hpp"
+#include "asl/testing/testing.hpp"
+#include "asl/tests/temp_file.hpp"
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(hash_map_image)
+{
+    asl::hash_map<int, int64_t> map;
+    for (int i = 0; i < 1000; ++i)
+    {
+        map.insert(i, int64_t{i} * 3);
+    }
+
+    TempFile file;
+    {
+        asl::BufferedFileWriter writer{file.handle(), asl::flush_mode::kBuffered};
+        map.write_image(&writer);
+        writer.flush();
+        ASL_TEST_ASSERT(writer.write_status().ok());
+    }
+
+    // MappedFile doesn't share the file with writers.
+    file.close();
+
+    auto mapped = asl::MappedFile::open(asl::string_view::from_zstr(file.path()));
+    ASL_TEST_ASSERT(mapped.ok());
+
+    auto view = asl::hash_map_view<int, int64_t>::from_image(mapped.value().bytes());
+    ASL_TEST_ASSERT(view.ok());
+    ASL_TEST_EXPECT(view.value().size() == 1000);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        const int64_t* value = view.value().get(i);
+        ASL_TEST_ASSERT(value != nullptr);
+        ASL_TEST_EXPECT(*value == int64_t{i} * 3);
+    }
+    ASL_TEST_EXPECT(view.value().get(1000) == nullptr);
+}
+
+ASL_TEST(empty_file)
+{
+    TempFile file;
+    file.close();
+
+    auto mapped = asl::MappedFile::open(asl::string_view::from_zstr(file.path()));
+    ASL_TEST_ASSERT(mapped.ok());
+    ASL_TEST_EXPECT(mapped.value().size() == 0);
+
+    // Too small for an image header.
+    ASL_TEST_EXPECT(!asl::hash_map_view<int, int64_t>::from_image(mapped.value().bytes()).ok());
+}
@@ -4,32 +4,123 @@
 
 #include "asl/io/print.hpp"
 
-#include <cstdio>
+#include "asl/allocator/allocator.hpp"
+#include "asl/io/buffered_file_writer.hpp"
+#include "asl/synchronization/spin_lock.hpp"
 
-// @Todo Optimize this, maybe make buffered
+#include <stdlib.h>
+
+#if defined(ASL_OS_WINDOWS)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#elif defined(ASL_OS_LINUX)
+    #include <unistd.h>
+#endif
+
+static asl::native_file stdout_file()
+{
+#if defined(ASL_OS_WINDOWS)
+    return GetStdHandle(STD_OUTPUT_HANDLE);
+#elif defined(ASL_OS_LINUX)
+    return STDOUT_FILENO;
+#endif
+}
+
+static asl::native_file stderr_file()
+{
+#if defined(ASL_OS_WINDOWS)
+    return GetStdHandle(STD_ERROR_HANDLE);
+#elif defined(ASL_OS_LINUX)
+    return STDERR_FILENO;
+#endif
+}
+
+static bool is_terminal(asl::native_file file)
+{
+#if defined(ASL_OS_WINDOWS)
+    return GetFileType(file) == FILE_TYPE_CHAR;
+#elif defined(ASL_OS_LINUX)
+    return isatty(file) != 0;
+#endif
+}
+
+namespace
+{
+
+// stdout and stderr are shared by all threads, so their writers are
+// behind a lock. Each write goes out whole, but a print made of several
+// writes can still be interleaved with other threads' output.
 class ConsoleWriter : public asl::Writer
 {
-    FILE* m_handle;
+    asl::SpinLock           m_lock;
+    asl::BufferedFileWriter m_writer;
 
 public:
-    explicit ConsoleWriter(FILE* handle)
-        : m_handle{handle}
+    ConsoleWriter(asl::native_file file, asl::flush_mode mode)
+        : m_writer{file, mode}
     {}
 
+    ASL_DELETE_COPY_MOVE(ConsoleWriter);
+
+    ~ConsoleWriter() override = default;
+
     void write(asl::span<const std::byte> s) override
     {
-        (void)fwrite(s.data(), 1, static_cast<size_t>(s.size()), m_handle);
+        m_lock.lock();
+        m_writer.write(s);
+        m_lock.unlock();
+    }
+
+    void flush() override
+    {
+        m_lock.lock();
+        m_writer.flush();
+        m_lock.unlock();
     }
 };
 
+}  // namespace
+
+// Like stdio: stdout is line buffered when interactive, and fully buffered
+// otherwise, so that batch jobs piping their output don't make a write
+// call per line. Output still buffered is lost if the program crashes,
+// unless flush_stdout() was called. stderr always goes out at the end of
+// each line.
+//
+// The writers are never destroyed, so printing and logging keep working
+// from other static destructors. They're flushed at exit instead. Static
+// destructors of objects created before them run after that, so what
+// they print might stay in the buffer.
+
+static void flush_stderr()
+{
+    asl::print_internals::get_stderr_writer()->flush();
+}
+
 asl::Writer* asl::print_internals::get_stdout_writer()
 {
-    static ConsoleWriter s_writer{stdout};
-    return &s_writer;
+    static ConsoleWriter* s_writer = []() {
+        auto* writer = alloc_new_default<ConsoleWriter>(
+            stdout_file(),
+            is_terminal(stdout_file()) ? flush_mode::kLine : flush_mode::kBuffered);
+        atexit(flush_stdout);
+        return writer;
+    }();
+    return s_writer;
 }
 
 asl::Writer* asl::print_internals::get_stderr_writer()
 {
-    static ConsoleWriter s_writer{stderr};
-    return &s_writer;
+    static ConsoleWriter* s_writer = []() {
+        auto* writer = alloc_new_default<ConsoleWriter>(stderr_file(), flush_mode::kLine);
+        atexit(flush_stderr);
+        return writer;
+    }();
+    return s_writer;
+}
+
+void asl::flush_stdout()
+{
+    print_internals::get_stdout_writer()->flush();
 }
@@ -13,20 +13,22 @@ namespace asl
 namespace print_internals
 {
 
-// @Todo Make print writers thread safe
 Writer* get_stdout_writer();
 Writer* get_stderr_writer();
 
 } // namespace print_internals
 
+// stdout is buffered, this writes out what's pending.
+void flush_stdout();
+
 template<formattable... Args>
-void print(string_view fmt, const Args&... args)
+void print(format_string<type_identity_t<Args>...> fmt, const Args&... args)
 {
     format(print_internals::get_stdout_writer(), fmt, args...);
 }
 
 template<formattable... Args>
-void eprint(string_view fmt, const Args&... args)
+void eprint(format_string<type_identity_t<Args>...> fmt, const Args&... args)
 {
     format(print_internals::get_stderr_writer(), fmt, args...);
 }
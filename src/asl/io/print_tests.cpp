@@ -0,0 +1,88 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/io/print.hpp"
+#include "asl/base/defer.hpp"
+#include "asl/strings/string_view.hpp"
+#include "asl/testing/testing.hpp"
+#include "asl/tests/temp_file.hpp"
+#include "asl/tests/threads.hpp"
+
+#if defined(ASL_OS_LINUX)
+
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static constexpr int kLinesPerThread = 1000;
+
+// Printed in a single write.
+static constexpr asl::string_view kLine = "The quick brown fox jumps over the lazy dog\n";
+
+static constexpr isize_t kExpectedSize = kThreadCount * kLinesPerThread * kLine.size();
+
+static void print_lines(int, void*)
+{
+    for (int i = 0; i < kLinesPerThread; ++i)
+    {
+        asl::print("The quick brown fox jumps over the lazy dog\n");
+    }
+}
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(print_from_threads)
+{
+    const TempFile file;
+
+    // stdout goes to the file until the end of the test.
+    asl::flush_stdout();
+    const int old_stdout = dup(STDOUT_FILENO);
+    ASL_TEST_ASSERT(old_stdout >= 0);
+    ASL_DEFER [old_stdout]() {
+        asl::flush_stdout();
+        dup2(old_stdout, STDOUT_FILENO);
+        close(old_stdout);
+    };
+    ASL_TEST_ASSERT(dup2(file.handle(), STDOUT_FILENO) >= 0);
+
+    run_threads(print_lines, nullptr);
+    asl::flush_stdout();
+
+    // Nothing is lost, and lines aren't cut by other threads' writes.
+    static char s_data[kExpectedSize + 1];
+    ASL_TEST_ASSERT(file.read(s_data, kExpectedSize + 1) == kExpectedSize);
+
+    const asl::string_view data{s_data, kExpectedSize};
+    for (isize_t offset = 0; offset < kExpectedSize; offset += kLine.size())
+    {
+        ASL_TEST_ASSERT(data.substr(offset, kLine.size()) == kLine);
+    }
+}
+
+ASL_TEST(flush_at_exit)
+{
+    const TempFile file;
+
+    // Nothing pending for the child to inherit.
+    asl::flush_stdout();
+
+    const pid_t pid = fork();
+    ASL_TEST_ASSERT(pid >= 0);
+    if (pid == 0)
+    {
+        dup2(file.handle(), STDOUT_FILENO);
+        asl::print("No newline");
+        exit(0);
+    }
+
+    int wait_status = 0;
+    ASL_TEST_ASSERT(waitpid(pid, &wait_status, 0) == pid);
+    ASL_TEST_EXPECT(WIFEXITED(wait_status) && WEXITSTATUS(wait_status) == 0); // NOLINT(*-signed-bitwise)
+
+    char data[32];
+    const isize_t size = file.read(data, 32);
+    ASL_TEST_EXPECT(asl::string_view{data, size} == "No newline");
+}
+
+#endif
@@ -19,6 +19,9 @@ public:
     virtual ~Writer() = default;
 
     virtual void write(span<const std::byte>) = 0;
+
+    // Writers buffering their output write it out here.
+    virtual void flush() {}
 };
 
 } // namespace asl
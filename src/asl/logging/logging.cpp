@@ -4,39 +4,187 @@
 
 #include "asl/logging/logging.hpp"
 
-#include "asl/containers/intrusive_list.hpp"
+#include "asl/allocator/allocator.hpp"
+#include "asl/base/memory.hpp"
+#include "asl/base/memory_ops.hpp"
+#include "asl/base/numeric.hpp"
 #include "asl/formatting/format.hpp"
 #include "asl/io/print.hpp"
 #include "asl/io/writer.hpp"
-#include "asl/strings/string_builder.hpp"
 #include "asl/strings/string_view.hpp"
-#include "asl/types/span.hpp"
+#include "asl/synchronization/atomic.hpp"
+#include "asl/synchronization/spin_lock.hpp"
+#include "asl/synchronization/wait.hpp"
+
+#if defined(ASL_OS_WINDOWS)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#elif defined(ASL_OS_LINUX)
+    #include <pthread.h>
+#endif
 
 // @Todo Don't use internal get_stdout_writer, make console module
 
 // NOLINTNEXTLINE(*-avoid-non-const-global-variables)
 static asl::log::DefaultLogger<asl::Writer*> g_default_logger{asl::print_internals::get_stdout_writer()};
 
-// @Todo Protect the loggers list being a mutex
-// NOLINTNEXTLINE(*-avoid-non-const-global-variables)
-static asl::IntrusiveList<asl::log::Logger> g_loggers(&g_default_logger);
+namespace
+{
+
+// Immutable once published, registration replaces it with a new one.
+struct LoggerSnapshot
+{
+    asl::log::Logger** loggers;
+    isize_t            count;
+};
+
+}  // namespace
+
+// NOLINTBEGIN(*-avoid-non-const-global-variables)
+static asl::log::Logger* g_default_loggers[] = { &g_default_logger };
+static LoggerSnapshot g_default_snapshot{ .loggers = g_default_loggers, .count = 1 };
+
+static asl::atomic<LoggerSnapshot*> g_loggers{ &g_default_snapshot };
+
+// Serializes registration, log calls never take it. Registration is rare,
+// so it's fine for the others to spin while one waits for readers.
+static asl::SpinLock g_registry_lock{};
+
+// Threads reading the snapshot count themselves in the counter for the
+// parity of the current epoch. After replacing the snapshot, registration
+// flips the epoch twice, each time waiting for the readers counted with the
+// previous parity to be done. Then no one can still be using the old one.
+static asl::atomic<uint32_t> g_reader_epoch{};
+static asl::atomic<isize_t>  g_readers[2]{};
+// NOLINTEND(*-avoid-non-const-global-variables)
+
+template<typename Callback>
+static void for_each_logger(const Callback& callback)
+{
+    const uint32_t parity = asl::atomic_load(&g_reader_epoch, asl::memory_order::seq_cst) & 1;
+    asl::atomic<isize_t>* readers = &g_readers[parity]; // NOLINT(*-constant-array-index)
+    asl::atomic_fetch_increment(readers, asl::memory_order::seq_cst);
+
+    const LoggerSnapshot* snapshot = asl::atomic_load(&g_loggers, asl::memory_order::seq_cst);
+    for (isize_t i = 0; i < snapshot->count; ++i)
+    {
+        callback(*snapshot->loggers[i]); // NOLINT(*-pointer-arithmetic)
+    }
+
+    asl::atomic_fetch_decrement(readers, asl::memory_order::release);
+}
+
+static void wait_for_readers()
+{
+    for (int i = 0; i < 2; ++i)
+    {
+        const uint32_t epoch = asl::atomic_fetch_increment(&g_reader_epoch, asl::memory_order::seq_cst);
+        asl::atomic<isize_t>* readers = &g_readers[epoch & 1]; // NOLINT(*-constant-array-index)
+        while (asl::atomic_load(readers, asl::memory_order::acquire) > 0)
+        {
+            asl::yield_thread();
+        }
+    }
+}
+
+static LoggerSnapshot* allocate_snapshot(isize_t count)
+{
+    asl::DefaultAllocator allocator{};
+    auto* loggers = static_cast<asl::log::Logger**>(
+        allocator.alloc(asl::layout::array<asl::log::Logger*>(count)));
+    return new (allocator.alloc(asl::layout::of<LoggerSnapshot>())) LoggerSnapshot{
+        .loggers = loggers,
+        .count = count,
+    };
+}
+
+// Must be called with the registry lock held.
+static void replace_snapshot(LoggerSnapshot* snapshot)
+{
+    LoggerSnapshot* previous = asl::atomic_exchange(&g_loggers, snapshot, asl::memory_order::seq_cst);
+    wait_for_readers();
+
+    if (previous != &g_default_snapshot)
+    {
+        asl::DefaultAllocator allocator{};
+        allocator.dealloc(previous->loggers, asl::layout::array<asl::log::Logger*>(previous->count));
+        allocator.dealloc(previous, asl::layout::of<LoggerSnapshot>());
+    }
+}
+
+static bool contains(const LoggerSnapshot* snapshot, const asl::log::Logger* logger)
+{
+    for (isize_t i = 0; i < snapshot->count; ++i)
+    {
+        if (snapshot->loggers[i] == logger) { return true; } // NOLINT(*-pointer-arithmetic)
+    }
+    return false;
+}
+
+// Must be called with the registry lock held.
+static void add_logger(asl::log::Logger* logger)
+{
+    const LoggerSnapshot* current = asl::atomic_load(&g_loggers, asl::memory_order::relaxed);
+
+    LoggerSnapshot* snapshot = allocate_snapshot(current->count + 1);
+    // NOLINTBEGIN(*-pointer-arithmetic)
+    snapshot->loggers[0] = logger;
+    for (isize_t i = 0; i < current->count; ++i)
+    {
+        snapshot->loggers[i + 1] = current->loggers[i];
+    }
+    // NOLINTEND(*-pointer-arithmetic)
+    replace_snapshot(snapshot);
+}
 
 void asl::log::register_logger(Logger* logger)
 {
-    g_loggers.push_front(logger);
+    g_registry_lock.lock();
+
+    ASL_ASSERT(!contains(atomic_load(&g_loggers, memory_order::relaxed), logger));
+    add_logger(logger);
+
+    g_registry_lock.unlock();
 }
 
 void asl::log::unregister_logger(Logger* logger)
 {
-    g_loggers.detach(logger);
+    g_registry_lock.lock();
+
+    const LoggerSnapshot* current = atomic_load(&g_loggers, memory_order::relaxed);
+    if (contains(current, logger))
+    {
+        LoggerSnapshot* snapshot = allocate_snapshot(current->count - 1);
+
+        isize_t count = 0;
+        for (isize_t i = 0; i < current->count; ++i)
+        {
+            // NOLINTNEXTLINE(*-pointer-arithmetic)
+            if (current->loggers[i] != logger) { snapshot->loggers[count++] = current->loggers[i]; }
+        }
+
+        replace_snapshot(snapshot);
+    }
+
+    g_registry_lock.unlock();
 }
 
 void asl::log::remove_default_logger()
 {
-    if (g_default_logger.m_next != nullptr)
+    unregister_logger(&g_default_logger);
+}
+
+void asl::log::restore_default_logger()
+{
+    g_registry_lock.lock();
+
+    if (!contains(atomic_load(&g_loggers, memory_order::relaxed), &g_default_logger))
     {
-        g_loggers.detach(&g_default_logger);
+        add_logger(&g_default_logger);
     }
+
+    g_registry_lock.unlock();
 }
 
 static constexpr asl::string_view kLevelName[] = {
@@ -55,24 +203,508 @@ void asl::log::DefaultLoggerBase::log_inner(Writer& writer, const message& msg)
         msg.message);
 }
 
-void asl::log::log_inner(
-    level l,
-    string_view fmt, span<const format_internals::type_erased_arg> args,
-    const source_location& sl)
+void asl::log::log_internals::dispatch(level l, string_view msg, const source_location& sl)
 {
-    // @Todo Use temporary allocator
-    StringWriter msg_writer{};
-    asl::format_internals::format(&msg_writer, fmt, args);
-
     const message m{
         .level = l,
-        .message = msg_writer.as_string_view(),
+        .message = msg,
         .location = sl,
     };
 
-    for (auto& logger: g_loggers)
+    for_each_logger([&m](Logger& logger) { logger.log(m); });
+}
+
+static void flush_loggers()
+{
+    for_each_logger([](asl::log::Logger& logger) { logger.flush(); });
+}
+
+// Records are claimed by the logging calls and consumed by the logging thread
+// in order, each record's sequence telling whose turn it is. For the record
+// at position p in the queue, it's p when free, p + 1 once published, and
+// p + capacity when consumed, making it free for the next lap.
+struct alignas(64) asl::log::log_internals::record
+{
+    atomic<uint64_t> sequence;
+    level            level;
+    source_location  location;
+    isize_t          size;
+    char             text[kMaxAsyncMessageSize]; // NOLINT(*-member-init)
+};
+
+namespace
+{
+
+// Lets threads sleep until a condition becomes true, without the threads
+// making it true paying for a syscall when nobody is waiting.
+class EventCount
+{
+    asl::atomic<uint32_t> m_epoch{};
+    asl::atomic<uint32_t> m_waiters{};
+
+public:
+    // The condition must be checked after this, and the wait canceled if
+    // it's already true.
+    uint32_t prepare_wait()
+    {
+        asl::atomic_fetch_increment(&m_waiters, asl::memory_order::seq_cst);
+        const uint32_t epoch = asl::atomic_load(&m_epoch, asl::memory_order::seq_cst);
+        asl::atomic_fence(asl::memory_order::seq_cst);
+        return epoch;
+    }
+
+    void cancel_wait()
+    {
+        asl::atomic_fetch_decrement(&m_waiters, asl::memory_order::seq_cst);
+    }
+
+    void wait(uint32_t epoch)
+    {
+        asl::atomic_wait(&m_epoch, epoch);
+        cancel_wait();
+    }
+
+    // Must be called after making the condition true.
+    void notify_all()
+    {
+        asl::atomic_fence(asl::memory_order::seq_cst);
+        if (asl::atomic_load(&m_waiters, asl::memory_order::relaxed) > 0)
+        {
+            asl::atomic_fetch_increment(&m_epoch, asl::memory_order::seq_cst);
+            asl::atomic_notify_all(&m_epoch);
+        }
+    }
+};
+
+#if defined(ASL_OS_WINDOWS)
+using native_thread = HANDLE;
+#elif defined(ASL_OS_LINUX)
+using native_thread = pthread_t;
+#endif
+
+struct AsyncLogger
+{
+    using record = asl::log::log_internals::record;
+
+    record*                    records;
+    uint64_t                   mask;
+    asl::log::overflow_policy  overflow;
+    native_thread              thread;
+
+    alignas(64) asl::atomic<uint64_t> write_position;
+
+    // Only touched by the logging thread.
+    alignas(64) uint64_t read_position;
+
+    asl::atomic<uint64_t> flushed_position;
+    asl::atomic<uint64_t> flush_request;
+    asl::atomic<bool>     stopping;
+
+    EventCount has_space;
+    EventCount has_flushed;
+};
+
+}  // namespace
+
+// Number of records the logging thread passes to the loggers before
+// checking for flush requests and blocked logging calls.
+static constexpr uint64_t kBatchSize = 64;
+
+// NOLINTBEGIN(*-avoid-non-const-global-variables)
+static asl::atomic<AsyncLogger*> g_async_logger{};
+
+// Logging calls which may be using the async logger, so that it's only
+// destroyed once they're done with it.
+static asl::atomic<isize_t> g_async_users{};
+
+static asl::atomic<uint64_t> g_dropped_messages{};
+
+// Outside of the async logger, which publishing calls could otherwise see
+// destroyed after their record is consumed.
+static EventCount g_has_records{};
+
+static thread_local bool t_is_logging_thread{};
+// NOLINTEND(*-avoid-non-const-global-variables)
+
+static AsyncLogger::record& record_at(AsyncLogger* logger, uint64_t position)
+{
+    return logger->records[position & logger->mask]; // NOLINT(*-pointer-arithmetic)
+}
+
+static bool is_published(AsyncLogger* logger, uint64_t position)
+{
+    return asl::atomic_load(&record_at(logger, position).sequence, asl::memory_order::acquire) == position + 1;
+}
+
+static AsyncLogger::record* try_claim(AsyncLogger* logger)
+{
+    uint64_t position = asl::atomic_load(&logger->write_position, asl::memory_order::relaxed);
+    while (true)
+    {
+        auto& r = record_at(logger, position);
+        const uint64_t sequence = asl::atomic_load(&r.sequence, asl::memory_order::acquire);
+
+        if (sequence == position)
+        {
+            if (asl::atomic_compare_exchange(&logger->write_position, &position, position + 1))
+            {
+                return &r;
+            }
+        }
+        else if (sequence < position)
+        {
+            // Still holding the message from the previous lap.
+            return nullptr;
+        }
+        else
+        {
+            position = asl::atomic_load(&logger->write_position, asl::memory_order::relaxed);
+        }
+    }
+}
+
+static void report_dropped_messages(uint64_t* reported)
+{
+    const uint64_t dropped = asl::atomic_load(&g_dropped_messages, asl::memory_order::relaxed);
+    if (dropped != *reported)
     {
-        logger.log(m);
+        asl::StringWriter writer{};
+        asl::format(&writer, "{} log messages were dropped, the queue was full", dropped - *reported);
+        asl::log::log_internals::dispatch(asl::log::level::kWarning, writer.as_string_view(), asl::source_location{});
+        *reported = dropped;
     }
 }
 
+static void run_logging_thread(AsyncLogger* logger)
+{
+    t_is_logging_thread = true;
+    uint64_t reported_drops = asl::atomic_load(&g_dropped_messages, asl::memory_order::relaxed);
+
+    while (true)
+    {
+        uint64_t batch = 0;
+        while (batch < kBatchSize && is_published(logger, logger->read_position))
+        {
+            auto& r = record_at(logger, logger->read_position);
+            asl::log::log_internals::dispatch(r.level, asl::string_view{r.text, r.size}, r.location);
+
+            asl::atomic_store(&r.sequence, logger->read_position + logger->mask + 1, asl::memory_order::release);
+            logger->read_position += 1;
+            batch += 1;
+        }
+
+        if (batch > 0)
+        {
+            logger->has_space.notify_all();
+        }
+
+        report_dropped_messages(&reported_drops);
+
+        const bool is_empty = !is_published(logger, logger->read_position);
+        const uint64_t flushed = asl::atomic_load(&logger->flushed_position, asl::memory_order::relaxed);
+        const uint64_t request = asl::atomic_load(&logger->flush_request, asl::memory_order::acquire);
+        const bool is_requested = request > flushed && logger->read_position >= request;
+
+        // Loggers are flushed whenever the queue runs empty, so that messages
+        // don't stay buffered while the thread sleeps.
+        if (logger->read_position != flushed && (is_empty || is_requested))
+        {
+            flush_loggers();
+            asl::atomic_store(&logger->flushed_position, logger->read_position, asl::memory_order::release);
+            logger->has_flushed.notify_all();
+        }
+
+        if (is_empty)
+        {
+            // Once stopping, all logging calls have published their record.
+            const bool is_stopping = asl::atomic_load(&logger->stopping, asl::memory_order::acquire);
+            if (is_published(logger, logger->read_position)) { continue; }
+            if (is_stopping) { break; }
+
+            const uint32_t epoch = g_has_records.prepare_wait();
+            if (is_published(logger, logger->read_position)
+                || asl::atomic_load(&logger->stopping, asl::memory_order::acquire))
+            {
+                g_has_records.cancel_wait();
+            }
+            else
+            {
+                g_has_records.wait(epoch);
+            }
+        }
+    }
+}
+
+#if defined(ASL_OS_WINDOWS)
+
+static DWORD WINAPI logging_thread_main(LPVOID user)
+{
+    run_logging_thread(static_cast<AsyncLogger*>(user));
+    return 0;
+}
+
+static bool start_thread(AsyncLogger* logger)
+{
+    logger->thread = CreateThread(nullptr, 0, logging_thread_main, logger, 0, nullptr);
+    return logger->thread != nullptr;
+}
+
+static void join_thread(AsyncLogger* logger)
+{
+    WaitForSingleObject(logger->thread, INFINITE);
+    CloseHandle(logger->thread);
+}
+
+#elif defined(ASL_OS_LINUX)
+
+static void* logging_thread_main(void* user)
+{
+    run_logging_thread(static_cast<AsyncLogger*>(user));
+    return nullptr;
+}
+
+static bool start_thread(AsyncLogger* logger)
+{
+    return pthread_create(&logger->thread, nullptr, logging_thread_main, logger) == 0;
+}
+
+static void join_thread(AsyncLogger* logger)
+{
+    pthread_join(logger->thread, nullptr);
+}
+
+#endif
+
+static void destroy_async_logger(AsyncLogger* logger)
+{
+    const auto capacity = static_cast<isize_t>(logger->mask + 1);
+
+    asl::DefaultAllocator allocator{};
+    allocator.dealloc(logger->records, asl::layout::array<AsyncLogger::record>(capacity));
+    allocator.dealloc(logger, asl::layout::of<AsyncLogger>());
+}
+
+static AsyncLogger* create_async_logger(const asl::log::async_options& options)
+{
+    asl::DefaultAllocator allocator{};
+
+    auto* records = static_cast<AsyncLogger::record*>(
+        allocator.alloc(asl::layout::array<AsyncLogger::record>(options.capacity)));
+    for (isize_t i = 0; i < options.capacity; ++i)
+    {
+        auto* r = new (records + i) AsyncLogger::record; // NOLINT(*-pointer-arithmetic)
+        asl::atomic_store(&r->sequence, static_cast<uint64_t>(i));
+    }
+
+    return new (allocator.alloc(asl::layout::of<AsyncLogger>())) AsyncLogger{
+        .records = records,
+        .mask = static_cast<uint64_t>(options.capacity - 1),
+        .overflow = options.overflow,
+        .thread = {},
+        .write_position = {},
+        .read_position = 0,
+        .flushed_position = {},
+        .flush_request = {},
+        .stopping = {},
+        .has_space = {},
+        .has_flushed = {},
+    };
+}
+
+// Drains the queue, then joins the logging thread and destroys the logger.
+static void stop_async_logger(AsyncLogger* logger)
+{
+    asl::atomic_store(&logger->stopping, true, asl::memory_order::release);
+    g_has_records.notify_all();
+    join_thread(logger);
+
+    destroy_async_logger(logger);
+}
+
+asl::status asl::log::start_async_logging(const async_options& options)
+{
+    if (!is_pow2(options.capacity))
+    {
+        return invalid_argument_error("Async logging capacity must be a power of two");
+    }
+
+    if (atomic_load(&g_async_logger, memory_order::seq_cst) != nullptr)
+    {
+        return runtime_error("Async logging is already started");
+    }
+
+    AsyncLogger* logger = create_async_logger(options);
+    if (!start_thread(logger))
+    {
+        destroy_async_logger(logger);
+        return runtime_error("Couldn't start the logging thread");
+    }
+
+    // Another thread might have started async logging in the meantime, in
+    // which case no one could have used ours yet.
+    AsyncLogger* expected = nullptr;
+    if (!atomic_compare_exchange(
+        &g_async_logger, &expected, logger,
+        memory_order::seq_cst, memory_order::seq_cst))
+    {
+        stop_async_logger(logger);
+        return runtime_error("Async logging is already started");
+    }
+
+    return ok();
+}
+
+void asl::log::stop_async_logging()
+{
+    ASL_ASSERT(!t_is_logging_thread);
+
+    AsyncLogger* logger = atomic_exchange(&g_async_logger, static_cast<AsyncLogger*>(nullptr), memory_order::seq_cst);
+    if (logger == nullptr) { return; }
+
+    // Logging calls blocked on a full queue are let through by the logging
+    // thread, which is still running.
+    while (atomic_load(&g_async_users, memory_order::seq_cst) > 0)
+    {
+        asl::yield_thread();
+    }
+
+    stop_async_logger(logger);
+}
+
+// Returns the async logger if running, in which case release_async_logger
+// must be called once done with it.
+static AsyncLogger* acquire_async_logger()
+{
+    if (t_is_logging_thread || asl::atomic_load(&g_async_logger, asl::memory_order::relaxed) == nullptr)
+    {
+        return nullptr;
+    }
+
+    asl::atomic_fetch_increment(&g_async_users, asl::memory_order::seq_cst);
+    AsyncLogger* logger = asl::atomic_load(&g_async_logger, asl::memory_order::seq_cst);
+    if (logger == nullptr)
+    {
+        asl::atomic_fetch_decrement(&g_async_users, asl::memory_order::seq_cst);
+    }
+
+    return logger;
+}
+
+static void release_async_logger()
+{
+    asl::atomic_fetch_decrement(&g_async_users, asl::memory_order::seq_cst);
+}
+
+void asl::log::flush()
+{
+    AsyncLogger* logger = acquire_async_logger();
+    if (logger == nullptr)
+    {
+        flush_loggers();
+        return;
+    }
+
+    const uint64_t target = atomic_load(&logger->write_position, memory_order::seq_cst);
+
+    uint64_t request = atomic_load(&logger->flush_request, memory_order::relaxed);
+    while (request < target
+        && !atomic_compare_exchange(&logger->flush_request, &request, target, memory_order::release))
+    {}
+    g_has_records.notify_all();
+
+    while (atomic_load(&logger->flushed_position, memory_order::acquire) < target)
+    {
+        const uint32_t epoch = logger->has_flushed.prepare_wait();
+        if (atomic_load(&logger->flushed_position, memory_order::acquire) >= target)
+        {
+            logger->has_flushed.cancel_wait();
+        }
+        else
+        {
+            logger->has_flushed.wait(epoch);
+        }
+    }
+
+    release_async_logger();
+}
+
+uint64_t asl::log::dropped_message_count()
+{
+    return atomic_load(&g_dropped_messages, memory_order::relaxed);
+}
+
+void asl::log::log_internals::RecordWriter::write(span<const std::byte> s)
+{
+    const isize_t size = min(s.size(), kMaxAsyncMessageSize - m_size);
+    asl::memcpy(m_data + m_size, s.data(), size); // NOLINT(*-pointer-arithmetic)
+    m_size += size;
+    m_truncated = m_truncated || size < s.size();
+}
+
+asl::log::log_internals::claim asl::log::log_internals::claim_record(
+    level l, const source_location& sl, RecordWriter* writer)
+{
+    AsyncLogger* logger = acquire_async_logger();
+    if (logger == nullptr) { return claim::kSynchronous; }
+
+    record* r = try_claim(logger);
+    while (r == nullptr && logger->overflow == overflow_policy::kBlock)
+    {
+        const uint32_t epoch = logger->has_space.prepare_wait();
+        r = try_claim(logger);
+        if (r == nullptr)
+        {
+            logger->has_space.wait(epoch);
+        }
+        else
+        {
+            logger->has_space.cancel_wait();
+        }
+    }
+
+    if (r == nullptr)
+    {
+        atomic_fetch_increment(&g_dropped_messages, memory_order::relaxed);
+        release_async_logger();
+        return claim::kDropped;
+    }
+
+    r->level = l;
+    r->location = sl;
+    writer->reset(r, r->text);
+    return claim::kClaimed;
+}
+
+void asl::log::log_internals::publish_record(RecordWriter* writer)
+{
+    record* r = writer->get_record();
+    r->size = writer->size();
+
+    if (writer->is_truncated())
+    {
+        asl::memcpy(r->text + r->size - 3, "...", 3); // NOLINT(*-pointer-arithmetic)
+    }
+
+    // The sequence is the record's position while it's claimed.
+    const uint64_t position = atomic_load(&r->sequence, memory_order::relaxed);
+    atomic_store(&r->sequence, position + 1, memory_order::release);
+
+    g_has_records.notify_all();
+    release_async_logger();
+}
+
+void asl::log::log_inner(level l, string_view msg, const source_location& sl)
+{
+    log_internals::RecordWriter writer{};
+    const auto claim = log_internals::claim_record(l, sl, &writer);
+
+    if (claim == log_internals::claim::kClaimed)
+    {
+        writer.write(as_bytes(msg.as_span()));
+        log_internals::publish_record(&writer);
+    }
+    else if (claim == log_internals::claim::kSynchronous)
+    {
+        log_internals::dispatch(l, msg, sl);
+    }
+}
@@ -6,7 +6,8 @@
 
 #include "asl/base/meta.hpp"
 #include "asl/formatting/format.hpp"
-#include "asl/containers/intrusive_list.hpp"
+#include "asl/strings/string_builder.hpp"
+#include "asl/types/status.hpp"
 
 namespace asl::log
 {
@@ -26,7 +27,7 @@ struct message
     source_location location;
 };
 
-class Logger : public intrusive_list_node<Logger>
+class Logger
 {
 public:
     Logger() = default;
@@ -34,6 +35,9 @@ public:
     virtual ~Logger() = default;
 
     virtual void log(const message&) = 0;
+
+    // Loggers buffering their output write it out here.
+    virtual void flush() {}
 };
 
 class DefaultLoggerBase : public Logger
@@ -58,30 +62,131 @@ public:
     {
         log_inner(deref<Writer>(m_writer), m);
     }
+
+    void flush() override
+    {
+        deref<Writer>(m_writer).flush();
+    }
 };
 
+// Registration is safe while other threads are logging. Once
+// unregister_logger returns, the logger isn't used anymore. Neither may be
+// called from a logger.
 void register_logger(Logger*);
 void unregister_logger(Logger*);
 
 void remove_default_logger();
 
+// Registers the default logger again if it was removed.
+void restore_default_logger();
+
 // @Todo Add a way to remove loggers (including all)
 
-void log_inner(level l, string_view fmt, span<const format_internals::type_erased_arg> args, const source_location& sl);
+enum class overflow_policy : uint8_t
+{
+    // Messages logged while the queue is full are dropped and counted.
+    kDrop,
+    // Logging waits for the logging thread to make room in the queue.
+    kBlock,
+};
+
+struct async_options
+{
+    // Number of messages the queue holds, must be a power of two.
+    isize_t         capacity = 1024;
+    overflow_policy overflow = overflow_policy::kDrop;
+};
+
+// Messages logged asynchronously are truncated to this size.
+inline constexpr isize_t kMaxAsyncMessageSize = 472;
+
+// Starts a thread passing messages to the loggers. Logging calls then only
+// format their message into a bounded queue, and never wait on the loggers'
+// I/O unless the queue is full with overflow_policy::kBlock.
+// Loggers are called from that thread until stop_async_logging.
+status start_async_logging(const async_options& options = {});
+
+// Passes the remaining queued messages to the loggers, flushes them, and
+// stops the logging thread. Messages are logged synchronously again after.
+void stop_async_logging();
+
+// Returns once every message logged before the call has been passed to the
+// loggers, and the loggers have been flushed.
+void flush();
+
+// Total number of messages dropped because the queue was full.
+uint64_t dropped_message_count();
+
+void log_inner(level l, string_view message, const source_location& sl);
+
+namespace log_internals
+{
+
+struct record;
+
+enum class claim : uint8_t
+{
+    kSynchronous,
+    kClaimed,
+    kDropped,
+};
+
+// Formats a message straight into a record of the async queue, cutting it
+// at kMaxAsyncMessageSize.
+class RecordWriter : public Writer
+{
+    record* m_record{};
+    char*   m_data{};
+    isize_t m_size{};
+    bool    m_truncated{};
+
+public:
+    RecordWriter() = default;
+    ASL_DELETE_COPY_MOVE(RecordWriter);
+    ~RecordWriter() override = default;
+
+    void reset(record* r, char* data)
+    {
+        m_record = r;
+        m_data = data;
+        m_size = 0;
+        m_truncated = false;
+    }
+
+    void write(span<const std::byte>) override;
+
+    [[nodiscard]] record* get_record() const { return m_record; }
+    [[nodiscard]] isize_t size() const { return m_size; }
+    [[nodiscard]] bool is_truncated() const { return m_truncated; }
+};
+
+// Claims a record when logging asynchronously. The message is then
+// formatted into the writer, and the record published.
+claim claim_record(level l, const source_location& sl, RecordWriter* writer);
+void publish_record(RecordWriter* writer);
+
+// Passes a message to the loggers on the calling thread.
+void dispatch(level l, string_view message, const source_location& sl);
+
+} // namespace log_internals
 
 template<formattable... Args>
-void log(level l, const source_location& sl, string_view fmt, const Args&... args)
+void log(level l, const source_location& sl, format_string<type_identity_t<Args>...> fmt, const Args&... args)
 {
-    if constexpr (sizeof...(Args) == 0)
+    log_internals::RecordWriter record_writer{};
+    const auto claim = log_internals::claim_record(l, sl, &record_writer);
+
+    if (claim == log_internals::claim::kClaimed)
     {
-        log_inner(l, fmt, {}, sl);
+        format(&record_writer, fmt, args...);
+        log_internals::publish_record(&record_writer);
     }
-    else
+    else if (claim == log_internals::claim::kSynchronous)
     {
-        const format_internals::type_erased_arg type_erased_args[] = {
-            format_internals::type_erased_arg(args)...
-        };
-        log_inner(l, fmt, type_erased_args, sl);
+        // @Todo Use temporary allocator
+        StringWriter msg_writer{};
+        format(&msg_writer, fmt, args...);
+        log_internals::dispatch(l, msg_writer.as_string_view(), sl);
     }
 }
 
@@ -6,7 +6,9 @@
 #include "asl/logging/logging.hpp"
 #include "asl/strings/string_builder.hpp"
 #include "asl/strings/string_view.hpp"
+#include "asl/synchronization/atomic.hpp"
 #include "asl/testing/testing.hpp"
+#include "asl/tests/threads.hpp"
 
 ASL_TEST(log)
 {
@@ -28,6 +30,290 @@ ASL_TEST(custom_writer)
     ASL_LOG_INFO("Hello");
     auto sv = string_writer.as_string_view();
 
-    ASL_TEST_EXPECT(sv == "[  INFO   ] src/asl/logging/logging_tests.cpp:28: Hello\n");
+    ASL_TEST_EXPECT(sv == "[  INFO   ] src/asl/logging/logging_tests.cpp:29: Hello\n");
 }
 
+static isize_t count_lines(asl::string_view sv)
+{
+    isize_t count = 0;
+    for (isize_t i = 0; i < sv.size(); ++i)
+    {
+        if (sv[i] == '\n') { count += 1; }
+    }
+    return count;
+}
+
+ASL_TEST(async)
+{
+    asl::StringWriter string_writer{};
+    asl::log::DefaultLogger<asl::StringWriter<>&> logger(string_writer);
+
+    asl::log::register_logger(&logger);
+    ASL_DEFER [&logger]() {
+        asl::log::unregister_logger(&logger);
+    };
+
+    ASL_TEST_ASSERT(asl::log::start_async_logging({
+        .capacity = 16,
+        .overflow = asl::log::overflow_policy::kBlock,
+    }).ok());
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ASL_LOG_INFO("Message {}", i);
+    }
+
+    asl::log::flush();
+    ASL_TEST_EXPECT(count_lines(string_writer.as_string_view()) == 100);
+
+    asl::log::stop_async_logging();
+}
+
+ASL_TEST(async_invalid_capacity)
+{
+    ASL_TEST_EXPECT(!asl::log::start_async_logging({
+        .capacity = 12,
+        .overflow = asl::log::overflow_policy::kDrop,
+    }).ok());
+}
+
+ASL_TEST(async_truncate)
+{
+    asl::StringWriter string_writer{};
+    asl::log::DefaultLogger<asl::StringWriter<>&> logger(string_writer);
+
+    asl::log::register_logger(&logger);
+    ASL_DEFER [&logger]() {
+        asl::log::unregister_logger(&logger);
+    };
+
+    ASL_TEST_ASSERT(asl::log::start_async_logging().ok());
+
+    char long_message[600];
+    for (char& c: long_message) { c = 'a'; }
+    ASL_LOG_INFO("{}", asl::string_view{long_message, 600});
+
+    asl::log::stop_async_logging();
+
+    const asl::string_view sv = string_writer.as_string_view();
+    ASL_TEST_EXPECT(sv.last(7) == "aaa...\n");
+    ASL_TEST_EXPECT(sv.size() < 600);
+}
+
+class BlockingLogger : public asl::log::Logger
+{
+public:
+    asl::atomic<bool>    is_entered{};
+    asl::atomic<bool>    is_released{};
+    asl::atomic<isize_t> count{};
+
+    void log(const asl::log::message&) override
+    {
+        asl::atomic_fetch_increment(&count, asl::memory_order::relaxed);
+        asl::atomic_store(&is_entered, true, asl::memory_order::release);
+        while (!asl::atomic_load(&is_released, asl::memory_order::acquire)) {}
+    }
+};
+
+ASL_TEST(async_drop)
+{
+    BlockingLogger logger{};
+
+    asl::log::remove_default_logger();
+    ASL_DEFER []() {
+        asl::log::restore_default_logger();
+    };
+
+    asl::log::register_logger(&logger);
+    ASL_DEFER [&logger]() {
+        asl::log::unregister_logger(&logger);
+    };
+
+    ASL_TEST_ASSERT(asl::log::start_async_logging({
+        .capacity = 8,
+        .overflow = asl::log::overflow_policy::kDrop,
+    }).ok());
+
+    const uint64_t dropped = asl::log::dropped_message_count();
+
+    // The logging thread is stuck on the first message, which still holds
+    // its record, so only 7 of the next 10 fit.
+    ASL_LOG_INFO("First");
+    while (!asl::atomic_load(&logger.is_entered, asl::memory_order::acquire)) {}
+
+    for (int i = 0; i < 10; ++i)
+    {
+        ASL_LOG_INFO("Message {}", i);
+    }
+
+    ASL_TEST_EXPECT(asl::log::dropped_message_count() - dropped == 3);
+
+    asl::atomic_store(&logger.is_released, true, asl::memory_order::release);
+    asl::log::stop_async_logging();
+
+    // Including the warning about dropped messages.
+    ASL_TEST_EXPECT(asl::atomic_load(&logger.count) == 9);
+}
+
+class CountingLogger : public asl::log::Logger
+{
+public:
+    asl::atomic<isize_t> count{};
+
+    void log(const asl::log::message&) override
+    {
+        asl::atomic_fetch_increment(&count, asl::memory_order::relaxed);
+    }
+};
+
+static constexpr int kMessagesPerThread = 1000;
+
+static void log_messages(int index, void*)
+{
+    for (int i = 0; i < kMessagesPerThread; ++i)
+    {
+        ASL_LOG_INFO("Thread {} message {}", index, i);
+    }
+}
+
+ASL_TEST(async_block_many_producers)
+{
+    CountingLogger logger{};
+
+    asl::log::remove_default_logger();
+    ASL_DEFER []() {
+        asl::log::restore_default_logger();
+    };
+
+    asl::log::register_logger(&logger);
+    ASL_DEFER [&logger]() {
+        asl::log::unregister_logger(&logger);
+    };
+
+    // Much smaller than what's logged, so producers keep waiting for room.
+    ASL_TEST_ASSERT(asl::log::start_async_logging({
+        .capacity = 8,
+        .overflow = asl::log::overflow_policy::kBlock,
+    }).ok());
+
+    const uint64_t dropped = asl::log::dropped_message_count();
+
+    run_threads(log_messages, nullptr);
+
+    asl::log::stop_async_logging();
+
+    ASL_TEST_EXPECT(asl::atomic_load(&logger.count) == kThreadCount * kMessagesPerThread);
+    ASL_TEST_EXPECT(asl::log::dropped_message_count() == dropped);
+}
+
+static void start_async(int, void* user)
+{
+    if (asl::log::start_async_logging().ok())
+    {
+        asl::atomic_fetch_increment(static_cast<asl::atomic<int>*>(user));
+    }
+}
+
+ASL_TEST(async_concurrent_start)
+{
+    CountingLogger logger{};
+
+    asl::log::remove_default_logger();
+    ASL_DEFER []() {
+        asl::log::restore_default_logger();
+    };
+
+    asl::log::register_logger(&logger);
+    ASL_DEFER [&logger]() {
+        asl::log::unregister_logger(&logger);
+    };
+
+    asl::atomic<int> started{};
+    run_threads(start_async, &started);
+    ASL_TEST_EXPECT(asl::atomic_load(&started) == 1);
+
+    ASL_LOG_INFO("Hello");
+    asl::log::stop_async_logging();
+    ASL_TEST_EXPECT(asl::atomic_load(&logger.count) == 1);
+
+    // It can be started again once stopped.
+    ASL_TEST_EXPECT(asl::log::start_async_logging().ok());
+    asl::log::stop_async_logging();
+}
+
+static constexpr int kChurnLoggers = 16;
+
+struct RegistryState
+{
+    CountingLogger   always;
+    CountingLogger   churn[kChurnLoggers];
+    isize_t          count_when_removed[kChurnLoggers]{};
+    asl::atomic<int> logging_threads_done{};
+    ThreadErrors     errors;
+};
+
+// Thread 0 keeps registering and removing loggers while the others log.
+static void register_or_log(int index, void* user)
+{
+    auto* state = static_cast<RegistryState*>(user);
+
+    if (index > 0)
+    {
+        for (int i = 0; i < kMessagesPerThread; ++i)
+        {
+            ASL_LOG_INFO("Thread {} message {}", index, i);
+        }
+        asl::atomic_fetch_increment(&state->logging_threads_done, asl::memory_order::release);
+        return;
+    }
+
+    // NOLINTBEGIN(*-constant-array-index)
+    int i = 0;
+    do
+    {
+        CountingLogger* logger = &state->churn[i];
+
+        // Nothing reached the logger since it was removed.
+        state->errors.expect(asl::atomic_load(&logger->count) == state->count_when_removed[i]);
+
+        asl::log::register_logger(logger);
+        asl::log::unregister_logger(logger);
+        state->count_when_removed[i] = asl::atomic_load(&logger->count);
+
+        i = (i + 1) % kChurnLoggers;
+    }
+    while (asl::atomic_load(&state->logging_threads_done, asl::memory_order::acquire) < kThreadCount - 1);
+    // NOLINTEND(*-constant-array-index)
+}
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(register_while_logging)
+{
+    RegistryState state{};
+
+    asl::log::remove_default_logger();
+    ASL_DEFER []() {
+        asl::log::restore_default_logger();
+    };
+
+    asl::log::register_logger(&state.always);
+    ASL_DEFER [&state]() {
+        asl::log::unregister_logger(&state.always);
+    };
+
+    run_threads(register_or_log, &state);
+
+    ASL_TEST_EXPECT(state.errors.count() == 0);
+
+    // Replacing the snapshot never hides the loggers that stay registered.
+    ASL_TEST_EXPECT(asl::atomic_load(&state.always.count) == (kThreadCount - 1) * kMessagesPerThread);
+
+    isize_t churn_total = 0;
+    for (int i = 0; i < kChurnLoggers; ++i)
+    {
+        // NOLINTNEXTLINE(*-constant-array-index)
+        ASL_TEST_EXPECT(asl::atomic_load(&state.churn[i].count) == state.count_when_removed[i]);
+        churn_total += state.count_when_removed[i]; // NOLINT(*-constant-array-index)
+    }
+    ASL_TEST_EXPECT(churn_total <= (kThreadCount - 1) * kMessagesPerThread);
+}
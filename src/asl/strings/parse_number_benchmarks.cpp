@@ -0,0 +1,75 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/strings/parse_number.hpp"
+#include "asl/benchmarking/benchmarking.hpp"
+
+static constexpr asl::string_view kFloats[] = {
+    "0",
+    "1.5",
+    "3.14159265358979",
+    "-0.000123",
+    "6.02214076e23",
+    "1e-300",
+    "123456.789",
+    "1.7976931348623157e308",
+};
+
+// Within float32 range.
+static constexpr asl::string_view kFloats32[] = {
+    "0",
+    "1.5",
+    "3.1415927",
+    "-0.000123",
+    "6.0221408e23",
+    "1e-30",
+    "123456.79",
+    "3.4028235e38",
+};
+
+static constexpr asl::string_view kIntegers[] = {
+    "0",
+    "42",
+    "-1234",
+    "99999",
+    "1234567",
+    "-2147483648",
+    "123456789012345",
+    "9223372036854775807",
+};
+
+static constexpr isize_t kValueCount = 8;
+
+ASL_BENCHMARK(parse_float64)
+{
+    isize_t i = 0;
+    while (state.keep_running())
+    {
+        auto res = asl::parse_float64(kFloats[i]); // NOLINT(*-constant-array-index)
+        asl::benchmarking::do_not_optimize(res.value().value);
+        i = (i + 1) % kValueCount;
+    }
+}
+
+ASL_BENCHMARK(parse_float32)
+{
+    isize_t i = 0;
+    while (state.keep_running())
+    {
+        auto res = asl::parse_float32(kFloats32[i]); // NOLINT(*-constant-array-index)
+        asl::benchmarking::do_not_optimize(res.value().value);
+        i = (i + 1) % kValueCount;
+    }
+}
+
+ASL_BENCHMARK(parse_int64)
+{
+    isize_t i = 0;
+    while (state.keep_running())
+    {
+        auto res = asl::parse_int64(kIntegers[i]); // NOLINT(*-constant-array-index)
+        asl::benchmarking::do_not_optimize(res.value().value);
+        i = (i + 1) % kValueCount;
+    }
+}
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "asl/containers/buffer.hpp"
+#include "asl/hashing/hash.hpp"
 #include "asl/strings/string_view.hpp"
 
 namespace asl
@@ -76,4 +77,12 @@ public:
 
 string() -> string<>;
 
+// Strings are looked up by string_view in hashed containers, and the
+// other way around, without allocating.
+template<allocator Allocator> struct is_transparent_key<string<Allocator>, string_view> : true_type {};
+template<allocator Allocator> struct is_transparent_key<string_view, string<Allocator>> : true_type {};
+
+template<allocator Allocator>
+struct trivially_relocatable<string<Allocator>> : trivially_relocatable<buffer<char, Allocator>> {};
+
 } // namespace asl
@@ -128,8 +128,8 @@ public:
 
 StringWriter() -> StringWriter<>;
 
-template<allocator Allocator = DefaultAllocator>
-string<Allocator> format_to_string(string_view fmt, const formattable auto&... args)
+template<allocator Allocator = DefaultAllocator, formattable... Args>
+string<Allocator> format_to_string(format_string<type_identity_t<Args>...> fmt, const Args&... args)
     requires is_default_constructible<Allocator>
 {
     StringWriter writer{};
@@ -137,8 +137,8 @@ string<Allocator> format_to_string(string_view fmt, const formattable auto&... a
     return std::move(writer).finish();
 }
 
-template<allocator Allocator = DefaultAllocator>
-string<Allocator> format_to_string(Allocator allocator, string_view fmt, const formattable auto&... args)
+template<allocator Allocator = DefaultAllocator, formattable... Args>
+string<Allocator> format_to_string(Allocator allocator, format_string<type_identity_t<Args>...> fmt, const Args&... args)
 {
     StringWriter writer{std::move(allocator)};
     format(&writer, fmt, args...);
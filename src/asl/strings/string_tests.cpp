@@ -6,6 +6,8 @@
 #include "asl/testing/testing.hpp"
 #include "asl/formatting/format.hpp"
 
+static_assert(asl::is_trivially_relocatable<asl::string<>>);
+
 ASL_TEST(default)
 {
     const asl::string s;
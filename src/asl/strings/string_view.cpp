@@ -0,0 +1,283 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/strings/string_view.hpp"
+
+#if defined(ASL_ARCH_X64)
+    #include <immintrin.h>
+#endif
+
+// NOLINTBEGIN(*-pointer-arithmetic)
+
+namespace
+{
+
+#if defined(ASL_ARCH_X64) && defined(__AVX2__)
+
+// 32 bytes at once when building for AVX2.
+class Block
+{
+    __m256i m_bytes;
+
+public:
+    static constexpr isize_t kWidth = 32;
+
+    // Byte i is represented by bit (i << kShift) of the masks.
+    static constexpr int kShift = 0;
+    using Mask = uint32_t;
+
+    explicit Block(const char* data)
+        // NOLINTNEXTLINE(*-reinterpret-cast)
+        : m_bytes{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data))}
+    {}
+
+    [[nodiscard]] Mask match(char c) const
+    {
+        const __m256i cmp = _mm256_cmpeq_epi8(_mm256_set1_epi8(c), m_bytes);
+        return static_cast<uint32_t>(_mm256_movemask_epi8(cmp));
+    }
+};
+
+#elif defined(ASL_ARCH_X64)
+
+// 16 bytes at once with SSE2, which is always available on x64.
+class Block
+{
+    __m128i m_bytes;
+
+public:
+    static constexpr isize_t kWidth = 16;
+
+    // Byte i is represented by bit (i << kShift) of the masks.
+    static constexpr int kShift = 0;
+    using Mask = uint32_t;
+
+    explicit Block(const char* data)
+        // NOLINTNEXTLINE(*-reinterpret-cast)
+        : m_bytes{_mm_loadu_si128(reinterpret_cast<const __m128i*>(data))}
+    {}
+
+    [[nodiscard]] Mask match(char c) const
+    {
+        const __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(c), m_bytes);
+        return static_cast<uint32_t>(_mm_movemask_epi8(cmp));
+    }
+};
+
+#else
+
+// Portable fallback: 8 bytes at once in a 64 bits integer, with the result
+// of each match in the high bit of the corresponding byte. Bytes are loaded
+// little-endian, so that the first one is the lowest.
+class Block
+{
+    static constexpr uint64_t kLsbs = 0x0101'0101'0101'0101ULL;
+    static constexpr uint64_t kMsbs = 0x8080'8080'8080'8080ULL;
+
+    uint64_t m_bytes{};
+
+public:
+    static constexpr isize_t kWidth = 8;
+
+    // Byte i is represented by bit (i << kShift) | 7 of the masks.
+    static constexpr int kShift = 3;
+    using Mask = uint64_t;
+
+    explicit Block(const char* data)
+    {
+        asl::memcpy(&m_bytes, data, sizeof(m_bytes));
+    }
+
+    [[nodiscard]] Mask match(char c) const
+    {
+        // See hash_set's Group, bytes equal to c become zero, and are then
+        // detected without carries crossing byte boundaries.
+        const uint64_t x = m_bytes ^ (kLsbs * static_cast<uint8_t>(c));
+        return ~(((x & ~kMsbs) + ~kMsbs) | x) & kMsbs;
+    }
+};
+
+#endif
+
+}  // namespace
+
+static isize_t lowest(Block::Mask mask)
+{
+    return static_cast<isize_t>(__builtin_ctzll(mask)) >> Block::kShift;
+}
+
+static isize_t highest(Block::Mask mask)
+{
+    return static_cast<isize_t>(63 - __builtin_clzll(mask)) >> Block::kShift;
+}
+
+static isize_t match_count(Block::Mask mask)
+{
+    return __builtin_popcountll(mask);
+}
+
+// Strings shorter than a block are handled one byte at a time. Otherwise
+// the bytes after the last full block are handled with one more block
+// overlapping the previous one, dropping the matches already seen.
+static Block::Mask drop_first(Block::Mask mask, isize_t count)
+{
+    return mask >> (count << Block::kShift);
+}
+
+static Block::Mask keep_first(Block::Mask mask, isize_t count)
+{
+    return mask & ((Block::Mask{1} << (count << Block::kShift)) - 1);
+}
+
+isize_t asl::string_view_internals::find_char(const char* data, isize_t size, char c)
+{
+    if (size < Block::kWidth)
+    {
+        return find_char_scalar(data, size, c);
+    }
+
+    isize_t i = 0;
+    for (; i + Block::kWidth <= size; i += Block::kWidth)
+    {
+        const Block::Mask mask = Block{data + i}.match(c);
+        if (mask != 0) { return i + lowest(mask); }
+    }
+
+    if (i < size)
+    {
+        const isize_t last = size - Block::kWidth;
+        const Block::Mask mask = drop_first(Block{data + last}.match(c), i - last);
+        if (mask != 0) { return i + lowest(mask); }
+    }
+
+    return -1;
+}
+
+isize_t asl::string_view_internals::rfind_char(const char* data, isize_t size, char c)
+{
+    if (size < Block::kWidth)
+    {
+        return rfind_char_scalar(data, size, c);
+    }
+
+    isize_t end = size;
+    for (; end >= Block::kWidth; end -= Block::kWidth)
+    {
+        const Block::Mask mask = Block{data + end - Block::kWidth}.match(c);
+        if (mask != 0) { return end - Block::kWidth + highest(mask); }
+    }
+
+    if (end > 0)
+    {
+        const Block::Mask mask = keep_first(Block{data}.match(c), end);
+        if (mask != 0) { return highest(mask); }
+    }
+
+    return -1;
+}
+
+isize_t asl::string_view_internals::count_char(const char* data, isize_t size, char c)
+{
+    if (size < Block::kWidth)
+    {
+        return count_char_scalar(data, size, c);
+    }
+
+    isize_t count = 0;
+    isize_t i = 0;
+    for (; i + Block::kWidth <= size; i += Block::kWidth)
+    {
+        count += match_count(Block{data + i}.match(c));
+    }
+
+    if (i < size)
+    {
+        const isize_t last = size - Block::kWidth;
+        count += match_count(drop_first(Block{data + last}.match(c), i - last));
+    }
+
+    return count;
+}
+
+// Beyond this, matching the whole set on each block costs more than
+// looking up every byte in a table.
+static constexpr isize_t kMaxBlockSetSize = 8;
+
+static Block::Mask match_any(const Block& block, const char* set, isize_t set_size)
+{
+    Block::Mask mask = 0;
+    for (isize_t i = 0; i < set_size; ++i)
+    {
+        mask |= block.match(set[i]);
+    }
+    return mask;
+}
+
+isize_t asl::string_view_internals::find_any_of(const char* data, isize_t size, const char* set, isize_t set_size)
+{
+    if (set_size == 1)
+    {
+        return find_char(data, size, set[0]);
+    }
+
+    if (set_size > kMaxBlockSetSize || size < Block::kWidth)
+    {
+        bool is_in_set[256]{};
+        for (isize_t i = 0; i < set_size; ++i)
+        {
+            is_in_set[static_cast<uint8_t>(set[i])] = true; // NOLINT(*-constant-array-index)
+        }
+
+        for (isize_t i = 0; i < size; ++i)
+        {
+            if (is_in_set[static_cast<uint8_t>(data[i])]) { return i; } // NOLINT(*-constant-array-index)
+        }
+        return -1;
+    }
+
+    isize_t i = 0;
+    for (; i + Block::kWidth <= size; i += Block::kWidth)
+    {
+        const Block::Mask mask = match_any(Block{data + i}, set, set_size);
+        if (mask != 0) { return i + lowest(mask); }
+    }
+
+    if (i < size)
+    {
+        const isize_t last = size - Block::kWidth;
+        const Block::Mask mask = drop_first(match_any(Block{data + last}, set, set_size), i - last);
+        if (mask != 0) { return i + lowest(mask); }
+    }
+
+    return -1;
+}
+
+isize_t asl::string_view_internals::find(const char* data, isize_t size, const char* needle, isize_t needle_size)
+{
+    if (needle_size == 0) { return 0; }
+    if (needle_size > size) { return -1; }
+    if (needle_size == 1) { return find_char(data, size, needle[0]); }
+
+    // Candidates are the positions where both the first and last characters
+    // of the needle match, which filters out most of them on real text.
+    const char first = needle[0];
+    const char last = needle[needle_size - 1];
+
+    isize_t i = 0;
+    for (; i + needle_size - 1 + Block::kWidth <= size; i += Block::kWidth)
+    {
+        Block::Mask mask = Block{data + i}.match(first) & Block{data + i + needle_size - 1}.match(last);
+        while (mask != 0)
+        {
+            const isize_t index = i + lowest(mask);
+            if (asl::memcmp(data + index + 1, needle + 1, needle_size - 2) == 0) { return index; }
+            mask &= mask - 1;
+        }
+    }
+
+    const isize_t tail = find_scalar(data + i, size - i, needle, needle_size);
+    return tail < 0 ? -1 : i + tail;
+}
+
+// NOLINTEND(*-pointer-arithmetic)
@@ -11,6 +11,70 @@
 namespace asl
 {
 
+template<typename Delimiter> class string_split;
+
+namespace string_view_internals
+{
+
+// Vectorized versions, for use at runtime. Not found is -1.
+isize_t find_char(const char* data, isize_t size, char c);
+isize_t rfind_char(const char* data, isize_t size, char c);
+isize_t count_char(const char* data, isize_t size, char c);
+isize_t find_any_of(const char* data, isize_t size, const char* set, isize_t set_size);
+isize_t find(const char* data, isize_t size, const char* needle, isize_t needle_size);
+
+// NOLINTBEGIN(*-pointer-arithmetic)
+
+constexpr isize_t find_char_scalar(const char* data, isize_t size, char c)
+{
+    for (isize_t i = 0; i < size; ++i)
+    {
+        if (data[i] == c) { return i; }
+    }
+    return -1;
+}
+
+constexpr isize_t rfind_char_scalar(const char* data, isize_t size, char c)
+{
+    for (isize_t i = size - 1; i >= 0; --i)
+    {
+        if (data[i] == c) { return i; }
+    }
+    return -1;
+}
+
+constexpr isize_t count_char_scalar(const char* data, isize_t size, char c)
+{
+    isize_t count = 0;
+    for (isize_t i = 0; i < size; ++i)
+    {
+        if (data[i] == c) { count += 1; }
+    }
+    return count;
+}
+
+constexpr isize_t find_any_of_scalar(const char* data, isize_t size, const char* set, isize_t set_size)
+{
+    for (isize_t i = 0; i < size; ++i)
+    {
+        if (find_char_scalar(set, set_size, data[i]) >= 0) { return i; }
+    }
+    return -1;
+}
+
+constexpr isize_t find_scalar(const char* data, isize_t size, const char* needle, isize_t needle_size)
+{
+    for (isize_t i = 0; i + needle_size <= size; ++i)
+    {
+        if (memcmp(data + i, needle, needle_size) == 0) { return i; }
+    }
+    return -1;
+}
+
+// NOLINTEND(*-pointer-arithmetic)
+
+} // namespace string_view_internals
+
 // NOLINTBEGIN(*-convert-member-functions-to-static)
 class string_view
 {
@@ -115,6 +179,89 @@ public:
         return self.substr(self.m_size - size);
     }
 
+    // Index of the first occurrence, or -1.
+    [[nodiscard]] constexpr isize_t find(this string_view self, char c)
+    {
+        if consteval
+        {
+            return string_view_internals::find_char_scalar(self.m_data, self.m_size, c);
+        }
+        return string_view_internals::find_char(self.m_data, self.m_size, c);
+    }
+
+    // Index of the first occurrence, or -1. An empty needle is found at 0.
+    [[nodiscard]] constexpr isize_t find(this string_view self, string_view needle)
+    {
+        if consteval
+        {
+            return string_view_internals::find_scalar(self.m_data, self.m_size, needle.m_data, needle.m_size);
+        }
+        return string_view_internals::find(self.m_data, self.m_size, needle.m_data, needle.m_size);
+    }
+
+    // Index of the last occurrence, or -1.
+    [[nodiscard]] constexpr isize_t rfind(this string_view self, char c)
+    {
+        if consteval
+        {
+            return string_view_internals::rfind_char_scalar(self.m_data, self.m_size, c);
+        }
+        return string_view_internals::rfind_char(self.m_data, self.m_size, c);
+    }
+
+    // Index of the last occurrence, or -1. An empty needle is found at size().
+    [[nodiscard]] constexpr isize_t rfind(this string_view self, string_view needle)
+    {
+        if (needle.m_size == 0) { return self.m_size; }
+
+        // Candidates are the occurrences of the first character.
+        isize_t end = self.m_size - needle.m_size + 1;
+        while (end > 0)
+        {
+            const isize_t index = self.first(end).rfind(needle[0]);
+            if (index < 0) { break; }
+            if (self.substr(index, needle.m_size) == needle) { return index; }
+            end = index;
+        }
+        return -1;
+    }
+
+    // Index of the first character which is in the set, or -1.
+    [[nodiscard]] constexpr isize_t find_any_of(this string_view self, string_view set)
+    {
+        if consteval
+        {
+            return string_view_internals::find_any_of_scalar(self.m_data, self.m_size, set.m_data, set.m_size);
+        }
+        return string_view_internals::find_any_of(self.m_data, self.m_size, set.m_data, set.m_size);
+    }
+
+    [[nodiscard]] constexpr isize_t count(this string_view self, char c)
+    {
+        if consteval
+        {
+            return string_view_internals::count_char_scalar(self.m_data, self.m_size, c);
+        }
+        return string_view_internals::count_char(self.m_data, self.m_size, c);
+    }
+
+    // Number of non-overlapping occurrences.
+    [[nodiscard]] constexpr isize_t count(this string_view self, string_view needle)
+    {
+        ASL_ASSERT(needle.m_size > 0);
+
+        isize_t occurrences = 0;
+        for (isize_t index = self.find(needle); index >= 0; index = self.find(needle))
+        {
+            occurrences += 1;
+            self = self.substr(index + needle.m_size);
+        }
+        return occurrences;
+    }
+
+    [[nodiscard]] constexpr string_split<char> split(this string_view self, char delimiter);
+    [[nodiscard]] constexpr string_split<string_view> split(this string_view self, string_view delimiter);
+
     constexpr bool operator==(this string_view self, string_view other)
     {
         if (self.m_size != other.m_size) { return false; }
@@ -129,6 +276,85 @@ public:
 };
 // NOLINTEND(*-convert-member-functions-to-static)
 
+// Pieces of a string_view between the occurrences of a delimiter, which
+// may be empty. Splitting an empty string_view gives a single empty piece.
+template<typename Delimiter>
+class string_split
+{
+    string_view m_rest;
+    string_view m_piece;
+    Delimiter   m_delimiter;
+    bool        m_is_last{};
+    bool        m_is_done{};
+
+    [[nodiscard]] constexpr isize_t delimiter_size() const
+    {
+        if constexpr (same_as<Delimiter, char>)
+        {
+            return 1;
+        }
+        else
+        {
+            return m_delimiter.size();
+        }
+    }
+
+    constexpr void advance()
+    {
+        if (m_is_last)
+        {
+            m_is_done = true;
+            return;
+        }
+
+        const isize_t index = m_rest.find(m_delimiter);
+        if (index < 0)
+        {
+            m_piece = m_rest;
+            m_is_last = true;
+        }
+        else
+        {
+            m_piece = m_rest.first(index);
+            m_rest = m_rest.substr(index + delimiter_size());
+        }
+    }
+
+public:
+    struct sentinel {};
+
+    constexpr string_split(string_view sv, Delimiter delimiter)
+        : m_rest{sv}
+        , m_delimiter{delimiter}
+    {
+        advance();
+    }
+
+    constexpr string_view operator*() const { return m_piece; }
+
+    constexpr string_split& operator++()
+    {
+        advance();
+        return *this;
+    }
+
+    constexpr bool operator==(sentinel) const { return m_is_done; }
+
+    [[nodiscard]] constexpr string_split begin() const { return *this; }
+    [[nodiscard]] constexpr sentinel end() const { return {}; }
+};
+
+constexpr string_split<char> string_view::split(this string_view self, char delimiter)
+{
+    return {self, delimiter};
+}
+
+constexpr string_split<string_view> string_view::split(this string_view self, string_view delimiter)
+{
+    ASL_ASSERT(!delimiter.is_empty());
+    return {self, delimiter};
+}
+
 } // namespace asl
 
 constexpr asl::string_view operator ""_sv(const char* s, size_t len)
@@ -0,0 +1,81 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/strings/string_view.hpp"
+#include "asl/benchmarking/benchmarking.hpp"
+
+static constexpr isize_t kTextSize = 64 * 1024;
+
+// CSV-like rows of short fields, with a rare marker at the very end.
+static asl::string_view make_text()
+{
+    static char s_text[kTextSize];
+
+    static constexpr asl::string_view kRow = "12345,alpha,beta gamma,0.25,delta\n";
+    for (isize_t i = 0; i < kTextSize; ++i)
+    {
+        s_text[i] = kRow[i % kRow.size()]; // NOLINT(*-constant-array-index)
+    }
+    s_text[kTextSize - 1] = '#';
+
+    return asl::string_view{s_text, kTextSize};
+}
+
+ASL_BENCHMARK(string_view_find_char)
+{
+    const asl::string_view text = make_text();
+
+    while (state.keep_running())
+    {
+        asl::benchmarking::do_not_optimize(text.find('#'));
+    }
+}
+
+ASL_BENCHMARK(string_view_count_char)
+{
+    const asl::string_view text = make_text();
+
+    while (state.keep_running())
+    {
+        asl::benchmarking::do_not_optimize(text.count('\n'));
+    }
+}
+
+ASL_BENCHMARK(string_view_find_substring)
+{
+    const asl::string_view text = make_text();
+
+    while (state.keep_running())
+    {
+        asl::benchmarking::do_not_optimize(text.find("gamma#"));
+    }
+}
+
+ASL_BENCHMARK(string_view_find_any_of)
+{
+    const asl::string_view text = make_text();
+
+    while (state.keep_running())
+    {
+        asl::benchmarking::do_not_optimize(text.find_any_of("#@!"));
+    }
+}
+
+ASL_BENCHMARK(string_view_split)
+{
+    const asl::string_view text = make_text();
+
+    while (state.keep_running())
+    {
+        isize_t fields = 0;
+        for (asl::string_view line: text.split('\n'))
+        {
+            for ([[maybe_unused]] asl::string_view field: line.split(','))
+            {
+                fields += 1;
+            }
+        }
+        asl::benchmarking::do_not_optimize(fields);
+    }
+}
@@ -119,3 +119,119 @@ ASL_TEST(equal)
     ASL_TEST_EXPECT("abc"_sv != "ab"_sv);
     ASL_TEST_EXPECT("abc"_sv != "abd"_sv);
 }
+
+static_assert("hello"_sv.find('l') == 2);
+static_assert("hello"_sv.rfind('l') == 3);
+static_assert("hello"_sv.find("lo") == 3);
+static_assert("hello"_sv.rfind("l") == 3);
+static_assert("hello"_sv.find_any_of("ol") == 2);
+static_assert("hello"_sv.count('l') == 2);
+static_assert("a,b,c"_sv.count(","_sv) == 2);
+
+static constexpr isize_t count_pieces(asl::string_view sv, char delimiter)
+{
+    isize_t count = 0;
+    for ([[maybe_unused]] asl::string_view piece: sv.split(delimiter)) { count += 1; }
+    return count;
+}
+
+static_assert(count_pieces("a,b,,c", ',') == 4);
+static_assert(count_pieces("", ',') == 1);
+
+ASL_TEST(find_char)
+{
+    ASL_TEST_EXPECT("abcabc"_sv.find('c') == 2);
+    ASL_TEST_EXPECT("abcabc"_sv.find('d') == -1);
+    ASL_TEST_EXPECT(""_sv.find('a') == -1);
+
+    // Every position and size around the vector widths.
+    char buffer[100];
+    for (isize_t size = 0; size <= 100; ++size)
+    {
+        for (isize_t pos = 0; pos < size; ++pos)
+        {
+            asl::memzero(buffer, 100);
+            buffer[pos] = 'x'; // NOLINT(*-constant-array-index)
+            const asl::string_view sv{buffer, size};
+
+            ASL_TEST_EXPECT(sv.find('x') == pos);
+            ASL_TEST_EXPECT(sv.rfind('x') == pos);
+            ASL_TEST_EXPECT(sv.count('x') == 1);
+            ASL_TEST_EXPECT(sv.find_any_of("xyz") == pos);
+        }
+
+        asl::memzero(buffer, 100);
+        ASL_TEST_EXPECT(asl::string_view(buffer, size).find('x') == -1);
+        ASL_TEST_EXPECT(asl::string_view(buffer, size).rfind('x') == -1);
+        ASL_TEST_EXPECT(asl::string_view(buffer, size).count('\0') == size);
+    }
+}
+
+ASL_TEST(rfind_char)
+{
+    ASL_TEST_EXPECT("abcabc"_sv.rfind('a') == 3);
+    ASL_TEST_EXPECT("abcabc"_sv.rfind('d') == -1);
+    ASL_TEST_EXPECT(""_sv.rfind('a') == -1);
+}
+
+ASL_TEST(find_any_of)
+{
+    ASL_TEST_EXPECT("key = value;"_sv.find_any_of("=;") == 4);
+    ASL_TEST_EXPECT("key = value;"_sv.find_any_of("") == -1);
+    ASL_TEST_EXPECT("key = value;"_sv.find_any_of("!@#$%^&*()[]{};") == 11);
+    ASL_TEST_EXPECT("the quick brown fox jumps over the lazy dog"_sv.find_any_of("xyz") == 18);
+}
+
+ASL_TEST(find_substring)
+{
+    const asl::string_view sv = "the quick brown fox jumps over the lazy dog";
+
+    ASL_TEST_EXPECT(sv.find("the") == 0);
+    ASL_TEST_EXPECT(sv.find("dog") == 40);
+    ASL_TEST_EXPECT(sv.find("lazy cat") == -1);
+    ASL_TEST_EXPECT(sv.find("") == 0);
+    ASL_TEST_EXPECT("ab"_sv.find("abc") == -1);
+    ASL_TEST_EXPECT("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab"_sv.find("aab") == 36);
+
+    ASL_TEST_EXPECT(sv.rfind("the") == 31);
+    ASL_TEST_EXPECT(sv.rfind("cat") == -1);
+    ASL_TEST_EXPECT(sv.rfind("") == sv.size());
+}
+
+ASL_TEST(count)
+{
+    ASL_TEST_EXPECT("a,b,,c"_sv.count(',') == 3);
+    ASL_TEST_EXPECT("aaaa"_sv.count("aa"_sv) == 2);
+    ASL_TEST_EXPECT("abc"_sv.count("d"_sv) == 0);
+}
+
+ASL_TEST(split)
+{
+    const asl::string_view expected[] = { "a", "b", "", "c" };
+
+    isize_t index = 0;
+    for (asl::string_view piece: "a,b,,c"_sv.split(','))
+    {
+        ASL_TEST_ASSERT(index < 4);
+        ASL_TEST_EXPECT(piece == expected[index]); // NOLINT(*-constant-array-index)
+        index += 1;
+    }
+    ASL_TEST_EXPECT(index == 4);
+
+    index = 0;
+    for (asl::string_view piece: "a::b::::c"_sv.split("::"))
+    {
+        ASL_TEST_ASSERT(index < 4);
+        ASL_TEST_EXPECT(piece == expected[index]); // NOLINT(*-constant-array-index)
+        index += 1;
+    }
+    ASL_TEST_EXPECT(index == 4);
+
+    index = 0;
+    for (asl::string_view piece: ","_sv.split(','))
+    {
+        ASL_TEST_EXPECT(piece.is_empty());
+        index += 1;
+    }
+    ASL_TEST_EXPECT(index == 2);
+}
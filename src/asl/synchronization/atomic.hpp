@@ -20,18 +20,21 @@ enum class memory_order : int // NOLINT(*-enum-size)
 
 template<typename T> struct atomic { T m_value{}; };
 
+template<typename T>
+concept atomic_scalar = is_integral<T> || is_ptr<T>;
+
 inline void atomic_fence(memory_order order)
 {
     __atomic_thread_fence(static_cast<int>(order));
 }
 
-template<is_integral T>
+template<atomic_scalar T>
 inline void atomic_store(atomic<T>* a, T value, memory_order order = memory_order::relaxed)
 {
     __atomic_store(&a->m_value, &value, static_cast<int>(order)); // NOLINT(*-vararg)
 }
 
-template<is_integral T>
+template<atomic_scalar T>
 inline T atomic_load(atomic<T>* a, memory_order order = memory_order::relaxed)
 {
     T value;
@@ -39,6 +42,28 @@ inline T atomic_load(atomic<T>* a, memory_order order = memory_order::relaxed)
     return value;
 }
 
+template<atomic_scalar T>
+inline T atomic_exchange(atomic<T>* a, T value, memory_order order = memory_order::relaxed)
+{
+    T previous;
+    __atomic_exchange(&a->m_value, &value, &previous, static_cast<int>(order)); // NOLINT(*-vararg)
+    return previous;
+}
+
+// On failure, expected is updated with the current value.
+template<atomic_scalar T>
+inline bool atomic_compare_exchange(
+    atomic<T>* a,
+    T* expected,
+    T desired,
+    memory_order success = memory_order::relaxed,
+    memory_order failure = memory_order::relaxed)
+{
+    return __atomic_compare_exchange( // NOLINT(*-vararg)
+        &a->m_value, expected, &desired, false,
+        static_cast<int>(success), static_cast<int>(failure));
+}
+
 template<typename T>
 inline T atomic_fetch_increment(atomic<T>* a, memory_order order = memory_order::relaxed)
 {
@@ -0,0 +1,121 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/synchronization/rw_lock.hpp"
+
+#include "asl/base/assert.hpp"
+#include "asl/synchronization/wait.hpp"
+
+static constexpr uint32_t kReaderMask    = 0x0fff'ffff;
+static constexpr uint32_t kWriter        = 0x1000'0000;
+static constexpr uint32_t kWriterWaiting = 0x2000'0000;
+static constexpr uint32_t kReaderWaiting = 0x4000'0000;
+
+static constexpr int kSpinCount = 64;
+
+void asl::RwLock::lock_shared()
+{
+    uint32_t state = atomic_load(&m_state);
+    for (int spin = 0;; ++spin)
+    {
+        if ((state & (kWriter | kWriterWaiting)) == 0)
+        {
+            ASL_ASSERT((state & kReaderMask) < kReaderMask);
+            if (atomic_compare_exchange(&m_state, &state, state + 1, memory_order::acquire)) { return; }
+            continue;
+        }
+
+        if (spin < kSpinCount)
+        {
+            cpu_pause();
+            state = atomic_load(&m_state);
+            continue;
+        }
+
+        if ((state & kReaderWaiting) == 0 &&
+            !atomic_compare_exchange(&m_state, &state, state | kReaderWaiting))
+        {
+            continue;
+        }
+
+        atomic_wait(&m_state, state | kReaderWaiting);
+        state = atomic_load(&m_state);
+    }
+}
+
+bool asl::RwLock::try_lock_shared()
+{
+    uint32_t state = atomic_load(&m_state);
+    while ((state & (kWriter | kWriterWaiting)) == 0)
+    {
+        ASL_ASSERT((state & kReaderMask) < kReaderMask);
+        if (atomic_compare_exchange(&m_state, &state, state + 1, memory_order::acquire)) { return true; }
+    }
+    return false;
+}
+
+void asl::RwLock::unlock_shared()
+{
+    const uint32_t previous = atomic_fetch_decrement(&m_state, memory_order::release);
+    ASL_ASSERT((previous & kReaderMask) > 0);
+
+    // Only writers wait while there are readers, and the last reader
+    // lets them in.
+    if ((previous & kReaderMask) == 1 && (previous & kWriterWaiting) != 0)
+    {
+        atomic_notify_all(&m_state);
+    }
+}
+
+void asl::RwLock::lock()
+{
+    uint32_t state = atomic_load(&m_state);
+    for (int spin = 0;; ++spin)
+    {
+        // The waiting flags are left as is, even when we were the only
+        // waiter. The worst that can happen is a spurious notify on unlock.
+        if ((state & (kReaderMask | kWriter)) == 0)
+        {
+            if (atomic_compare_exchange(&m_state, &state, state | kWriter, memory_order::acquire)) { return; }
+            continue;
+        }
+
+        if (spin < kSpinCount)
+        {
+            cpu_pause();
+            state = atomic_load(&m_state);
+            continue;
+        }
+
+        if ((state & kWriterWaiting) == 0 &&
+            !atomic_compare_exchange(&m_state, &state, state | kWriterWaiting))
+        {
+            continue;
+        }
+
+        atomic_wait(&m_state, state | kWriterWaiting);
+        state = atomic_load(&m_state);
+    }
+}
+
+bool asl::RwLock::try_lock()
+{
+    uint32_t state = atomic_load(&m_state);
+    while ((state & (kReaderMask | kWriter)) == 0)
+    {
+        if (atomic_compare_exchange(&m_state, &state, state | kWriter, memory_order::acquire)) { return true; }
+    }
+    return false;
+}
+
+void asl::RwLock::unlock()
+{
+    const uint32_t previous = atomic_exchange(&m_state, uint32_t{0}, memory_order::release);
+    ASL_ASSERT((previous & kWriter) != 0);
+
+    if ((previous & (kWriterWaiting | kReaderWaiting)) != 0)
+    {
+        atomic_notify_all(&m_state);
+    }
+}
@@ -0,0 +1,34 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "asl/base/integers.hpp"
+#include "asl/synchronization/atomic.hpp"
+
+namespace asl
+{
+
+// Reader/writer lock. Waiters spin for a bit, then sleep. Writers have
+// priority: once one is waiting, new readers wait until it's done, so
+// a steady flow of readers can't starve writers.
+class RwLock
+{
+    // Number of readers in the low bits, and flags in the high bits.
+    atomic<uint32_t> m_state{};
+
+public:
+    void lock_shared();
+    void unlock_shared();
+
+    void lock();
+    void unlock();
+
+    // Same as lock_shared and lock, but return false instead of waiting.
+    // try_lock_shared fails as soon as a writer is waiting.
+    [[nodiscard]] bool try_lock_shared();
+    [[nodiscard]] bool try_lock();
+};
+
+} // namespace asl
@@ -0,0 +1,186 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/synchronization/rw_lock.hpp"
+#include "asl/synchronization/atomic.hpp"
+#include "asl/synchronization/wait.hpp"
+#include "asl/testing/testing.hpp"
+#include "asl/tests/threads.hpp"
+
+// NOLINTNEXTLINE(*-complexity)
+ASL_TEST(try_lock)
+{
+    asl::RwLock lock;
+
+    ASL_TEST_ASSERT(lock.try_lock());
+    ASL_TEST_EXPECT(!lock.try_lock());
+    ASL_TEST_EXPECT(!lock.try_lock_shared());
+    lock.unlock();
+
+    // Readers share the lock, and keep writers out.
+    ASL_TEST_ASSERT(lock.try_lock_shared());
+    ASL_TEST_EXPECT(lock.try_lock_shared());
+    ASL_TEST_EXPECT(!lock.try_lock());
+    lock.unlock_shared();
+    ASL_TEST_EXPECT(!lock.try_lock());
+    lock.unlock_shared();
+
+    ASL_TEST_EXPECT(lock.try_lock());
+    lock.unlock();
+}
+
+struct SharedState
+{
+    asl::RwLock      lock;
+    asl::atomic<int> readers;
+    asl::atomic<int> writers;
+    ThreadErrors     errors;
+
+    // Only changed with the lock held exclusively, one after the other.
+    int64_t first;
+    int64_t second;
+};
+
+// Long enough for everyone to get there, unless they can't.
+static constexpr int kMaxWaitIterations = 1'000'000;
+
+static void read_together(int, void* user)
+{
+    auto* state = static_cast<SharedState*>(user);
+
+    state->lock.lock_shared();
+    asl::atomic_fetch_increment(&state->readers);
+
+    // Every thread must be able to hold the lock at the same time.
+    int i = 0;
+    while (asl::atomic_load(&state->readers) < kThreadCount && i < kMaxWaitIterations)
+    {
+        asl::yield_thread();
+        i += 1;
+    }
+    state->errors.expect(asl::atomic_load(&state->readers) == kThreadCount);
+
+    state->lock.unlock_shared();
+}
+
+ASL_TEST(shared_readers)
+{
+    SharedState state{};
+    run_threads(read_together, &state);
+    ASL_TEST_EXPECT(state.errors.count() == 0);
+}
+
+static constexpr int kIterations = 20000;
+
+static void read_and_write(int index, void* user)
+{
+    auto* state = static_cast<SharedState*>(user);
+
+    for (int i = 0; i < kIterations; ++i)
+    {
+        if ((i + index) % 8 == 0)
+        {
+            state->lock.lock();
+            state->errors.expect(asl::atomic_fetch_increment(&state->writers) == 0);
+            state->errors.expect(asl::atomic_load(&state->readers) == 0);
+
+            state->first += 1;
+            state->second += 1;
+
+            asl::atomic_fetch_decrement(&state->writers);
+            state->lock.unlock();
+        }
+        else
+        {
+            state->lock.lock_shared();
+            asl::atomic_fetch_increment(&state->readers);
+            state->errors.expect(asl::atomic_load(&state->writers) == 0);
+
+            // Never halfway through a write.
+            state->errors.expect(state->first == state->second);
+
+            asl::atomic_fetch_decrement(&state->readers);
+            state->lock.unlock_shared();
+        }
+    }
+}
+
+ASL_TEST(exclusion)
+{
+    SharedState state{};
+    run_threads(read_and_write, &state);
+
+    ASL_TEST_EXPECT(state.errors.count() == 0);
+    ASL_TEST_EXPECT(state.first == kThreadCount * kIterations / 8);
+    ASL_TEST_EXPECT(state.second == state.first);
+}
+
+// Thread roles, the other threads don't do anything.
+static constexpr int kFirstReaderThread = 0;
+static constexpr int kWriterThread      = 1;
+static constexpr int kLateReaderThread  = 2;
+
+struct PreferenceState
+{
+    asl::RwLock       lock;
+    asl::atomic<bool> first_reader_in;
+    asl::atomic<bool> writer_waiting;
+    asl::atomic<bool> writer_done;
+    ThreadErrors      errors;
+};
+
+// A reader holds the lock while a writer waits for it. New readers must
+// then wait for the writer, even though the lock is only held shared.
+static void reader_writer_reader(int index, void* user)
+{
+    auto* state = static_cast<PreferenceState*>(user);
+
+    if (index == kFirstReaderThread)
+    {
+        state->lock.lock_shared();
+        asl::atomic_store(&state->first_reader_in, true, asl::memory_order::release);
+
+        // No one else can hold the lock exclusively, so once new readers
+        // are turned away, it's because the writer is waiting.
+        while (state->lock.try_lock_shared())
+        {
+            state->lock.unlock_shared();
+            asl::yield_thread();
+        }
+        asl::atomic_store(&state->writer_waiting, true, asl::memory_order::release);
+
+        state->errors.expect(!asl::atomic_load(&state->writer_done, asl::memory_order::acquire));
+        state->lock.unlock_shared();
+    }
+    else if (index == kWriterThread)
+    {
+        while (!asl::atomic_load(&state->first_reader_in, asl::memory_order::acquire))
+        {
+            asl::yield_thread();
+        }
+
+        state->lock.lock();
+        asl::atomic_store(&state->writer_done, true, asl::memory_order::release);
+        state->lock.unlock();
+    }
+    else if (index == kLateReaderThread)
+    {
+        while (!asl::atomic_load(&state->writer_waiting, asl::memory_order::acquire))
+        {
+            asl::yield_thread();
+        }
+
+        state->lock.lock_shared();
+        state->errors.expect(asl::atomic_load(&state->writer_done, asl::memory_order::acquire));
+        state->lock.unlock_shared();
+    }
+}
+
+ASL_TEST(writer_preference)
+{
+    PreferenceState state{};
+    run_threads(reader_writer_reader, &state);
+    ASL_TEST_EXPECT(state.errors.count() == 0);
+    ASL_TEST_EXPECT(asl::atomic_load(&state.writer_done));
+}
@@ -0,0 +1,36 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "asl/synchronization/atomic.hpp"
+#include "asl/synchronization/wait.hpp"
+
+namespace asl
+{
+
+// For short critical sections, waiters spin instead of sleeping.
+class SpinLock
+{
+    atomic<bool> m_locked{};
+
+public:
+    void lock()
+    {
+        while (atomic_exchange(&m_locked, true, memory_order::acquire))
+        {
+            while (atomic_load(&m_locked, memory_order::relaxed))
+            {
+                cpu_pause();
+            }
+        }
+    }
+
+    void unlock()
+    {
+        atomic_store(&m_locked, false, memory_order::release);
+    }
+};
+
+} // namespace asl
@@ -0,0 +1,64 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asl/synchronization/wait.hpp"
+
+#if defined(ASL_OS_WINDOWS)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+
+    #pragma comment(lib, "Synchronization.lib")
+#elif defined(ASL_OS_LINUX)
+    #include <limits.h>
+    #include <sched.h>
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+#if defined(ASL_OS_LINUX)
+
+static void futex_wake(asl::atomic<uint32_t>* a, int count)
+{
+    ::syscall(SYS_futex, &a->m_value, FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0); // NOLINT(*-vararg)
+}
+
+#endif
+
+void asl::atomic_wait(atomic<uint32_t>* a, uint32_t expected)
+{
+#if defined(ASL_OS_WINDOWS)
+    WaitOnAddress(&a->m_value, &expected, sizeof(uint32_t), INFINITE);
+#elif defined(ASL_OS_LINUX)
+    ::syscall(SYS_futex, &a->m_value, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0); // NOLINT(*-vararg)
+#endif
+}
+
+void asl::atomic_notify_one(atomic<uint32_t>* a)
+{
+#if defined(ASL_OS_WINDOWS)
+    WakeByAddressSingle(&a->m_value);
+#elif defined(ASL_OS_LINUX)
+    futex_wake(a, 1);
+#endif
+}
+
+void asl::atomic_notify_all(atomic<uint32_t>* a)
+{
+#if defined(ASL_OS_WINDOWS)
+    WakeByAddressAll(&a->m_value);
+#elif defined(ASL_OS_LINUX)
+    futex_wake(a, INT_MAX);
+#endif
+}
+
+void asl::yield_thread()
+{
+#if defined(ASL_OS_WINDOWS)
+    SwitchToThread();
+#elif defined(ASL_OS_LINUX)
+    sched_yield();
+#endif
+}
@@ -0,0 +1,37 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "asl/base/config.hpp"
+#include "asl/base/integers.hpp"
+#include "asl/synchronization/atomic.hpp"
+
+namespace asl
+{
+
+// Blocks while the value of the atomic is the expected one. This may
+// return spuriously, so callers check their condition again after it.
+void atomic_wait(atomic<uint32_t>* a, uint32_t expected);
+
+void atomic_notify_one(atomic<uint32_t>* a);
+
+void atomic_notify_all(atomic<uint32_t>* a);
+
+// Tells the CPU that we're busy waiting for another thread, before
+// checking again.
+inline void cpu_pause()
+{
+#if defined(ASL_ARCH_X64)
+    __builtin_ia32_pause();
+#elif defined(ASL_ARCH_ARM64)
+    __builtin_arm_yield();
+#endif
+}
+
+// Lets the OS run another thread in place of this one, for when spinning
+// for longer would only delay the thread we're waiting for.
+void yield_thread();
+
+} // namespace asl
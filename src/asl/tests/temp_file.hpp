@@ -0,0 +1,109 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "asl/base/support.hpp"
+#include "asl/base/assert.hpp"
+#include "asl/base/integers.hpp"
+
+#if defined(ASL_OS_WINDOWS)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#elif defined(ASL_OS_LINUX)
+    #include <stdlib.h>
+    #include <unistd.h>
+#endif
+
+// Empty file in the temporary directory, open for reading and writing,
+// and removed on destruction.
+class TempFile
+{
+#if defined(ASL_OS_WINDOWS)
+    using Handle = HANDLE;
+    static constexpr Handle kClosed = INVALID_HANDLE_VALUE;
+
+    char m_path[MAX_PATH + 1]{};
+#elif defined(ASL_OS_LINUX)
+    using Handle = int;
+    static constexpr Handle kClosed = -1;
+
+    char m_path[32] = "/tmp/asl_test_XXXXXX";
+#endif
+
+    Handle m_handle;
+
+public:
+    TempFile()
+    {
+#if defined(ASL_OS_WINDOWS)
+        char dir[MAX_PATH + 1]{};
+        ASL_ASSERT_RELEASE(GetTempPathA(MAX_PATH + 1, dir) != 0);
+        ASL_ASSERT_RELEASE(GetTempFileNameA(dir, "asl", 0, m_path) != 0);
+        m_handle = CreateFileA(
+            m_path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+#elif defined(ASL_OS_LINUX)
+        m_handle = mkstemp(m_path);
+#endif
+        ASL_ASSERT_RELEASE(m_handle != kClosed);
+    }
+
+    ASL_DELETE_COPY_MOVE(TempFile);
+
+    ~TempFile()
+    {
+        close();
+#if defined(ASL_OS_WINDOWS)
+        DeleteFileA(m_path);
+#elif defined(ASL_OS_LINUX)
+        unlink(m_path);
+#endif
+    }
+
+    // HANDLE on Windows, file descriptor on Linux.
+    [[nodiscard]] Handle handle() const { return m_handle; }
+
+    [[nodiscard]] const char* path() const { return m_path; }
+
+    // Closes the handle early, for when the file must be opened again
+    // without sharing it.
+    void close()
+    {
+        if (m_handle == kClosed) { return; }
+#if defined(ASL_OS_WINDOWS)
+        CloseHandle(m_handle);
+#elif defined(ASL_OS_LINUX)
+        ::close(m_handle);
+#endif
+        m_handle = kClosed;
+    }
+
+    // Reads up to size bytes from the start of the file, and returns how
+    // many were read.
+    isize_t read(void* out, isize_t size) const
+    {
+        ASL_ASSERT(m_handle != kClosed);
+
+        isize_t total = 0;
+        while (total < size)
+        {
+            auto* dst = static_cast<char*>(out) + total; // NOLINT(*-pointer-arithmetic)
+#if defined(ASL_OS_WINDOWS)
+            OVERLAPPED offset{};
+            offset.Offset = static_cast<DWORD>(total);
+            DWORD n = 0;
+            if (ReadFile(m_handle, dst, static_cast<DWORD>(size - total), &n, &offset) == 0) { break; }
+#elif defined(ASL_OS_LINUX)
+            const ssize_t n = pread(m_handle, dst, static_cast<size_t>(size - total), total);
+            if (n < 0) { break; }
+#endif
+            if (n == 0) { break; }
+            total += static_cast<isize_t>(n);
+        }
+
+        return total;
+    }
+};
@@ -0,0 +1,84 @@
+// Copyright 2025 Steven Le Rouzic
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "asl/base/config.hpp"
+#include "asl/synchronization/atomic.hpp"
+
+#if defined(ASL_OS_WINDOWS)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#elif defined(ASL_OS_LINUX)
+    #include <pthread.h>
+#endif
+
+static constexpr int kThreadCount = 8;
+
+// Failing tests from several threads at once isn't supported, so threads
+// count their errors here instead, and the test checks the count once
+// they're done.
+struct ThreadErrors
+{
+    asl::atomic<int> errors;
+
+    void expect(bool condition)
+    {
+        if (!condition) { asl::atomic_fetch_increment(&errors); }
+    }
+
+    int count() { return asl::atomic_load(&errors); }
+};
+
+struct ThreadContext
+{
+    void (*fn)(int, void*);
+    void* user;
+    int   index;
+};
+
+#if defined(ASL_OS_WINDOWS)
+static DWORD WINAPI thread_entry(void* context)
+#elif defined(ASL_OS_LINUX)
+static void* thread_entry(void* context)
+#endif
+{
+    auto* c = static_cast<ThreadContext*>(context);
+    c->fn(c->index, c->user);
+    return {};
+}
+
+// Runs fn(thread index, user) on kThreadCount threads, and waits for them.
+static void run_threads(void (*fn)(int, void*), void* user)
+{
+    ThreadContext contexts[kThreadCount];
+
+    // NOLINTBEGIN(*-constant-array-index)
+#if defined(ASL_OS_WINDOWS)
+    HANDLE threads[kThreadCount];
+    for (int i = 0; i < kThreadCount; ++i)
+    {
+        contexts[i] = { .fn = fn, .user = user, .index = i };
+        threads[i] = CreateThread(nullptr, 0, thread_entry, &contexts[i], 0, nullptr);
+    }
+    WaitForMultipleObjects(kThreadCount, threads, TRUE, INFINITE);
+    for (HANDLE thread: threads)
+    {
+        CloseHandle(thread);
+    }
+#elif defined(ASL_OS_LINUX)
+    pthread_t threads[kThreadCount];
+    for (int i = 0; i < kThreadCount; ++i)
+    {
+        contexts[i] = { .fn = fn, .user = user, .index = i };
+        pthread_create(&threads[i], nullptr, thread_entry, &contexts[i]);
+    }
+    for (pthread_t thread: threads)
+    {
+        pthread_join(thread, nullptr);
+    }
+#endif
+    // NOLINTEND(*-constant-array-index)
+}
@@ -92,3 +92,36 @@ struct DestructorObserver
         }
     }
 };
+
+// Counts its moves, but opts in to trivial relocation, so containers
+// relocating it by copying its bytes don't count as moves.
+struct RelocatableType
+{
+    int  value;
+    int* moves;
+
+    RelocatableType(int value_, int* moves_) : value{value_}, moves{moves_} {}
+
+    RelocatableType(const RelocatableType&) = delete;
+    RelocatableType& operator=(const RelocatableType&) = delete;
+
+    RelocatableType(RelocatableType&& other)
+        : value{other.value}
+        , moves{other.moves}
+    {
+        *moves += 1;
+    }
+
+    RelocatableType& operator=(RelocatableType&& other)
+    {
+        value = other.value;
+        moves = other.moves;
+        *moves += 1;
+        return *this;
+    }
+
+    ~RelocatableType() = default;
+};
+
+template<>
+struct asl::trivially_relocatable<RelocatableType> : true_type {};
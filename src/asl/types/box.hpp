@@ -112,6 +112,10 @@ public:
     friend class box;
 };
 
+// The boxed value doesn't move with the box.
+template<is_object T, allocator Allocator>
+struct trivially_relocatable<box<T, Allocator>> : bool_constant<is_trivially_relocatable<Allocator>> {};
+
 template<is_object T, allocator Allocator = DefaultAllocator, typename... Args>
 constexpr box<T, Allocator> make_box_in(Allocator allocator, Args&&... args)
     requires constructible_from<T, Args&&...>
@@ -12,6 +12,7 @@ static_assert(sizeof(asl::box<int>) == sizeof(int*));
 static_assert(!asl::copyable<asl::box<int>>);
 static_assert(asl::movable<asl::box<int>>);
 static_assert(asl::has_niche<asl::box<int>>);
+static_assert(asl::is_trivially_relocatable<asl::box<DestructorObserver>>);
 static_assert(sizeof(asl::option<asl::box<int>>) == sizeof(int*));
 
 ASL_TEST(destructor)
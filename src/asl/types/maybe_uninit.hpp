@@ -54,6 +54,13 @@ public:
         m_value = std::forward<decltype(value)>(value);
     }
 
+    // @Safety Value must not have been initialized yet, and other's value
+    // must have been. Other's value is left uninitialized.
+    constexpr void relocate_unsafe(maybe_uninit& other)
+    {
+        relocate_uninit_n(&m_value, &other.m_value, 1);
+    }
+
     // @Safety Value must have been initialized
     constexpr void destroy_unsafe()
     {
@@ -39,7 +39,7 @@ asl::status::status(status_code code, string_view msg)
     : m_payload{alloc_new<StatusInternal>(g_allocator, msg, code)}
 {}
 
-asl::status::status(status_code code, string_view fmt, span<format_internals::type_erased_arg> args)
+asl::status::status(status_code code, const format_internals::parsed_format& fmt, span<const format_internals::type_erased_arg> args)
 {
     StringWriter<Allocator> sink{g_allocator};
     format_internals::format(&sink, fmt, args);
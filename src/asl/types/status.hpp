@@ -73,7 +73,7 @@ public:
     {}
 
     status(status_code code, string_view msg);
-    status(status_code code, string_view fmt, span<format_internals::type_erased_arg> args);
+    status(status_code code, const format_internals::parsed_format& fmt, span<const format_internals::type_erased_arg> args);
 
     constexpr status(const status& other)
         : m_payload{other.m_payload}
@@ -146,12 +146,13 @@ static constexpr status ok() { return status{status_code::ok}; }
     static constexpr status type##_error() { return status{status_code::type}; }                \
     static inline status type##_error(string_view sv) { return status{status_code::type, sv}; } \
     template<formattable... Args>                                                               \
-    [[maybe_unused]] static status type##_error(string_view fmt, const Args&... args)           \
+    [[maybe_unused]] static status type##_error(                                                \
+        format_string<type_identity_t<Args>...> fmt, const Args&... args)                       \
     {                                                                                           \
-        format_internals::type_erased_arg type_erased_args[] = {                                \
+        const format_internals::type_erased_arg type_erased_args[] = {                          \
             format_internals::type_erased_arg(args)...                                          \
         };                                                                                      \
-        return status{status_code::type, fmt, type_erased_args};                                \
+        return status{status_code::type, fmt.parsed(), type_erased_args};                       \
     }
 
 ASL_DEFINE_ERROR_(unknown)